@@ -6,8 +6,20 @@
 #include <stdbool.h>
 #include <assert.h>
 #include <stdio.h>
-#include <time.h>
-#include <sys/time.h>
+#ifndef BIGINT_NO_THREADS
+#include <pthread.h>
+#endif
+
+/*
+The algorithm cutoffs below are variables with compiled-in defaults. Running
+bigint_bench tune measures them on the host and writes bigint_thresholds.h,
+which replaces the defaults whenever it sits next to this file at build time.
+*/
+#if defined(__has_include)
+#if __has_include("bigint_thresholds.h")
+#include "bigint_thresholds.h"
+#endif
+#endif
 void big_init(bigint *X) {
     if (X!=NULL) {
         *X = BIG_ZERO;
@@ -15,35 +27,71 @@ void big_init(bigint *X) {
 }
 
 void big_free(bigint *X) {
-    X->signum = 0;
-    X->num_limbs = 0;
-    if (X != NULL && X->data != NULL) {
-        free(X->data); 
-        X->data = NULL; 
+    if (X != NULL) {
+        free(X->data);
+        *X = BIG_ZERO;
+    }
+}
+
+/*
+Makes room for at least limbs limbs in X, keeping its current value. Growing
+is the only time the arithmetic touches the heap, so a bigint that is reused
+in a loop stops allocating once it is large enough.
+*/
+int big_reserve(bigint *X, size_t limbs) {
+    if (X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (limbs <= X->alloc) {
+        return 0;
+    }
+    if (limbs < X->num_limbs) {
+        limbs = X->num_limbs;
+    }
+    big_uint *new_data = (big_uint *) realloc(X->data, limbs * sizeof(big_uint));
+    if (new_data == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    X->data = new_data;
+    X->alloc = limbs;
+    return 0;
+}
+
+int big_shrink_to_fit(bigint *X) {
+    if (X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t limbs = (X->num_limbs > 0) ? X->num_limbs : 1;
+    if (X->data == NULL || X->alloc <= limbs) {
+        return 0;
+    }
+    big_uint *new_data = (big_uint *) realloc(X->data, limbs * sizeof(big_uint));
+    if (new_data == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
     }
+    X->data = new_data;
+    X->alloc = limbs;
+    return 0;
 }
 
 int big_copy(bigint *X, const bigint *Y) {
     if (Y == NULL || X == NULL) {
         return ERR_BIGINT_BAD_INPUT_DATA;
     }
-    if (Y->data == NULL) {
-        free(X->data);
-        X->data = NULL;
+    if (X == Y) {
+        return 0;
     }
-    else if (X->num_limbs < Y->num_limbs || X->data == NULL) {
-        big_uint *new_data = (big_uint *) realloc(X->data, Y->num_limbs * sizeof(big_uint));
-        if (new_data == NULL) {
-            return ERR_BIGINT_ALLOC_FAILED;  
+    if (Y->data != NULL) {
+        int ret = big_reserve(X, Y->num_limbs);
+        if (ret != 0) {
+            return ret;
         }
-        X->data = new_data;
+        memcpy(X->data, Y->data, Y->num_limbs * sizeof(big_uint));
+        X->num_limbs = Y->num_limbs;
     }
-    if (Y->data!=NULL) {
-        for (size_t i = 0; i < Y->num_limbs; i++) {
-            X->data[i] = Y->data[i];
-        }
+    else {
+        X->num_limbs = 0;
     }
-    X->num_limbs = Y->num_limbs;
     X->signum = Y->signum;
 
     return 0; 
@@ -86,11 +134,10 @@ int big_set_nonzero(bigint *X, big_uint limb) {
     if (X == NULL) {
         return ERR_BIGINT_BAD_INPUT_DATA;
     }
-    big_uint *new_data = (big_uint *) realloc(X->data, sizeof(big_uint));
-    if (new_data == NULL) {
-        return ERR_BIGINT_ALLOC_FAILED;  
+    int ret = big_reserve(X, 1);
+    if (ret != 0) {
+        return ret;
     }
-    X->data = new_data;
     X->data[0] = limb;
     X->signum = 1;
     X->num_limbs = 1;
@@ -107,1059 +154,7335 @@ bool big_is_zero(const bigint *num) {
     return true;
 }
 
-int big_read_string(bigint *X, const char *s) {
-    if (s == NULL || X == NULL) {
-        return ERR_BIGINT_BAD_INPUT_DATA;
-    }
-    X->signum = 1;
-    int len, pad;
-    int offest = 0;
-    len = strlen(s);
-    if (s[0] == '-') {
-        X->signum = -1;
-        len -= 1;
-        offest = 1;
-    }
-    pad = (16 - (len % 16)) % 16;
-    char actual[len+pad+1];
-    memset(actual, '0', pad);
-    strcpy(actual + pad, s+offest);
-    int limbs = (len+pad) / 16;
-    big_uint *value = (big_uint *) malloc(limbs * sizeof(big_uint));
-    if (value == NULL) {
-        return ERR_BIGINT_ALLOC_FAILED;
+/*
+Returns the number of limbs of p (of length n) up to and including the most
+significant nonzero limb. A zero value has length 0.
+*/
+size_t limb_trimmed_len(const big_uint *p, size_t n) {
+    while (n > 0 && p[n - 1] == 0) {
+        n--;
     }
+    return n;
+}
 
-    for(int i = 0; i < limbs; i++) {
-        char cur_section[17];
-        strncpy(cur_section, actual + i*16, 16);
-        cur_section[16] = '\0';
-        
-        value[limbs-i-1] = (big_uint) strtoull(cur_section, NULL, 16);
+/*
+Sets X to the n limbs already written to its buffer with the given sign,
+dropping leading zero limbs. Zero is stored as a single 0 limb with a
+positive sign, like big_add leaves it. X must have room for one limb.
+*/
+void big_normalize(bigint *X, size_t n, int signum) {
+    n = limb_trimmed_len(X->data, n);
+    if (n == 0) {
+        X->data[0] = 0;
+        n = 1;
+        signum = 1;
     }
+    X->num_limbs = n;
+    X->signum = signum;
+}
 
-    
-    X->num_limbs = limbs;
-    if (X->data != NULL) {
+/*
+Hands ownership of the malloc'd limb buffer data (n limbs long) over to X,
+freeing whatever X held before and dropping leading zero limbs.
+*/
+void big_adopt_limbs(bigint *X, big_uint *data, size_t n, int signum) {
+    if (X->data != data) {
         free(X->data);
     }
-    X->data = value;
-    return 0;
+    X->data = data;
+    X->alloc = (n > 0) ? n : 1;
+    big_normalize(X, n, signum);
 }
-void print_bigint(const bigint *X) {
-    printf("BigInt Limbs (%lu):\n", X->num_limbs);
-    printf("Pos or Negative: %d\n", X->signum);
-    for (size_t i = 0; i < X->num_limbs; i++) {
-        printf("Limb %lu: %lu\n", i, X->data[i]);
+
+/*
+Returns the buffer a product of A and B with n limbs should be written to:
+X's own if it is not one of the operands, grown if needed, and otherwise a
+fresh one. big_finish_result then stores the result in X either way.
+*/
+big_uint *big_result_buffer(bigint *X, const bigint *A, const bigint *B, size_t n) {
+    if (X != A && X != B) {
+        return (big_reserve(X, n) == 0) ? X->data : NULL;
     }
+    return (big_uint *)malloc(n * sizeof(big_uint));
 }
 
-int big_write_string(const bigint *X,
-                     char *buf, size_t buflen, size_t *olen) {
-    if (X == NULL || buf == NULL || olen == NULL) {
-        return ERR_BIGINT_BAD_INPUT_DATA;  
-    }
-    if (X->num_limbs == 0) {
-        *olen = 0;
-        return 0;
-    }
-    size_t required_length = 0;  
-    bool leading = true;         
-    for (size_t i = X->num_limbs; i > 0; i--) {
-        unsigned long long cur_limb = X->data[i - 1];
-        //printf("What is value trying to convert: %lld\n", cur_limb);
-        for (int j = 15; j >= 0; j--) {
-            int digit = (cur_limb >> (4 * j)) & 0xF;
-            if (digit != 0 || !leading) {
-                leading = false;
-                required_length += 1;
-            }
-        }
+void big_finish_result(bigint *X, big_uint *rp, size_t n, int signum) {
+    if (rp == X->data) {
+        big_normalize(X, n, signum);
     }
-    if (leading) {  
-        required_length = 1;
-    }
-    if (X->signum < 0 && !big_is_zero(X)) {
-        required_length +=1;
+    else {
+        big_adopt_limbs(X, rp, n, signum);
     }
-    *olen = required_length + 1;  
+}
 
-    if (buflen < *olen) {
-        return ERR_BIGINT_BUFFER_TOO_SMALL;
-    }
+/*
+On x86-64 the hot loops below hand whole blocks of 4 limbs to the assembly
+kernels, and their portable C loops only finish the last n % 4 limbs. add_n
+and sub_n need nothing beyond adc and sbb. mul_1 and addmul_1 need MULX
+(BMI2), which leaves the flags alone, and addmul_1 also ADCX/ADOX (ADX), so
+that it can run two independent carry chains, one for the high halves of the
+products and one for the limbs of rp. Whether the CPU has them is checked
+once at load time, before main and before any pool thread exists, so the
+multiply paths only ever read the answer. Defining BIGINT_NO_ASM keeps the
+portable loops only.
+*/
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(BIGINT_NO_ASM)
+#define BIGINT_X86_ASM 1
+#endif
 
-    size_t index = 0; 
-    if (X->signum < 0 && !big_is_zero(X)) {
-        buf[index++] = '-';
-    }   
-    leading = true;   
-
-    for (size_t i = X->num_limbs; i > 0; i--) {
-        big_uint cur_limb = X->data[i - 1];
-        for (int j = 15; j >= 0; j--) {
-            int digit = (cur_limb >> (4 * j)) & 0xF;
-            if (digit != 0 || !leading) {
-                if (digit < 10) {
-                    buf[index++] = '0' + digit;
-                } else {
-                    buf[index++] = 'a' + (digit - 10);
-                }
-                leading = false;
-            }
-        }
-    }
-    if (leading) { 
-        buf[index++] = '0';
-    }
-    buf[index] = '\0';  
-    return 0;  
-}
+#ifdef BIGINT_X86_ASM
+static bool mulx_adx_supported;
 
-int cmp_abs(const bigint *x, const bigint *y) {
-    if (x->num_limbs != y->num_limbs) {
-        return (x->num_limbs > y->num_limbs) ? 1 : -1;
-    }
+__attribute__((constructor)) void limb_detect_mulx_adx(void) {
+    __builtin_cpu_init();
+    mulx_adx_supported = __builtin_cpu_supports("bmi2") && __builtin_cpu_supports("adx");
+}
 
-    for (size_t i = x->num_limbs; i-- > 0; ) {
-        if (x->data[i] != y->data[i]) {
-            int result = (x->data[i] > y->data[i]) ? 1 : -1;
-            return result;
-        }
-    }
-    return 0;
+bool limb_has_mulx_adx(void) {
+    return mulx_adx_supported;
 }
 
-int big_sub_helper(bigint *result, const bigint *A, const bigint *B) {
-    size_t result_limbs = A->num_limbs;
-    big_init(result);
-    result->num_limbs = result_limbs;
-    result->data = (big_uint *)malloc(result_limbs * sizeof(big_uint));
-    if (result->data == NULL) {
-        return ERR_BIGINT_ALLOC_FAILED;
-    }
+big_uint limb_add_n_x86(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t blocks) {
+    big_uint t0, t1, t2, t3;
+    __asm__ volatile(
+        "xorl %k[t0], %k[t0]\n\t"
+        "1:\n\t"
+        "movq (%[ap]), %[t0]\n\t"
+        "movq 8(%[ap]), %[t1]\n\t"
+        "movq 16(%[ap]), %[t2]\n\t"
+        "movq 24(%[ap]), %[t3]\n\t"
+        "adcq (%[bp]), %[t0]\n\t"
+        "adcq 8(%[bp]), %[t1]\n\t"
+        "adcq 16(%[bp]), %[t2]\n\t"
+        "adcq 24(%[bp]), %[t3]\n\t"
+        "movq %[t0], (%[rp])\n\t"
+        "movq %[t1], 8(%[rp])\n\t"
+        "movq %[t2], 16(%[rp])\n\t"
+        "movq %[t3], 24(%[rp])\n\t"
+        "leaq 32(%[ap]), %[ap]\n\t"
+        "leaq 32(%[bp]), %[bp]\n\t"
+        "leaq 32(%[rp]), %[rp]\n\t"
+        "decq %[n]\n\t"
+        "jnz 1b\n\t"
+        "movl $0, %k[t0]\n\t"
+        "adcq %[t0], %[t0]\n\t"
+        : [rp] "+r"(rp), [ap] "+r"(ap), [bp] "+r"(bp), [n] "+r"(blocks),
+          [t0] "=&r"(t0), [t1] "=&r"(t1), [t2] "=&r"(t2), [t3] "=&r"(t3)
+        :
+        : "cc", "memory");
+    return t0;
+}
 
-    big_uint borrow = 0;
+big_uint limb_sub_n_x86(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t blocks) {
+    big_uint t0, t1, t2, t3;
+    __asm__ volatile(
+        "xorl %k[t0], %k[t0]\n\t"
+        "1:\n\t"
+        "movq (%[ap]), %[t0]\n\t"
+        "movq 8(%[ap]), %[t1]\n\t"
+        "movq 16(%[ap]), %[t2]\n\t"
+        "movq 24(%[ap]), %[t3]\n\t"
+        "sbbq (%[bp]), %[t0]\n\t"
+        "sbbq 8(%[bp]), %[t1]\n\t"
+        "sbbq 16(%[bp]), %[t2]\n\t"
+        "sbbq 24(%[bp]), %[t3]\n\t"
+        "movq %[t0], (%[rp])\n\t"
+        "movq %[t1], 8(%[rp])\n\t"
+        "movq %[t2], 16(%[rp])\n\t"
+        "movq %[t3], 24(%[rp])\n\t"
+        "leaq 32(%[ap]), %[ap]\n\t"
+        "leaq 32(%[bp]), %[bp]\n\t"
+        "leaq 32(%[rp]), %[rp]\n\t"
+        "decq %[n]\n\t"
+        "jnz 1b\n\t"
+        "movl $0, %k[t0]\n\t"
+        "adcq %[t0], %[t0]\n\t"
+        : [rp] "+r"(rp), [ap] "+r"(ap), [bp] "+r"(bp), [n] "+r"(blocks),
+          [t0] "=&r"(t0), [t1] "=&r"(t1), [t2] "=&r"(t2), [t3] "=&r"(t3)
+        :
+        : "cc", "memory");
+    return t0;
+}
 
-    for (size_t i = 0; i < result_limbs; i++) {
-        big_uint a_limb = (i < A->num_limbs) ? A->data[i] : 0;
-        big_uint b_limb = (i < B->num_limbs) ? B->data[i] : 0;
+// The low halves pick up the previous high half through a single CF chain
+big_uint limb_mul_1_mulx(big_uint *rp, const big_uint *ap, size_t blocks, big_uint b) {
+    big_uint l0, h0, l1, h1, carry;
+    __asm__ volatile(
+        "xorl %k[c], %k[c]\n\t"
+        "1:\n\t"
+        "mulx (%[ap]), %[l0], %[h0]\n\t"
+        "mulx 8(%[ap]), %[l1], %[h1]\n\t"
+        "adcx %[c], %[l0]\n\t"
+        "adcx %[h0], %[l1]\n\t"
+        "movq %[l0], (%[rp])\n\t"
+        "movq %[l1], 8(%[rp])\n\t"
+        "mulx 16(%[ap]), %[l0], %[h0]\n\t"
+        "mulx 24(%[ap]), %[l1], %[c]\n\t"
+        "adcx %[h1], %[l0]\n\t"
+        "adcx %[h0], %[l1]\n\t"
+        "movq %[l0], 16(%[rp])\n\t"
+        "movq %[l1], 24(%[rp])\n\t"
+        "leaq 32(%[ap]), %[ap]\n\t"
+        "leaq 32(%[rp]), %[rp]\n\t"
+        "decq %[n]\n\t"
+        "jnz 1b\n\t"
+        "movl $0, %k[l0]\n\t"
+        "adcx %[l0], %[c]\n\t"
+        : [rp] "+r"(rp), [ap] "+r"(ap), [n] "+r"(blocks), [c] "=&r"(carry),
+          [l0] "=&r"(l0), [h0] "=&r"(h0), [l1] "=&r"(l1), [h1] "=&r"(h1)
+        : "d"(b)
+        : "cc", "memory");
+    return carry;
+}
 
-        if (borrow) {
-            if (a_limb == 0) {
-                a_limb = UINT64_MAX;
-                borrow = 1;
-            } else {
-                a_limb--;
-                borrow = 0;
-            }
-        }
+/*
+CF carries between the low half of each product and the high half of the
+previous one, OF between that sum and the limb of rp. The loop counter sits
+in rcx and is tested with jrcxz, since dec would clobber OF.
+*/
+big_uint limb_addmul_1_adx(big_uint *rp, const big_uint *ap, size_t blocks, big_uint b) {
+    big_uint l0, h0, l1, h1, carry;
+    __asm__ volatile(
+        "xorl %k[c], %k[c]\n\t"
+        "1:\n\t"
+        "mulx (%[ap]), %[l0], %[h0]\n\t"
+        "adcx %[c], %[l0]\n\t"
+        "adox (%[rp]), %[l0]\n\t"
+        "movq %[l0], (%[rp])\n\t"
+        "mulx 8(%[ap]), %[l1], %[h1]\n\t"
+        "adcx %[h0], %[l1]\n\t"
+        "adox 8(%[rp]), %[l1]\n\t"
+        "movq %[l1], 8(%[rp])\n\t"
+        "mulx 16(%[ap]), %[l0], %[h0]\n\t"
+        "adcx %[h1], %[l0]\n\t"
+        "adox 16(%[rp]), %[l0]\n\t"
+        "movq %[l0], 16(%[rp])\n\t"
+        "mulx 24(%[ap]), %[l1], %[c]\n\t"
+        "adcx %[h0], %[l1]\n\t"
+        "adox 24(%[rp]), %[l1]\n\t"
+        "movq %[l1], 24(%[rp])\n\t"
+        "leaq 32(%[ap]), %[ap]\n\t"
+        "leaq 32(%[rp]), %[rp]\n\t"
+        "leaq -1(%[n]), %[n]\n\t"
+        "jrcxz 2f\n\t"
+        "jmp 1b\n\t"
+        "2:\n\t"
+        "movl $0, %k[l0]\n\t"
+        "adcx %[l0], %[c]\n\t"
+        "adox %[l0], %[c]\n\t"
+        : [rp] "+r"(rp), [ap] "+r"(ap), [n] "+c"(blocks), [c] "=&r"(carry),
+          [l0] "=&r"(l0), [h0] "=&r"(h0), [l1] "=&r"(l1), [h1] "=&r"(h1)
+        : "d"(b)
+        : "cc", "memory");
+    return carry;
+}
+#endif
 
-        big_uint diff;
-        if (a_limb < b_limb) {
-            diff = (UINT64_MAX - b_limb) + a_limb + 1;
-            borrow = 1;
-        } else {
-            diff = a_limb - b_limb;
+/*
+The functions below work directly on little-endian limb arrays rather than
+on bigints, so the multiplication and division code can run in place inside
+preallocated buffers. Each one returns the carry (or borrow) out of the top
+limb, and rp may alias ap or bp.
+*/
+int limb_cmp(const big_uint *ap, const big_uint *bp, size_t n) {
+    while (n-- > 0) {
+        if (ap[n] != bp[n]) {
+            return (ap[n] > bp[n]) ? 1 : -1;
         }
-
-        result->data[i] = diff;
     }
+    return 0;
+}
 
-    int needed = 1;
-    for(size_t i=result->num_limbs-1; i >= 0; i--) {
-        if (result->data[i] != 0) {
-            needed = i+1;
-            break;
-        }
-        if (i==0) {
-            break;
-        }
+big_uint limb_add_n(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    big_uint carry = 0;
+    size_t i = 0;
+#ifdef BIGINT_X86_ASM
+    if (n >= 4) {
+        i = n & ~(size_t)3;
+        carry = limb_add_n_x86(rp, ap, bp, i / 4);
     }
-    if (needed != result->num_limbs) {
-        big_uint *temp = realloc(result->data, sizeof(big_uint) * needed);
-        if (temp == NULL) {
-            return ERR_BIGINT_ALLOC_FAILED;
-        }
-        result->data = temp;
-        result->num_limbs = needed;
+#endif
+    for (; i < n; i++) {
+        big_udbl sum = (big_udbl)ap[i] + bp[i] + carry;
+        rp[i] = (big_uint)sum;
+        carry = (big_uint)(sum >> 64);
     }
-
-    return 0;
+    return carry;
 }
 
-int big_add_helper(bigint *X, const bigint *A, const bigint *B) {
-    size_t num_limbs = (A->num_limbs > B->num_limbs) ? A->num_limbs : B->num_limbs;
-    size_t old_limbs = A->num_limbs;
-    if (X->num_limbs < num_limbs) {
-        big_uint *new_data = realloc(X->data, num_limbs * sizeof(big_uint));
-        if (new_data == NULL) {
-            return ERR_BIGINT_ALLOC_FAILED;
-        }
-        X->data = new_data;
-        X->num_limbs = num_limbs;
+big_uint limb_sub_n(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    big_uint borrow = 0;
+    size_t i = 0;
+#ifdef BIGINT_X86_ASM
+    if (n >= 4) {
+        i = n & ~(size_t)3;
+        borrow = limb_sub_n_x86(rp, ap, bp, i / 4);
     }
-
-    big_uint carry = 0; 
-    for (size_t i = 0; i < num_limbs; i++) {
-        big_uint a = (i < old_limbs) ? A->data[i] : 0;
-        big_uint b = (i < B->num_limbs) ? B->data[i] : 0;
-        big_udbl sum = (big_udbl)a + b + carry;
-        X->data[i] = (big_uint)sum;
-        carry = (big_uint)(sum >> (sizeof(big_uint) * 8));
+#endif
+    for (; i < n; i++) {
+        big_uint a = ap[i];
+        big_uint b = bp[i];
+        rp[i] = a - b - borrow;
+        borrow = (a < b) | ((a - b) < borrow);
     }
+    return borrow;
+}
 
-    if (carry > 0) {
-        big_uint *new_data = realloc(X->data, (num_limbs + 1) * sizeof(big_uint));
-        if (new_data == NULL) {
-            return ERR_BIGINT_ALLOC_FAILED;
-        }
-        X->data = new_data;
-        X->data[num_limbs] = carry;
-        X->num_limbs = num_limbs + 1;
+// Stops propagating as soon as the carry dies out, which makes adding into
+// the middle of a long in-place product cheap
+big_uint limb_add_1(big_uint *rp, const big_uint *ap, size_t n, big_uint b) {
+    size_t i = 0;
+    for (; i < n && b != 0; i++) {
+        big_uint sum = ap[i] + b;
+        b = sum < b;
+        rp[i] = sum;
+    }
+    // ap may be NULL for an empty operand, so nothing left means no copy
+    if (rp != ap && i < n) {
+        memmove(rp + i, ap + i, (n - i) * sizeof(big_uint));
     }
+    return b;
+}
 
-    int needed = 1;
-    for(size_t i=X->num_limbs-1; i >= 0; i--) {
-        if (X->data[i] != 0) {
-            needed = i+1;
-            break;
-        }
-        if (i==0) {
-            break;
-        }
+big_uint limb_sub_1(big_uint *rp, const big_uint *ap, size_t n, big_uint b) {
+    size_t i = 0;
+    for (; i < n && b != 0; i++) {
+        big_uint a = ap[i];
+        rp[i] = a - b;
+        b = a < b;
     }
-    if (needed != X->num_limbs) {
-        big_uint *temp = realloc(X->data, sizeof(big_uint) * needed);
-        if (temp == NULL) {
-            return ERR_BIGINT_ALLOC_FAILED;
-        }
-        X->data = temp;
-        X->num_limbs = needed;
+    if (rp != ap && i < n) {
+        memmove(rp + i, ap + i, (n - i) * sizeof(big_uint));
     }
+    return b;
+}
 
-    return 0;
+// {rp, an} = {ap, an} + {bp, bn} for an >= bn
+big_uint limb_add(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn) {
+    big_uint carry = limb_add_n(rp, ap, bp, bn);
+    return limb_add_1(rp + bn, ap + bn, an - bn, carry);
 }
 
-int big_add(bigint *X, const bigint *A, const bigint *B) {
-    if (X == NULL || A == NULL || B == NULL) {
-        return ERR_BIGINT_BAD_INPUT_DATA;
-    }
-    int sign = 1;
-    int bigger = 1;
-    if (cmp_abs(A, B) <= 0) {
-        bigger = 0;
-    }
-    if (cmp_abs(A, B) <= 0 && B->signum == -1) {
-       sign = -1; 
-    } else if (cmp_abs(B, A) <= 0 && A->signum == -1 ) {
-       sign = -1;
-    }
+// {rp, an} = {ap, an} - {bp, bn} for an >= bn
+big_uint limb_sub(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn) {
+    big_uint borrow = limb_sub_n(rp, ap, bp, bn);
+    return limb_sub_1(rp + bn, ap + bn, an - bn, borrow);
+}
 
-    if (B->signum != A->signum) {
-        bigint result;
-        if (bigger) 
-            big_sub_helper(&result, A, B);
-        else 
-            big_sub_helper(&result, B, A);
-        big_copy(X, &result);
-        X->signum = sign;
-        big_free(&result);
-    }
-    else {
-        // printf("Big_add_helper getting called with A having %zu limbs\n", A->num_limbs);
-        big_add_helper(X, A, B);
-        X->signum = sign;
+// Two's complement negation modulo 2^(64n)
+void limb_neg(big_uint *rp, const big_uint *ap, size_t n) {
+    for (size_t i = 0; i < n; i++) {
+        rp[i] = ~ap[i];
     }
-    if (big_is_zero(X)) {
-        X->signum = 1;
+    limb_add_1(rp, rp, n, 1);
+}
+
+/*
+Writes |{ap, an} - {bp, bn}| to {rp, an} for an >= bn, returning 1 if the
+difference was negative and 0 otherwise.
+*/
+int limb_abs_diff(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn) {
+    if (limb_trimmed_len(ap + bn, an - bn) == 0 && limb_cmp(ap, bp, bn) < 0) {
+        limb_sub_n(rp, bp, ap, bn);
+        memset(rp + bn, 0, (an - bn) * sizeof(big_uint));
+        return 1;
     }
+    limb_sub(rp, ap, an, bp, bn);
     return 0;
 }
-int big_cmp(const bigint *x, const bigint *y) {
-    if (x->signum != y->signum) {
-        if (x->signum > 0) {
-            return 1;
-        }
-        if (y->signum > 0) {
-            return -1;
-        }
-    }
 
-    if (x->num_limbs != y->num_limbs) {
-        if (x->signum > 0) {
-            return (x->num_limbs > y->num_limbs) ? 1 : -1;
-        }
-        else {
-            return (x->num_limbs > y->num_limbs) ? -1 : 1;
-        }
+// rp = ap * b over n limbs, returns the limb carried out of the top
+big_uint limb_mul_1(big_uint *rp, const big_uint *ap, size_t n, big_uint b) {
+    big_uint carry = 0;
+    size_t i = 0;
+#ifdef BIGINT_X86_ASM
+    if (n >= 4 && limb_has_mulx_adx()) {
+        i = n & ~(size_t)3;
+        carry = limb_mul_1_mulx(rp, ap, i / 4, b);
     }
-
-    for (size_t i = x->num_limbs; i-- > 0; ) {
-        if (x->data[i] != y->data[i]) {
-            int result = (x->data[i] > y->data[i]) ? 1 : -1;
-            return (x->signum > 0) ? result : -result;
-        }
+#endif
+    for (; i < n; i++) {
+        big_udbl product = (big_udbl)ap[i] * b + carry;
+        rp[i] = (big_uint)product;
+        carry = (big_uint)(product >> 64);
     }
-    return 0;
+    return carry;
 }
 
-int limb_result(const bigint *A, const bigint *B) {
-    return A->num_limbs >= B->num_limbs;
+// rp += ap * b over n limbs, returns the limb carried out of the top
+big_uint limb_addmul_1(big_uint *rp, const big_uint *ap, size_t n, big_uint b) {
+    big_uint carry = 0;
+    size_t i = 0;
+#ifdef BIGINT_X86_ASM
+    if (n >= 4 && limb_has_mulx_adx()) {
+        i = n & ~(size_t)3;
+        carry = limb_addmul_1_adx(rp, ap, i / 4, b);
+    }
+#endif
+    for (; i < n; i++) {
+        big_udbl product = (big_udbl)ap[i] * b + rp[i] + carry;
+        rp[i] = (big_uint)product;
+        carry = (big_uint)(product >> 64);
+    }
+    return carry;
 }
 
+// FIXED WIDTH KERNELS STARTS HERE
 
-int big_sub(bigint *X, const bigint *A, const bigint *B) {
-    bool subtract = (A->signum == B->signum);
-    int sign = 1;
-    if (A->signum < B->signum) {
-        sign = -1; 
-    } else if (A->signum == B->signum) {
-        if (big_cmp(A, B) < 0) {
-            sign = -1;
-        }
-    }
-    const bigint *abs_bigger = A;
-    const bigint *abs_smaller = B;
-    int cmp = cmp_abs(A, B);
-    if (cmp < 0) {
-        abs_bigger = B;
-        abs_smaller = A;
-    }
-    bigint result;
-    if (subtract) {
-        big_sub_helper(&result, abs_bigger, abs_smaller);
-        result.signum = sign;
-        //print_bigint(&result);
-    } else {
-        X->signum = sign;
-        return big_add_helper(X, A, B);
-    }
+/*
+Kernels for the operand widths cryptography keeps coming back to: 4, 8, 16,
+32 and 64 limbs, 256 to 4096 bits. Each *_fixed_body function below is
+always inlined into a switch over those widths, so every case is compiled
+with n a constant, its loops unrolled as far as the compiler finds
+worthwhile (completely at the small widths) and the carries kept in
+registers. The generic paths hand over to them whenever a balanced
+operation has one of these widths, and big_fixed_* call them directly.
+*/
+void limb_mul_basecase(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn);
+void limb_sqr_basecase(big_uint *rp, const big_uint *ap, size_t n);
 
-    big_copy(X, &result);
-    big_free(&result);
-    return 0;
+bool limb_is_fixed_width(size_t n) {
+    return n == 4 || n == 8 || n == 16 || n == 32 || n == 64;
 }
 
-int big_mul(bigint *X, const bigint *A, const bigint *B) {
-    bigint result;
-    big_init(&result);
-    size_t max_limbs = A->num_limbs + B->num_limbs;
-    big_uint *result_final = (big_uint *)malloc(max_limbs * sizeof(big_uint));
-    if (result_final == NULL) {
-        big_free(&result);
-        return ERR_BIGINT_ALLOC_FAILED;
+static inline __attribute__((always_inline)) big_uint limb_add_fixed_body(big_uint *rp, const big_uint *ap,
+                                                                          const big_uint *bp, size_t n) {
+    big_uint carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        big_udbl sum = (big_udbl)ap[i] + bp[i] + carry;
+        rp[i] = (big_uint)sum;
+        carry = (big_uint)(sum >> 64);
     }
-    for(size_t j = 0; j < max_limbs; j++) {
-        result_final[j] = (big_uint) 0;
+    return carry;
+}
+
+static inline __attribute__((always_inline)) big_uint limb_sub_fixed_body(big_uint *rp, const big_uint *ap,
+                                                                          const big_uint *bp, size_t n) {
+    big_uint borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        big_udbl diff = (big_udbl)ap[i] - bp[i] - borrow;
+        rp[i] = (big_uint)diff;
+        borrow = (big_uint)(diff >> 64) & 1;
     }
+    return borrow;
+}
 
-    for (size_t i = 0; i < A->num_limbs; i++) {
-        big_uint carry = 0;
-        for (size_t j = 0; j < B->num_limbs; j++) {
-            big_udbl product = (big_udbl)A->data[i] * (big_udbl)B->data[j] + (big_udbl)result_final[i + j] + (big_udbl)carry;
-            result_final[i + j] = (big_uint)product;
-            carry = (big_uint)(product >> (sizeof(big_uint) * 8));
+/*
+Schoolbook, one row of partial products per limb of bp. The widths are
+multiples of 4, so from 8 limbs up the rows go straight to the MULX/ADX
+kernels with no tail to finish. At 4 limbs the unrolled C loop is faster
+than even those.
+*/
+static inline __attribute__((always_inline)) void limb_mul_fixed_body(big_uint *rp, const big_uint *ap,
+                                                                      const big_uint *bp, size_t n) {
+#ifdef BIGINT_X86_ASM
+    if (n >= 8 && limb_has_mulx_adx()) {
+        rp[n] = limb_mul_1_mulx(rp, ap, n / 4, bp[0]);
+        for (size_t j = 1; j < n; j++) {
+            rp[n + j] = limb_addmul_1_adx(rp + j, ap, n / 4, bp[j]);
         }
-        result_final[i + B->num_limbs] += carry;
+        return;
     }
-    int needed = 1;
-    for(size_t i=max_limbs-1; i >= 0; i--) {
-        if (result_final[i] != 0) {
-            needed = i+1;
-            break;
-        }
-        if (i==0) {
-            break;
-        }
+#endif
+    for (size_t i = 0; i < n; i++) {
+        rp[i] = 0;
     }
-    if (needed != max_limbs) {
-        big_uint *temp = realloc(result_final, sizeof(big_uint) * needed);
-        if (temp == NULL) {
-            return ERR_BIGINT_ALLOC_FAILED;
+    for (size_t j = 0; j < n; j++) {
+        big_uint carry = 0;
+        for (size_t i = 0; i < n; i++) {
+            big_udbl p = (big_udbl)ap[i] * bp[j] + rp[i + j] + carry;
+            rp[i + j] = (big_uint)p;
+            carry = (big_uint)(p >> 64);
         }
-        result_final = temp;
-        result.num_limbs = needed;
-    }
-    else {
-    result.num_limbs = max_limbs;
+        rp[n + j] = carry;
     }
-    result.data = result_final;
-    result.signum = A->signum * B->signum;
-    big_copy(X, &result);
-    big_free(&result);
-    return 0;
 }
 
-// EXTENSION STARTS HERE
-
 /*
-This function was called for Karatsuba, and splits the A into parts A0 and 
-A1, each with m limbs. This means that if A is odd, it'll pad A1 (the "higher" half)
-with 0s where necessary, as Karatsuba requires same size. 
+The cross products once, then doubling and the squares on the diagonal in
+a single pass, where limb_sqr_basecase takes one for each. At 8 limbs the
+rows of the triangle are too short for the MULX/ADX kernels, and the full
+product on them is faster.
 */
-int split_bigint(const bigint *A, size_t m, bigint *A0, bigint *A1) {
-    if (m >= A->num_limbs) {
-        A1->num_limbs = 1;
-        A1->signum = A->signum;
-        A1->data = malloc(1 * sizeof(big_uint));
-        A1->data[0] = 0;
-        big_copy(A0, A);
-        return 0;
+static inline __attribute__((always_inline)) void limb_sqr_fixed_body(big_uint *rp, const big_uint *ap,
+                                                                      size_t n) {
+#ifdef BIGINT_X86_ASM
+    if (n == 8 && limb_has_mulx_adx()) {
+        limb_mul_fixed_body(rp, ap, ap, n);
+        return;
     }
-    A0->num_limbs = m;
-    A1->num_limbs = m;
-    A0->signum = A->signum;
-    A1->signum = A->signum;
-    A0->data = (big_uint *)malloc(m * sizeof(big_uint));
-    A1->data = (big_uint *)malloc((m) * sizeof(big_uint));
-    if (A0->data == NULL || A1->data == NULL) {
-        big_free(A0);
-        big_free(A1);
-        return ERR_BIGINT_ALLOC_FAILED;
+#endif
+    rp[0] = 0;
+    rp[2 * n - 1] = 0;
+    rp[n] = limb_mul_1(rp + 1, ap + 1, n - 1, ap[0]);
+    for (size_t j = 1; j + 1 < n; j++) {
+        rp[n + j] = limb_addmul_1(rp + 2 * j + 1, ap + j + 1, n - j - 1, ap[j]);
     }
-    memcpy(A0->data, A->data, m * sizeof(big_uint));
-    memcpy(A1->data, A->data + m, (A->num_limbs - m) * sizeof(big_uint));
-    for (size_t i = 2*m; i > A->num_limbs; i--) {
-        A1->data[m-(2*m-i)-1] = 0;
+    big_uint high = 0;
+    big_uint carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        big_udbl square = (big_udbl)ap[i] * ap[i];
+        big_uint lo = rp[2 * i];
+        big_uint hi = rp[2 * i + 1];
+        big_udbl sum = (big_udbl)((lo << 1) | high) + (big_uint)square + carry;
+        rp[2 * i] = (big_uint)sum;
+        sum = (big_udbl)((hi << 1) | (lo >> 63)) + (big_uint)(square >> 64) + (big_uint)(sum >> 64);
+        rp[2 * i + 1] = (big_uint)sum;
+        carry = (big_uint)(sum >> 64);
+        high = hi >> 63;
     }
 }
 
-/* 
-This function shifts src by limb_shift limbs into bigint result. 
+/*
+Montgomery multiplication as the product on the stack and a separate
+reduction, limb_mont_redc with its rows on the fixed width kernels. Squares
+take the squaring kernel.
 */
-void big_shift_left(bigint *result, const bigint *src, size_t limb_shift) {
-    if (limb_shift == 0) {
-        big_copy(result, src);
-        return;
-    }
-    if (big_is_zero(src)) {
-        free(result->data);
-        result->data = malloc(sizeof(big_uint));
-        result->data[0] = 0;
-        result->signum = 1;
-        result->num_limbs = 1;
-        return;
+static inline __attribute__((always_inline)) void limb_mont_mul_fixed_body(big_uint *rp, const big_uint *ap,
+                                                                           const big_uint *bp,
+                                                                           const big_uint *np, big_uint ninv,
+                                                                           size_t n) {
+    big_uint t[128];
+    if (ap == bp) {
+        limb_sqr_fixed_body(t, ap, n);
     }
-    big_uint *temp = realloc(result->data, (src->num_limbs + limb_shift) * sizeof(big_uint));
-    if (temp == NULL) {
-        return;
+    else {
+        limb_mul_fixed_body(t, ap, bp, n);
     }
-    result->data = temp;
-
-    for (size_t i = 0; i < limb_shift; i++) {
-        result->data[i] = 0;
+    for (size_t i = 0; i < n; i++) {
+        big_uint q = t[i] * ninv;
+#ifdef BIGINT_X86_ASM
+        if (n >= 8 && limb_has_mulx_adx()) {
+            t[i] = limb_addmul_1_adx(t + i, np, n / 4, q);
+            continue;
+        }
+#endif
+        big_uint carry = 0;
+        for (size_t j = 0; j < n; j++) {
+            big_udbl p = (big_udbl)np[j] * q + t[i + j] + carry;
+            t[i + j] = (big_uint)p;
+            carry = (big_uint)(p >> 64);
+        }
+        t[i] = carry;
     }
-    for (size_t i = 0; i < src->num_limbs; i++) {
-        result->data[i + limb_shift] = src->data[i];
+    big_uint cy = limb_add_fixed_body(rp, t + n, t, n);
+    if (cy != 0 || limb_cmp(rp, np, n) >= 0) {
+        limb_sub_fixed_body(rp, rp, np, n);
     }
+}
 
-    result->signum = src->signum;
-    result->num_limbs = src->num_limbs + limb_shift;
+big_uint limb_add_fixed(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    switch (n) {
+    case 4:
+        return limb_add_fixed_body(rp, ap, bp, 4);
+    case 8:
+        return limb_add_fixed_body(rp, ap, bp, 8);
+    case 16:
+        return limb_add_fixed_body(rp, ap, bp, 16);
+    case 32:
+        return limb_add_fixed_body(rp, ap, bp, 32);
+    case 64:
+        return limb_add_fixed_body(rp, ap, bp, 64);
+    default:
+        return limb_add_n(rp, ap, bp, n);
+    }
 }
 
-/* 
-Similar to big_mul, this function multiplies A and B using Karatsuba's logic
-defined in the report. 
-*/
-int big_karatsuba(bigint *X, const bigint *A, const bigint *B) {
-    if (A == NULL || B == NULL || X == NULL) {
-        return ERR_BIGINT_BAD_INPUT_DATA; 
+big_uint limb_sub_fixed(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    switch (n) {
+    case 4:
+        return limb_sub_fixed_body(rp, ap, bp, 4);
+    case 8:
+        return limb_sub_fixed_body(rp, ap, bp, 8);
+    case 16:
+        return limb_sub_fixed_body(rp, ap, bp, 16);
+    case 32:
+        return limb_sub_fixed_body(rp, ap, bp, 32);
+    case 64:
+        return limb_sub_fixed_body(rp, ap, bp, 64);
+    default:
+        return limb_sub_n(rp, ap, bp, n);
     }
+}
 
-    int sign = 1;
-    if (A->signum == -1) {
-        sign *= -1;
+// rp must not overlap ap or bp
+void limb_mul_fixed(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    switch (n) {
+    case 4:
+        limb_mul_fixed_body(rp, ap, bp, 4);
+        break;
+    case 8:
+        limb_mul_fixed_body(rp, ap, bp, 8);
+        break;
+    case 16:
+        limb_mul_fixed_body(rp, ap, bp, 16);
+        break;
+    case 32:
+        limb_mul_fixed_body(rp, ap, bp, 32);
+        break;
+    case 64:
+        limb_mul_fixed_body(rp, ap, bp, 64);
+        break;
+    default:
+        limb_mul_basecase(rp, ap, n, bp, n);
+        break;
     }
-    if (B->signum == -1) {
-        sign *= -1;
+}
+
+void limb_sqr_fixed(big_uint *rp, const big_uint *ap, size_t n) {
+    switch (n) {
+    case 4:
+        limb_sqr_fixed_body(rp, ap, 4);
+        break;
+    case 8:
+        limb_sqr_fixed_body(rp, ap, 8);
+        break;
+    case 16:
+        limb_sqr_fixed_body(rp, ap, 16);
+        break;
+    case 32:
+        limb_sqr_fixed_body(rp, ap, 32);
+        break;
+    case 64:
+        limb_sqr_fixed_body(rp, ap, 64);
+        break;
+    default:
+        limb_sqr_basecase(rp, ap, n);
+        break;
     }
-    // Threshold to switch to big_mul is 64 limbs, based on results
-    // from the experiments. 
-    if (A->num_limbs <= 64 || B->num_limbs <= 64) {
-        return big_mul(X, A, B);
+}
+
+void limb_mont_mul_fixed(big_uint *rp, const big_uint *ap, const big_uint *bp, const big_uint *np,
+                         big_uint ninv, size_t n) {
+    switch (n) {
+    case 4:
+        limb_mont_mul_fixed_body(rp, ap, bp, np, ninv, 4);
+        break;
+    case 8:
+        limb_mont_mul_fixed_body(rp, ap, bp, np, ninv, 8);
+        break;
+    case 16:
+        limb_mont_mul_fixed_body(rp, ap, bp, np, ninv, 16);
+        break;
+    case 32:
+        limb_mont_mul_fixed_body(rp, ap, bp, np, ninv, 32);
+        break;
+    case 64:
+        limb_mont_mul_fixed_body(rp, ap, bp, np, ninv, 64);
+        break;
     }
+}
 
-    // Determines the split point
-    size_t n = (A->num_limbs > B->num_limbs ? A->num_limbs : B->num_limbs);
-    size_t m = (n + 1) / 2;
-    bigint A0, A1, B0, B1, Z0, Z1, Z2;
-    big_init(&A0); 
-    big_init(&A1); 
-    big_init(&B0); 
-    big_init(&B1);
-    big_init(&Z0);
-    big_init(&Z1); 
-    big_init(&Z2);
-    // Split A and B into high and low parts
-    split_bigint(A, m, &A0, &A1);
-    split_bigint(B, m, &B0, &B1);
-    // Z0 = A0 * B0
-    big_karatsuba(&Z0, &A0, &B0);
-    // Z2 = A1 * B1
-    big_karatsuba(&Z2, &A1, &B1);
-
-    // Z1 = (A0 + A1) * (B0 + B1) - Z0 - Z2
-    bigint tempA, tempB;
-    big_init(&tempA); 
-    big_init(&tempB);
-    big_add(&tempA, &A0, &A1);
-    big_add(&tempB, &B0, &B1);
-    big_karatsuba(&Z1, &tempA, &tempB);
-    big_sub(&Z1, &Z1, &Z0);
-    big_sub(&Z1, &Z1, &Z2);
-
-    // Combine results
-    bigint shifted_Z2, shifted_Z1;
-    big_init(&shifted_Z2); 
-    big_init(&shifted_Z1);
-    
-    // Shift Z1 by m limbs
-    big_shift_left(&shifted_Z1, &Z1, m); 
-    // Shift Z2 by 2 * m limbs
-    big_shift_left(&shifted_Z2, &Z2, 2 * m);  
-         
-
-    bigint result, temp;
-    big_init(&result);
-    big_init(&temp);
-    big_add(&temp, &Z0, &shifted_Z1);
-    big_add(&result, &temp, &shifted_Z2);
+big_uint big_fixed_add(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    return limb_add_fixed(rp, ap, bp, n);
+}
 
-    big_copy(X, &result);
-    X->signum = sign;
+big_uint big_fixed_sub(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    return limb_sub_fixed(rp, ap, bp, n);
+}
 
-    big_free(&A0); 
-    big_free(&A1);
-    big_free(&B0); 
-    big_free(&B1);
-    big_free(&Z0); 
-    big_free(&Z1); 
-    big_free(&Z2);
-    big_free(&tempA); 
-    big_free(&tempB);
-    big_free(&shifted_Z1); 
-    big_free(&shifted_Z2);
-    big_free(&result);
-    big_free(&temp);
-
-    return 0;
+void big_fixed_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    limb_mul_fixed(rp, ap, bp, n);
 }
 
-/* 
-Similar to split_bigint, this function splits A into 3 m equal parts A0, A1, and A2. 
-Necessary for Toom-Cook Multiplication
-*/
-int split_bigint_three(const bigint *A, size_t m, bigint *A0, bigint *A1, bigint *A2) {
-    big_init(A0);
-    big_init(A1);
-    big_init(A2);
-
-    A0->num_limbs = m;
-    A1->num_limbs = m;
-    A2->num_limbs = m;
-    // Necessary for copying over old-data, prevents buffer overflow error
-    size_t old = A->num_limbs - 2 * m;
-    if (A2->num_limbs == 0) {
-        A2->num_limbs = 1;
-    }
-
-    A0->signum = 1;
-    A1->signum = 1;
-    A2->signum = 1;
-
-    A0->data = (big_uint *)malloc(m * sizeof(big_uint));
-    A1->data = (big_uint *)malloc(m * sizeof(big_uint));
-    A2->data = (big_uint *)malloc(m * sizeof(big_uint));
-
-    if (A0->data == NULL || A1->data == NULL || A2->data == NULL) {
-        big_free(A0);
-        big_free(A1);
-        big_free(A2);
-        return ERR_BIGINT_ALLOC_FAILED;
-    }
+void big_fixed_sqr(big_uint *rp, const big_uint *ap, size_t n) {
+    limb_sqr_fixed(rp, ap, n);
+}
 
-    memcpy(A0->data, A->data, m * sizeof(big_uint));
-    memcpy(A1->data, A->data + m, m * sizeof(big_uint));
-    memcpy(A2->data, A->data + 2 * m, old * sizeof(big_uint));
-    // What isn't copied over needs to be zeroed out 
-    for (size_t i = old; i < m; i++) {
-        A2->data[i] = 0;
+int big_fixed_mont_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, const big_mont_ctx *ctx) {
+    if (rp == NULL || ap == NULL || bp == NULL || ctx == NULL || ctx->N == NULL || !limb_is_fixed_width(ctx->n)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
     }
+    limb_mont_mul_fixed(rp, ap, bp, ctx->N, ctx->ninv, ctx->n);
     return 0;
 }
 
-/* 
-This method allows for src to be bit_shifted left by bit_shift bits, allowing
-for easy multiplication by a power of 2. 
+/*
+Schoolbook multiplication {rp, an + bn} = {ap, an} * {bp, bn}, with
+an, bn >= 1 and rp not overlapping either input.
 */
-int big_bit_shift_left(bigint *result, const bigint *src, size_t bit_shift) {
-    // Handles edge case of 0
-    if (big_is_zero(src)) {
-        free(result->data);
-        result->data = malloc(sizeof(big_uint));
-        result->data[0] = 0;
-        result->signum = 1;
-        result->num_limbs = 1;
-        return 0;
-    }
-    size_t bit_offset = bit_shift % 64;
-    size_t limb_shift = bit_shift / 64;
-    
-
-    size_t add = 0;
-    if (bit_offset != 0) {
-        add = 1;
+void limb_mul_basecase(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn) {
+    if (an == bn && limb_is_fixed_width(an)) {
+        limb_mul_fixed(rp, ap, bp, an);
+        return;
     }
-    size_t new_num_limbs = src->num_limbs + limb_shift + add;
-    big_uint *temp = (big_uint *)calloc(new_num_limbs, sizeof(big_uint));
-    if (temp == NULL) {
-        return ERR_BIGINT_ALLOC_FAILED;
+    rp[an] = limb_mul_1(rp, ap, an, bp[0]);
+    for (size_t j = 1; j < bn; j++) {
+        rp[an + j] = limb_addmul_1(rp + j, ap, an, bp[j]);
     }
+}
 
-    // Handles shifting over limbs' bits
-    for (size_t i = 0; i < src->num_limbs; i++) {
-        size_t new_index = i + limb_shift;
-        temp[new_index] |= src->data[i] << bit_offset;
-        if (bit_offset != 0 && new_index + 1 < new_num_limbs) {
-            temp[new_index + 1] |= src->data[i] >> (64 - bit_offset);
-        }
+// rp -= ap * b over n limbs, returns the limb that still has to be borrowed
+big_uint limb_submul_1(big_uint *rp, const big_uint *ap, size_t n, big_uint b) {
+    big_uint carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        big_udbl product = (big_udbl)ap[i] * b + carry;
+        big_uint low = (big_uint)product;
+        carry = (big_uint)(product >> 64);
+        big_uint r = rp[i];
+        rp[i] = r - low;
+        carry += r < low;
     }
+    return carry;
+}
 
-    // Remove leading zeros
-    while (new_num_limbs > 1 && temp[new_num_limbs - 1] == 0) {
-        new_num_limbs--;
+// Inverse of the odd limb d modulo 2^64, by Newton's iteration: d is its own
+// inverse to 3 bits and each step doubles the number of correct bits
+big_uint limb_binvert(big_uint d) {
+    big_uint inv = d;
+    for (int i = 0; i < 5; i++) {
+        inv *= 2 - d * inv;
     }
-
-    result->num_limbs = new_num_limbs;
-    result->signum = src->signum;
-    free(result->data);
-    result->data = temp;
-    return 0;
+    return inv;
 }
 
-/* 
-This method allows for src to be bit_shifted right by bit_shift bits, allowing
-for easy division by a power of 2. 
-*/
-int big_bit_shift_right(bigint *result, const bigint *src, size_t bit_shift) {
-    // Handles edge case of 0
-    if (big_is_zero(src)) {
-        free(result->data);
-        result->data = malloc(sizeof(big_uint));
-        result->data[0] = 0;
-        result->signum = 1;
-        result->num_limbs = 1;
+// Shifts by 0 <= cnt < 64 bits, returns the bits shifted out
+big_uint limb_lshift(big_uint *rp, const big_uint *ap, size_t n, unsigned cnt) {
+    if (cnt == 0) {
+        memmove(rp, ap, n * sizeof(big_uint));
         return 0;
     }
+    big_uint out = ap[n - 1] >> (64 - cnt);
+    for (size_t i = n - 1; i > 0; i--) {
+        rp[i] = (ap[i] << cnt) | (ap[i - 1] >> (64 - cnt));
+    }
+    rp[0] = ap[0] << cnt;
+    return out;
+}
 
-    size_t bit_offset = bit_shift % 64;
-    size_t limb_shift = bit_shift / 64;
-    size_t new_num_limbs = (src->num_limbs > limb_shift) ? (src->num_limbs - limb_shift) : 0;
-    if (new_num_limbs == 0) {
-        // Result should be 0 if no new_limbs, edge case handles
-        free(result->data);
-        result->data = (big_uint *)calloc(1, sizeof(big_uint));
-        result->num_limbs = 1;
-        result->signum = 0;
-        result->data[0] = 0;
+big_uint limb_rshift(big_uint *rp, const big_uint *ap, size_t n, unsigned cnt) {
+    if (cnt == 0) {
+        memmove(rp, ap, n * sizeof(big_uint));
         return 0;
     }
+    big_uint out = ap[0] << (64 - cnt);
+    for (size_t i = 0; i + 1 < n; i++) {
+        rp[i] = (ap[i] >> cnt) | (ap[i + 1] << (64 - cnt));
+    }
+    rp[n - 1] = ap[n - 1] >> cnt;
+    return out;
+}
 
-    big_uint *temp = (big_uint *)calloc(new_num_limbs, sizeof(big_uint));
-    if (temp == NULL) {
-        return ERR_BIGINT_ALLOC_FAILED;
+/*
+Below this many limbs the rows of the triangle are too short to gain on the
+extra doubling and diagonal passes, and squaring is left to
+limb_mul_basecase.
+*/
+#ifndef SQR_BASECASE_THRESHOLD
+#define SQR_BASECASE_THRESHOLD 12
+#endif
+size_t sqr_basecase_threshold = SQR_BASECASE_THRESHOLD;
+
+/*
+Schoolbook squaring {rp, 2n} = {ap, n}^2 for n >= 1, rp not overlapping ap.
+Every cross product a_i a_j with i < j appears twice in the square, so each
+is formed once, the sum of them doubled with a shift, and the squares a_i^2
+added in along the diagonal. That is about half the multiplications of
+limb_mul_basecase.
+*/
+void limb_sqr_basecase(big_uint *rp, const big_uint *ap, size_t n) {
+    if (limb_is_fixed_width(n)) {
+        limb_sqr_fixed(rp, ap, n);
+        return;
+    }
+    if (n < sqr_basecase_threshold) {
+        limb_mul_basecase(rp, ap, n, ap, n);
+        return;
+    }
+    rp[0] = 0;
+    rp[n] = limb_mul_1(rp + 1, ap + 1, n - 1, ap[0]);
+    for (size_t i = 1; i + 1 < n; i++) {
+        rp[n + i] = limb_addmul_1(rp + 2 * i + 1, ap + i + 1, n - i - 1, ap[i]);
     }
+    rp[2 * n - 1] = limb_lshift(rp + 1, rp + 1, 2 * n - 2, 1);
+
+    big_uint carry = 0;
+    for (size_t i = 0; i < n; i++) {
+        big_udbl square = (big_udbl)ap[i] * ap[i];
+        big_udbl sum = (big_udbl)rp[2 * i] + (big_uint)square + carry;
+        rp[2 * i] = (big_uint)sum;
+        sum = (big_udbl)rp[2 * i + 1] + (big_uint)(square >> 64) + (big_uint)(sum >> 64);
+        rp[2 * i + 1] = (big_uint)sum;
+        carry = (big_uint)(sum >> 64);
+    }
+}
+
+/*
+With SSE2, which every x86-64 CPU has, the hexadecimal conversions below
+turn 16 digits into a limb and back in a handful of vector instructions.
+Defining BIGINT_NO_ASM keeps them to the portable loops.
+*/
+#if defined(__SSE2__) && !defined(BIGINT_NO_ASM)
+#include <emmintrin.h>
+#define BIGINT_SSE2 1
+#endif
+
+int radix_digit_value(char c);
 
-    // Handles shifting over limbs' bits
-    for (size_t i = 0; i < new_num_limbs; i++) {
-        size_t src_index = i + limb_shift;
-        temp[i] |= src->data[src_index] >> bit_offset;
-        if (bit_offset != 0 && src_index + 1 < src->num_limbs) {
-            temp[i] |= src->data[src_index + 1] << (64 - bit_offset);
+/*
+Parses the 16 hex digits at s, most significant first, into *limb. Returns
+false if any of them is not a hex digit.
+*/
+bool hex_pack_16(const char *s, big_uint *limb) {
+#ifdef BIGINT_SSE2
+    __m128i c = _mm_loadu_si128((const __m128i *)s);
+    // x < k as unsigned bytes is min(x, k - 1) == x
+    __m128i digit = _mm_sub_epi8(c, _mm_set1_epi8('0'));
+    __m128i is_digit = _mm_cmpeq_epi8(_mm_min_epu8(digit, _mm_set1_epi8(9)), digit);
+    __m128i letter = _mm_sub_epi8(_mm_or_si128(c, _mm_set1_epi8(0x20)), _mm_set1_epi8('a'));
+    __m128i is_letter = _mm_cmpeq_epi8(_mm_min_epu8(letter, _mm_set1_epi8(5)), letter);
+    if (_mm_movemask_epi8(_mm_or_si128(is_digit, is_letter)) != 0xFFFF) {
+        return false;
+    }
+    __m128i nibbles = _mm_or_si128(_mm_and_si128(is_digit, digit),
+                                   _mm_and_si128(is_letter, _mm_add_epi8(letter, _mm_set1_epi8(10))));
+    // Each 16-bit lane holds a digit pair, the first one in its low byte
+    __m128i pairs = _mm_or_si128(_mm_and_si128(_mm_slli_epi16(nibbles, 4), _mm_set1_epi16(0x0FF0)),
+                                 _mm_srli_epi16(nibbles, 8));
+    __m128i bytes = _mm_packus_epi16(pairs, pairs);
+    *limb = __builtin_bswap64((big_uint)_mm_cvtsi128_si64(bytes));
+    return true;
+#else
+    big_uint value = 0;
+    for (int i = 0; i < 16; i++) {
+        int d = radix_digit_value(s[i]);
+        if (d >= 16) {
+            return false;
         }
+        value = (value << 4) | d;
     }
+    *limb = value;
+    return true;
+#endif
+}
 
-    // Remove leading zeros
-    while (new_num_limbs > 1 && temp[new_num_limbs - 1] == 0) {
-        new_num_limbs--;
+// Writes limb as 16 lower case hex digits, most significant first
+void hex_unpack_16(char *s, big_uint limb) {
+#ifdef BIGINT_SSE2
+    __m128i bytes = _mm_cvtsi64_si128((long long)__builtin_bswap64(limb));
+    __m128i low = _mm_and_si128(bytes, _mm_set1_epi8(0x0F));
+    __m128i high = _mm_and_si128(_mm_srli_epi16(bytes, 4), _mm_set1_epi8(0x0F));
+    __m128i nibbles = _mm_unpacklo_epi8(high, low);
+    // '0' + d, plus the gap from '9' + 1 to 'a' for d > 9
+    __m128i gap = _mm_and_si128(_mm_cmpgt_epi8(nibbles, _mm_set1_epi8(9)), _mm_set1_epi8('a' - '9' - 1));
+    __m128i ascii = _mm_add_epi8(_mm_add_epi8(nibbles, _mm_set1_epi8('0')), gap);
+    _mm_storeu_si128((__m128i *)s, ascii);
+#else
+    for (int i = 15; i >= 0; i--) {
+        s[i] = "0123456789abcdef"[limb & 0xF];
+        limb >>= 4;
     }
-
-    result->num_limbs = new_num_limbs;
-    result->signum = src->signum;
-    free(result->data);
-    result->data = temp;
+#endif
 }
 
-/* 
-This function evaluates the specific points needed for the given 3 subcomponent
-split as required by Toom-Cook at the following points: 0, 1, -1, 2, and "inf". 
-Explained in report in detail. 
-*/
-void evaluate_polynomials(const bigint *A0, const bigint *A1, const bigint *A2, 
-                          bigint *P0, bigint *P1, bigint *P_1, bigint *P2, bigint *P_inf) {
-    bigint tempA1, tempA2;
-    bigint sum;
-    big_init(&sum);
-    big_init(&tempA1); 
-    big_init(&tempA2);
-
-    // P0 = A0
-    big_copy(P0, A0);
-
-    // P_inf = A2
-    big_copy(P_inf, A2);
-
-    // P1 = A2 + A1 + A0
-    big_add(&tempA1, A2, A1);
-    big_add(P1, &tempA1, A0);
-
-    // P_1 = A2 - A1 + A0
-    big_sub(&tempA1, A2, A1);
-    big_add(P_1, &tempA1, A0);
-
-    // P2 = 4*A2 + 2*A1 + A0
-    big_bit_shift_left(&tempA1, A2, 2); // 4*A2
-    big_bit_shift_left(&tempA2, A1, 1); // 2*A1
-    big_add(&sum, &tempA1, &tempA2);
-    big_add(P2, &sum, A0);
-
-    big_free(&tempA1); 
-    big_free(&tempA2);
-    big_free(&sum);
-}
-
-/*
-Custom divide by 3 for given bigint representation with 2^64 serving as base.
-Necessary for improving Toom-Cook's performance as other divide had to be used, 
-which crippled performance at large big_ints. Explained in report further. 
-Divides the passed in bigint by 3, and returns the remainder!
-*/
-int divide_by_3(bigint* cur) {
-    uint32_t carry = 0;  
-    uint32_t final = 0;
-    size_t i = cur->num_limbs-1; 
-    while (i >= 0) {
-        big_uint current = 0;
-        if (carry != 0) {
-            if (carry == 1) {
-                if (i == 0) {
-                    current = (big_uint) 6148914691236517205 + cur->data[i] / 3;
-                }
-                else {
-                current = (big_uint) 6148914691236517205 + cur->data[i] / 3;
-                }
-                big_uint temp = (cur->data[i]) % 3;
-                if (temp != 0 && (temp+carry) != 2) {
-                    current+=1;
-                }
-            }
-            if (carry == 2) {
-                if (i == 0) {
-                    // These are errors due to large numbers, but do not affect calculations. 
-                    current = 12297829382473034410 + cur->data[i] / 3;
-                }
-                else {
-                current = 12297829382473034410 + cur->data[i] / 3;
-                }
-                big_uint temp = cur->data[i] % 3;
-                if (temp != 0) {
-                    current+=1;
-                }
+/*
+Reads the hex string straight into the limbs of a scratch bigint, which are
+filled from the top since the string starts with the most significant digit.
+The first limb takes the len % 16 leftover digits, every later one exactly
+16. X only takes the result over once the whole string has parsed, so a bad
+digit leaves it as it was.
+*/
+int big_read_string(bigint *X, const char *s) {
+    if (s == NULL || X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    int signum = 1;
+    if (s[0] == '-') {
+        signum = -1;
+        s++;
+    }
+    size_t len = strlen(s);
+    if (len == 0) {
+        return ERR_BIGINT_INVALID_CHARACTER;
+    }
+    size_t limbs = (len + 15) / 16;
+    big_uint *value = (big_uint *)malloc(limbs * sizeof(big_uint));
+    if (value == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    size_t head = len % 16;
+    size_t i = limbs;
+    if (head != 0) {
+        big_uint limb = 0;
+        for (size_t j = 0; j < head; j++) {
+            int d = radix_digit_value(s[j]);
+            if (d >= 16) {
+                free(value);
+                return ERR_BIGINT_INVALID_CHARACTER;
             }
+            limb = (limb << 4) | d;
         }
-        else {
-            current = (carry + cur->data[i]) / 3;  
-        }
-        final = current % 3;
-        carry = (cur->data[i] + carry) % 3; 
-        cur->data[i] = current;  
-        if (i == 0) {
-            break;
+        value[--i] = limb;
+    }
+    for (const char *p = s + head; i > 0; p += 16) {
+        if (!hex_pack_16(p, &value[--i])) {
+            free(value);
+            return ERR_BIGINT_INVALID_CHARACTER;
         }
-        i--;
     }
-    return carry;
+    big_adopt_limbs(X, value, limbs, signum);
+    return 0;
 }
-
-/* 
-Solves system of interpolated points to recover coefficients a, b, c, d, e of 
-the product. As described in the report. 
-*/
-void interpolate_results(bigint *result, const bigint *R0, const bigint *R1, 
-                         const bigint *R_1, const bigint *R2, const bigint *R_inf, size_t m) {
-    bigint temp1; 
-    bigint temp2;
-    bigint temp3;
-    bigint temp1shifted;
-    bigint temp2shifted;
-    bigint temp3shifted;
-    bigint temp4shifted;
-    bigint a;
-    bigint b;
-    bigint c;
-    bigint d;
-    bigint e;
-
-    big_init(&temp1); 
-    big_init(&temp1shifted);
-    big_init(&temp2shifted);
-    big_init(&temp3shifted);
-    big_init(&temp4shifted);
-    big_init(&temp2); 
-    big_init(&temp3);
-    big_init(&a); 
-    big_init(&b); 
-    big_init(&c); 
-    big_init(&d); 
-    big_init(&e);
-
-    // e
-    big_copy(&e, R0);
-
-    // a
-    big_copy(&a, R_inf);
-
-    // c
-    big_add(&temp1, R_1, R1); 
-    big_bit_shift_right(&temp1shifted, &temp1, 1);
-    big_sub(&temp1shifted, &temp1shifted, R_inf);
-    big_sub(&temp1shifted, &temp1shifted, R0);
-    big_copy(&c, &temp1shifted);
-
-    // b
-    big_bit_shift_left(&temp2shifted, R_inf, 4);
-    big_sub(&temp2, R2, &temp2shifted);
-    big_bit_shift_left(&temp3shifted, &c, 2);
-    big_sub(&temp2, &temp2, &temp3shifted);
-    big_sub(&temp2, &temp2, R0);
-    big_sub(&temp2, &temp2, R1);
-    bigint tempp;
-    big_init(&tempp);
-    big_add(&tempp, &temp2, R_1);
-    big_bit_shift_right(&b, &tempp, 1);
-    big_free(&tempp);
-
-    int remain = divide_by_3(&b);
-    if (remain != 0) {
-        bigint one;
-        big_set_nonzero(&one, 1);
-        big_add(&b, &b, &one);
-        big_free(&one);
-    }
-
-    // d 
-    big_sub(&temp3, R1, R_1);
-    big_bit_shift_right(&temp4shifted, &temp3, 1);
-    big_sub(&temp4shifted, &temp4shifted, &b);
-    big_copy(&d, &temp4shifted);
-
-    // Final Result Calculations, shifts each coefficient by necessary amount
-    bigint temp_result;
-    big_init(&temp_result);
-
-    big_shift_left(&temp_result, &a, 4 * m);
-    big_add(result, result, &temp_result);
-
-    big_shift_left(&temp_result, &b, 3 * m);
-    big_add(result, result, &temp_result);
-
-    big_shift_left(&temp_result, &c, 2 * m);
-    big_add(result, result, &temp_result);
-
-    big_shift_left(&temp_result, &d, m);
-
-    big_add(result, result, &temp_result);
-    big_add(result, result, &e);
-
-    big_free(&temp1); 
-    big_free(&temp2); 
-    big_free(&temp3);
-    big_free(&temp1shifted);
-    big_free(&temp2shifted);
-    big_free(&temp3shifted);
-    big_free(&temp4shifted);
-    big_free(&a); 
-    big_free(&b); 
-    big_free(&c); 
-    big_free(&d); 
-    big_free(&e);
-    big_free(&temp_result);
-}
-
-// Pads the provided B with 0s up the the target number of limbs
-void big_pad(bigint *B, size_t target) {
-    big_uint *new_limbs = (big_uint *)calloc(target, sizeof(big_uint));
-    memcpy(new_limbs, B->data, B->num_limbs * sizeof(big_uint));
-    free(B->data);
-    B->num_limbs = target;
-    B->data = new_limbs;
+void print_bigint(const bigint *X) {
+    printf("BigInt Limbs (%lu):\n", X->num_limbs);
+    printf("Pos or Negative: %d\n", X->signum);
+    for (size_t i = 0; i < X->num_limbs; i++) {
+        printf("Limb %lu: %lu\n", i, X->data[i]);
+    }
 }
 
-/* 
-Calculates the product of A and B and puts it into X, correctly splits A and B
-into 3 equal pieces, recursively evaluates the polynomials, and then interpolates
-the results back into X. Described in the report. 
+/*
+The length follows from the top limb alone, so the digits are written in a
+single pass: the top limb without its leading zeros, then 16 per limb.
 */
-int big_toom_cook(bigint *X, bigint *A, bigint *B) {
-    if (A == NULL || B == NULL || X == NULL) {
-        return ERR_BIGINT_BAD_INPUT_DATA; 
-    }
-    // Handles signed numbers
-    int sign = 1;
-    if (A->signum == -1) {
-        sign *= -1;
-    }
-    if (B->signum == -1) {
-        sign *= -1;
+int big_write_string(const bigint *X,
+                     char *buf, size_t buflen, size_t *olen) {
+    if (X == NULL || buf == NULL || olen == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;  
     }
+    size_t n = limb_trimmed_len(X->data, X->num_limbs);
+    size_t sign = (X->signum < 0 && n > 0) ? 1 : 0;
+    size_t top_digits = (n > 0) ? 16 - __builtin_clzll(X->data[n - 1]) / 4 : 1;
+    *olen = sign + top_digits + 16 * ((n > 0) ? n - 1 : 0) + 1;
 
-    // Base case for small numbers, use big_mul
-    if (A->num_limbs <= 225 || B->num_limbs <= 225) {
-        return big_mul(X, A, B);
+    if (buflen < *olen) {
+        return ERR_BIGINT_BUFFER_TOO_SMALL;
     }
 
-    // Determine if padding is necessary
-    if (A->num_limbs < B->num_limbs) {
-        big_pad(A, B->num_limbs);
+    char *p = buf;
+    if (sign) {
+        *p++ = '-';
     }
-    else if (B->num_limbs < A->num_limbs) {
-        big_pad(B, A->num_limbs);
+    big_uint top = (n > 0) ? X->data[n - 1] : 0;
+    for (size_t j = top_digits; j > 0; j--) {
+        *p++ = "0123456789abcdef"[(top >> (4 * (j - 1))) & 0xF];
     }
+    for (size_t i = (n > 0) ? n - 1 : 0; i > 0; i--, p += 16) {
+        hex_unpack_16(p, X->data[i - 1]);
+    }
+    *p = '\0';
+    return 0;  
+}
 
-    size_t n = A->num_limbs;
-    size_t m = (n + 2) / 3;
-
-    bigint A0, A1, A2, B0, B1, B2;
-    bigint P0, P1, P_1, P2, P_inf, Q0, Q1, Q_1, Q2, Q_inf;
-    bigint R0, R1, R_1, R2, R_inf;
-
-    big_init(&A0); 
-    big_init(&A1); 
-    big_init(&A2);
+/*
+Binary import and export. The big endian functions byte swap whole limbs,
+and on little endian hosts the little endian ones are plain copies, since
+that is how the limbs sit in memory already.
+*/
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define BIGINT_LITTLE_ENDIAN 1
+#endif
+
+// Loads the 8 bytes at p as a big endian limb
+big_uint limb_load_be(const uint8_t *p) {
+    big_uint limb;
+    memcpy(&limb, p, sizeof(limb));
+#ifdef BIGINT_LITTLE_ENDIAN
+    limb = __builtin_bswap64(limb);
+#endif
+    return limb;
+}
 
-    big_init(&B0);
-    big_init(&B1); 
-    big_init(&B2);
-
-    big_init(&P0);
-    big_init(&P1); 
-    big_init(&P_1);
-    big_init(&P2); 
-    big_init(&P_inf); 
-
-    big_init(&Q0);
-    big_init(&Q1); 
-    big_init(&Q_1); 
-    big_init(&Q2);
-    big_init(&Q_inf); 
-
-    big_init(&R0); 
-    big_init(&R1);
-    big_init(&R_1); 
-    big_init(&R2); 
-    big_init(&R_inf);
-
-    // Split A and B into three parts
-    split_bigint_three(A, m, &A0, &A1, &A2);
-    split_bigint_three(B, m, &B0, &B1, &B2);
-
-    // Evaluate polynomials at different points
-    evaluate_polynomials(&A0, &A1, &A2, &P0, &P1, &P_1, &P2, &P_inf);
-    evaluate_polynomials(&B0, &B1, &B2, &Q0, &Q1, &Q_1, &Q2, &Q_inf);
-
-    // Perform recursive multiplications
-    big_toom_cook(&R0, &P0, &Q0);
-    big_toom_cook(&R1, &P1, &Q1);
-    big_toom_cook(&R_1, &P_1, &Q_1);
-    big_toom_cook(&R2, &P2, &Q2);
-    big_toom_cook(&R_inf, &P_inf, &Q_inf);
-
-    // Interpolate results to get final product
-    interpolate_results(X, &R0, &R1, &R_1, &R2, &R_inf, m);
-    X->signum = sign;
-    
-
-    big_free(&A0); 
-    big_free(&A1); 
-    big_free(&A2);
-
-    big_free(&B0); 
-    big_free(&B1); 
-    big_free(&B2);
-
-    big_free(&P0); 
-    big_free(&P1); 
-    big_free(&P_1);
-    big_free(&P2); 
-    big_free(&P_inf); 
-
-    big_free(&Q0);
-    big_free(&Q1); 
-    big_free(&Q_1); 
-    big_free(&Q2);
-    big_free(&Q_inf);
+void limb_store_be(uint8_t *p, big_uint limb) {
+#ifdef BIGINT_LITTLE_ENDIAN
+    limb = __builtin_bswap64(limb);
+#endif
+    memcpy(p, &limb, sizeof(limb));
+}
 
-    big_free(&R0); 
-    big_free(&R1);
-    big_free(&R_1); 
-    big_free(&R2); 
-    big_free(&R_inf);
+// Number of bytes in the magnitude of X, 0 for zero
+size_t big_trimmed_bytes(const bigint *X) {
+    size_t n = limb_trimmed_len(X->data, X->num_limbs);
+    return (n == 0) ? 0 : 8 * n - __builtin_clzll(X->data[n - 1]) / 8;
+}
 
+int big_read_binary(bigint *X, const uint8_t *buf, size_t buflen) {
+    if (X == NULL || (buf == NULL && buflen > 0)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t limbs = (buflen + 7) / 8;
+    int ret = big_reserve(X, (limbs > 0) ? limbs : 1);
+    if (ret != 0) {
+        return ret;
+    }
+    // The last bytes of buf are the least significant
+    size_t i = 0;
+    for (; 8 * (i + 1) <= buflen; i++) {
+        X->data[i] = limb_load_be(buf + buflen - 8 * (i + 1));
+    }
+    if (i < limbs) {
+        big_uint limb = 0;
+        for (size_t j = 0; j < buflen - 8 * i; j++) {
+            limb = (limb << 8) | buf[j];
+        }
+        X->data[i] = limb;
+    }
+    big_normalize(X, limbs, 1);
     return 0;
 }
 
-// One_Limb Multiplication Tests, used largely for edge cases
-bool one_limb_tests() {
-    bigint first;
-    bigint second;
-    bigint toom_result;
-    bigint karatsuba_result;
-    bigint actual;
+int big_write_binary(const bigint *X, uint8_t *buf, size_t buflen) {
+    if (X == NULL || (buf == NULL && buflen > 0)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (big_trimmed_bytes(X) > buflen) {
+        return ERR_BIGINT_BUFFER_TOO_SMALL;
+    }
+    size_t n = limb_trimmed_len(X->data, X->num_limbs);
+    size_t i = 0;
+    for (; i < n && 8 * (i + 1) <= buflen; i++) {
+        limb_store_be(buf + buflen - 8 * (i + 1), X->data[i]);
+    }
+    if (i < n) {
+        // Only the top limb can be cut short, and the bytes dropped are zero
+        big_uint limb = X->data[i];
+        for (size_t j = buflen - 8 * i; j > 0; j--) {
+            buf[j - 1] = (uint8_t)limb;
+            limb >>= 8;
+        }
+    }
+    else if (buflen > 8 * i) {
+        memset(buf, 0, buflen - 8 * i);
+    }
+    return 0;
+}
 
-    char a_buf[4000];
-    size_t temp;
-    char k_buf[4000];
-    char t_buf[4000];
+int big_read_binary_le(bigint *X, const uint8_t *buf, size_t buflen) {
+    if (X == NULL || (buf == NULL && buflen > 0)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t limbs = buflen / 8 + (buflen % 8 != 0);
+    int ret = big_reserve(X, (limbs > 0) ? limbs : 1);
+    if (ret != 0) {
+        return ret;
+    }
+#ifdef BIGINT_LITTLE_ENDIAN
+    if (limbs > 0) {
+        X->data[limbs - 1] = 0;
+        memcpy(X->data, buf, buflen);
+    }
+#else
+    memset(X->data, 0, limbs * sizeof(big_uint));
+    for (size_t j = 0; j < buflen; j++) {
+        X->data[j / 8] |= (big_uint)buf[j] << (8 * (j % 8));
+    }
+#endif
+    big_normalize(X, limbs, 1);
+    return 0;
+}
 
-    big_init(&toom_result);
-    big_init(&karatsuba_result);
-    big_init(&actual);
+int big_write_binary_le(const bigint *X, uint8_t *buf, size_t buflen) {
+    if (X == NULL || (buf == NULL && buflen > 0)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (big_trimmed_bytes(X) > buflen) {
+        return ERR_BIGINT_BUFFER_TOO_SMALL;
+    }
+    if (buflen == 0) {
+        return 0;
+    }
+    size_t n = limb_trimmed_len(X->data, X->num_limbs);
+    size_t bytes = (8 * n < buflen) ? 8 * n : buflen;
+#ifdef BIGINT_LITTLE_ENDIAN
+    memcpy(buf, X->data, bytes);
+#else
+    for (size_t j = 0; j < bytes; j++) {
+        buf[j] = (uint8_t)(X->data[j / 8] >> (8 * (j % 8)));
+    }
+#endif
+    memset(buf + bytes, 0, buflen - bytes);
+    return 0;
+}
 
-    // Tests 1 x 1
-    big_set_nonzero(&first, 1);
-    big_set_nonzero(&second, 1);
+/*
+Number files hold the limbs of the magnitude in little endian order, least
+significant first, so on a little endian host with mmap a file can be
+mapped and used in place. The mapping is rounded up to whole limbs, which
+the zeros the kernel fills the last page with after the end of the file
+take care of. Elsewhere the file is read into memory instead.
+*/
+#if (defined(__unix__) || defined(__APPLE__)) && defined(BIGINT_LITTLE_ENDIAN)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define BIGINT_MMAP 1
+#endif
+
+// Reads the whole file into a malloc'd copy, the fallback of big_map_file
+int big_map_file_copy(big_mapped_file *map, const char *path) {
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        return ERR_BIGINT_FILE_IO_ERROR;
+    }
+    size_t cap = 1 << 16;
+    size_t len = 0;
+    uint8_t *bytes = (uint8_t *)malloc(cap);
+    int ret = (bytes == NULL) ? ERR_BIGINT_ALLOC_FAILED : 0;
+    while (ret == 0) {
+        len += fread(bytes + len, 1, cap - len, f);
+        if (len < cap) {
+            ret = ferror(f) ? ERR_BIGINT_FILE_IO_ERROR : 0;
+            break;
+        }
+        uint8_t *grown = (uint8_t *)realloc(bytes, 2 * cap);
+        if (grown == NULL) {
+            ret = ERR_BIGINT_ALLOC_FAILED;
+            break;
+        }
+        bytes = grown;
+        cap *= 2;
+    }
+    fclose(f);
+    big_init(&map->value);
+    if (ret == 0) {
+        ret = big_read_binary_le(&map->value, bytes, len);
+    }
+    free(bytes);
+    if (ret != 0) {
+        big_free(&map->value);
+        return ret;
+    }
+    map->addr = map->value.data;
+    map->length = 0;
+    return 0;
+}
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+int big_map_file(big_mapped_file *map, const char *path) {
+    if (map == NULL || path == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+#ifdef BIGINT_MMAP
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return ERR_BIGINT_FILE_IO_ERROR;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return ERR_BIGINT_FILE_IO_ERROR;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return big_map_file_copy(map, path);
+    }
+    size_t length = ((size_t)st.st_size + 7) / 8 * 8;
+    void *addr = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return ERR_BIGINT_FILE_IO_ERROR;
+    }
+    size_t n = limb_trimmed_len((const big_uint *)addr, length / 8);
+    map->value = (bigint){.signum = 1, .num_limbs = (n > 0) ? n : 1, .alloc = length / 8,
+                          .data = (big_uint *)addr};
+    map->addr = addr;
+    map->length = length;
+    return 0;
+#else
+    return big_map_file_copy(map, path);
+#endif
+}
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+void big_unmap_file(big_mapped_file *map) {
+    if (map == NULL) {
+        return;
+    }
+#ifdef BIGINT_MMAP
+    if (map->length > 0) {
+        munmap(map->addr, map->length);
+        map->value = BIG_ZERO;
+    }
+#endif
+    big_free(&map->value);
+    map->addr = NULL;
+    map->length = 0;
+}
 
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+int big_write_file(const bigint *X, const char *path) {
+    if (X == NULL || path == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    FILE *f = fopen(path, "wb");
+    if (f == NULL) {
+        return ERR_BIGINT_FILE_IO_ERROR;
+    }
+    size_t n = limb_trimmed_len(X->data, X->num_limbs);
+    bool ok = true;
+#ifdef BIGINT_LITTLE_ENDIAN
+    ok = fwrite(X->data, sizeof(big_uint), n, f) == n;
+#else
+    for (size_t i = 0; i < n && ok; i++) {
+        uint8_t bytes[8];
+        for (int j = 0; j < 8; j++) {
+            bytes[j] = (uint8_t)(X->data[i] >> (8 * j));
+        }
+        ok = fwrite(bytes, 1, 8, f) == 8;
+    }
+#endif
+    if (fclose(f) != 0) {
+        ok = false;
+    }
+    return ok ? 0 : ERR_BIGINT_FILE_IO_ERROR;
+}
 
-    // Tests 0 x 0 
-    big_set_nonzero(&first, 0);
-    big_set_nonzero(&second, 0);
+int cmp_abs(const bigint *x, const bigint *y) {
+    if (x->num_limbs != y->num_limbs) {
+        return (x->num_limbs > y->num_limbs) ? 1 : -1;
+    }
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+    for (size_t i = x->num_limbs; i-- > 0; ) {
+        if (x->data[i] != y->data[i]) {
+            int result = (x->data[i] > y->data[i]) ? 1 : -1;
+            return result;
+        }
+    }
+    return 0;
+}
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+/*
+X = A + B, with B taken to have sign b_sign so big_sub is the same operation
+with B negated. The sum is formed in X's own buffer, which is only grown if
+it is too small. X may alias A or B: each limb of X is written only after
+the limbs of A and B at the same position have been read.
+*/
+int big_add_signed(bigint *X, const bigint *A, const bigint *B, int b_sign) {
+    int a_sign = (A->signum < 0) ? -1 : 1;
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    // Order the operands so that L has the larger magnitude
+    const bigint *L = A;
+    const bigint *S = B;
+    size_t ln = an;
+    size_t sn = bn;
+    int sign = a_sign;
+    if (bn > an || (bn == an && limb_cmp(B->data, A->data, an) > 0)) {
+        L = B;
+        S = A;
+        ln = bn;
+        sn = an;
+        sign = b_sign;
+    }
 
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+    // Reserving first matters when X aliases A or B, their data may move
+    int ret = big_reserve(X, ln + 1);
+    if (ret != 0) {
+        return ret;
+    }
+    // Both are zero, and may have no limbs at all
+    if (ln == 0) {
+        big_normalize(X, 0, 1);
+        return 0;
+    }
+    if (a_sign == b_sign) {
+        X->data[ln] = limb_add(X->data, L->data, ln, S->data, sn);
+        big_normalize(X, ln + 1, sign);
+    }
+    else {
+        limb_sub(X->data, L->data, ln, S->data, sn);
+        big_normalize(X, ln, sign);
+    }
+    return 0;
+}
 
-    // Tests UINTMAX x UINTMAX (1 of them is negative)
-    big_set_nonzero(&first, UINT64_MAX);
-    big_set_nonzero(&second, UINT64_MAX);
+int big_add(bigint *X, const bigint *A, const bigint *B) {
+    if (X == NULL || A == NULL || B == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return big_add_signed(X, A, B, (B->signum < 0) ? -1 : 1);
+}
 
-    first.signum = -1;
+int big_cmp(const bigint *x, const bigint *y) {
+    if (x->signum != y->signum) {
+        if (x->signum > 0) {
+            return 1;
+        }
+        if (y->signum > 0) {
+            return -1;
+        }
+    }
+
+    if (x->num_limbs != y->num_limbs) {
+        if (x->signum > 0) {
+            return (x->num_limbs > y->num_limbs) ? 1 : -1;
+        }
+        else {
+            return (x->num_limbs > y->num_limbs) ? -1 : 1;
+        }
+    }
+
+    for (size_t i = x->num_limbs; i-- > 0; ) {
+        if (x->data[i] != y->data[i]) {
+            int result = (x->data[i] > y->data[i]) ? 1 : -1;
+            return (x->signum > 0) ? result : -result;
+        }
+    }
+    return 0;
+}
+
+int limb_result(const bigint *A, const bigint *B) {
+    return A->num_limbs >= B->num_limbs;
+}
+
+
+int big_sub(bigint *X, const bigint *A, const bigint *B) {
+    if (X == NULL || A == NULL || B == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return big_add_signed(X, A, B, (B->signum < 0) ? 1 : -1);
+}
+
+int big_mul(bigint *X, const bigint *A, const bigint *B) {
+    if (X == NULL || A == NULL || B == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    int sign = ((A->signum < 0) != (B->signum < 0)) ? -1 : 1;
+    big_uint *rp = big_result_buffer(X, A, B, (an + bn > 0) ? an + bn : 1);
+    if (rp == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    if (an == 0 || bn == 0) {
+        big_finish_result(X, rp, 0, 1);
+        return 0;
+    }
+    if (A->data == B->data) {
+        limb_sqr_basecase(rp, A->data, an);
+    }
+    else {
+        limb_mul_basecase(rp, A->data, an, B->data, bn);
+    }
+    big_finish_result(X, rp, an + bn, sign);
+    return 0;
+}
+
+// EXTENSION STARTS HERE
+
+/*
+Operands of at most karatsuba_threshold limbs are multiplied with the
+schoolbook method, operands of at most toom3_threshold limbs with Karatsuba,
+then up to toom4_threshold limbs with Toom-3 and up to toom6h_threshold
+limbs with Toom-4. Larger ones use Toom-6.5 until the FFT takes over. The
+defaults come from the experiments described in the report and from
+bigint_bench tune. On the machine they were measured on, Toom-6.5 already
+beats Toom-4 where Toom-4 starts to beat Toom-3, so the Toom-4 range is
+empty by default; tune opens it on hosts where it pays. The scratch bounds
+below assume that none of these thresholds, squaring included, is under 32
+limbs.
+*/
+#ifndef KARATSUBA_THRESHOLD
+#define KARATSUBA_THRESHOLD 64
+#endif
+size_t karatsuba_threshold = KARATSUBA_THRESHOLD;
+#ifndef TOOM3_THRESHOLD
+#define TOOM3_THRESHOLD 225
+#endif
+size_t toom3_threshold = TOOM3_THRESHOLD;
+#ifndef TOOM4_THRESHOLD
+#define TOOM4_THRESHOLD 1050
+#endif
+size_t toom4_threshold = TOOM4_THRESHOLD;
+#ifndef TOOM6H_THRESHOLD
+#define TOOM6H_THRESHOLD 1050
+#endif
+size_t toom6h_threshold = TOOM6H_THRESHOLD;
+
+/*
+The same switch points for squaring. The schoolbook square forms every
+cross product only once, so it stays ahead of Karatsuba for longer.
+*/
+#ifndef SQR_KARATSUBA_THRESHOLD
+#define SQR_KARATSUBA_THRESHOLD 80
+#endif
+size_t sqr_karatsuba_threshold = SQR_KARATSUBA_THRESHOLD;
+#ifndef SQR_TOOM3_THRESHOLD
+#define SQR_TOOM3_THRESHOLD 240
+#endif
+size_t sqr_toom3_threshold = SQR_TOOM3_THRESHOLD;
+#ifndef SQR_TOOM4_THRESHOLD
+#define SQR_TOOM4_THRESHOLD 1050
+#endif
+size_t sqr_toom4_threshold = SQR_TOOM4_THRESHOLD;
+#ifndef SQR_TOOM6H_THRESHOLD
+#define SQR_TOOM6H_THRESHOLD 1050
+#endif
+size_t sqr_toom6h_threshold = SQR_TOOM6H_THRESHOLD;
+
+#if KARATSUBA_THRESHOLD < 32 || TOOM3_THRESHOLD < 32 || SQR_KARATSUBA_THRESHOLD < 32 || SQR_TOOM3_THRESHOLD < 32
+#error "Karatsuba and Toom-3 thresholds must be at least 32 limbs"
+#endif
+#if TOOM4_THRESHOLD < 32 || TOOM6H_THRESHOLD < 32 || SQR_TOOM4_THRESHOLD < 32 || SQR_TOOM6H_THRESHOLD < 32
+#error "Toom-4 and Toom-6.5 thresholds must be at least 32 limbs"
+#endif
+
+/*
+Upper bounds on the scratch limbs a balanced n-limb multiplication needs for
+its whole recursion tree. Karatsuba takes 4 * ceil(n / 2) limbs per level,
+which adds up to less than 4 * (n + 64). Toom-3 takes 12 * ceil(n / 3) + 12
+limbs per level and its pieces recurse through either method, which stays
+below 7 * n + 256. Toom-4 takes 24 * ceil(n / 4) + 24 limbs per level and
+Toom-6.5 40 * ceil(n / 6) + 40, at most 6.7 * n + 74 between them, and with
+the levels below that stays under 9 * n + 1024. All bounds grow with n, so a
+buffer sized for n limbs also serves every shorter product.
+*/
+size_t karatsuba_scratch_size(size_t n) {
+    return (n <= karatsuba_threshold) ? 0 : 4 * (n + 64);
+}
+
+size_t limb_mul_n_scratch_size(size_t n) {
+    if (n <= toom3_threshold) {
+        return karatsuba_scratch_size(n);
+    }
+    if (n <= toom4_threshold) {
+        return 7 * n + 256;
+    }
+    return 9 * n + 1024;
+}
+
+/*
+The squaring versions only keep one difference or one set of evaluations per
+level, 3 * ceil(n / 2) limbs for Karatsuba, 9 * ceil(n / 3) + 9 for Toom-3,
+19 * ceil(n / 4) + 19 for Toom-4 and 31 * ceil(n / 6) + 31 for Toom-6.5.
+*/
+size_t limb_sqr_n_scratch_size(size_t n) {
+    if (n <= sqr_karatsuba_threshold) {
+        return 0;
+    }
+    if (n <= sqr_toom3_threshold) {
+        return 3 * (n + 64);
+    }
+    if (n <= sqr_toom4_threshold) {
+        return 5 * n + 256;
+    }
+    return 7 * n + 1024;
+}
+
+/*
+Karatsuba multiplication {rp, 2n} = {ap, n} * {bp, n}. The operands are split
+in place at m = ceil(n / 2) limbs, so no piece is ever copied, and the middle
+coefficient is z0 + z2 - (a0 - a1) * (b0 - b1). Using differences instead of
+the sums (a0 + a1) * (b0 + b1) keeps every recursive product at m limbs.
+tp must hold karatsuba_scratch_size(n) limbs.
+*/
+void limb_mul_karatsuba(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp) {
+    if (n <= karatsuba_threshold) {
+        limb_mul_basecase(rp, ap, n, bp, n);
+        return;
+    }
+    size_t m = (n + 1) / 2;
+    size_t h = n - m;
+    big_uint *da = tp;
+    big_uint *db = tp + m;
+    big_uint *zm = tp + 2 * m;
+    big_uint *next = tp + 4 * m;
+    int negative = limb_abs_diff(da, ap, m, ap + m, h) ^ limb_abs_diff(db, bp, m, bp + m, h);
+
+    // z0 and z2 go straight into their final places in rp
+    limb_mul_karatsuba(rp, ap, bp, m, next);
+    limb_mul_karatsuba(rp + 2 * m, ap + m, bp + m, h, next);
+    limb_mul_karatsuba(zm, da, db, m, next);
+
+    // z1 reuses the space of the differences, with its top limb kept in cy
+    big_uint *z1 = tp;
+    big_uint cy = limb_add(z1, rp, 2 * m, rp + 2 * m, 2 * h);
+    if (negative) {
+        cy += limb_add_n(z1, z1, zm, 2 * m);
+    }
+    else {
+        cy -= limb_sub_n(z1, z1, zm, 2 * m);
+    }
+    cy += limb_add_n(rp + m, rp + m, z1, 2 * m);
+    limb_add_1(rp + 3 * m, rp + 3 * m, 2 * n - 3 * m, cy);
+}
+
+/*
+Karatsuba squaring {rp, 2n} = {ap, n}^2. Same split as limb_mul_karatsuba,
+but there is only one difference to form and (a0 - a1)^2 is never negative,
+so the middle coefficient is always z0 + z2 - (a0 - a1)^2. tp must hold
+limb_sqr_n_scratch_size(n) limbs.
+*/
+void limb_sqr_karatsuba(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp) {
+    if (n <= sqr_karatsuba_threshold) {
+        limb_sqr_basecase(rp, ap, n);
+        return;
+    }
+    size_t m = (n + 1) / 2;
+    size_t h = n - m;
+    big_uint *da = tp;
+    big_uint *zm = tp + m;
+    big_uint *next = tp + 3 * m;
+    limb_abs_diff(da, ap, m, ap + m, h);
+
+    limb_sqr_karatsuba(rp, ap, m, next);
+    limb_sqr_karatsuba(rp + 2 * m, ap + m, h, next);
+    limb_sqr_karatsuba(zm, da, m, next);
+
+    // z1 = z0 + z2 - zm overwrites zm, with its top limb kept in cy
+    big_uint cy = -limb_sub_n(zm, rp, zm, 2 * m);
+    cy += limb_add(zm, zm, 2 * m, rp + 2 * m, 2 * h);
+    cy += limb_add_n(rp + m, rp + m, zm, 2 * m);
+    limb_add_1(rp + 3 * m, rp + 3 * m, 2 * n - 3 * m, cy);
+}
+
+typedef void (*limb_mul_n_fn)(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n,
+                              big_uint *tp);
+typedef void (*limb_sqr_n_fn)(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp);
+
+/*
+Shared driver for big_karatsuba and big_toom_cook. Multiplies A and B of
+n limbs each with the balanced method mul, or squares A with sqr if B is A
+itself. Operands of different lengths go through limb_mul instead, whose
+unbalanced methods split each operand at its own length rather than
+zero-extending the shorter one. A and B are never modified, and everything
+the recursion needs comes out of one allocation of scratch_size(n) limbs.
+*/
+int big_mul_balanced(bigint *X, const bigint *A, const bigint *B, size_t an, size_t bn,
+                     limb_mul_n_fn mul, limb_sqr_n_fn sqr, size_t (*scratch_size)(size_t)) {
+    if (an != bn) {
+        return big_mul_with_scratch(X, A, B, NULL);
+    }
+    int sign = ((A->signum < 0) != (B->signum < 0)) ? -1 : 1;
+    size_t n = an;
+    big_uint *tp = (big_uint *)malloc(scratch_size(n) * sizeof(big_uint));
+    if (tp == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    big_uint *rp = big_result_buffer(X, A, B, 2 * n);
+    if (rp == NULL) {
+        free(tp);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    const big_uint *ap = A->data;
+    const big_uint *bp = B->data;
+    if (ap == bp) {
+        sqr(rp, ap, n, tp);
+    }
+    else {
+        mul(rp, ap, bp, n, tp);
+    }
+    free(tp);
+    big_finish_result(X, rp, 2 * n, sign);
+    return 0;
+}
+
+
+/* 
+This function shifts src by limb_shift limbs into bigint result. result may
+be src itself.
+*/
+void big_shift_left(bigint *result, const bigint *src, size_t limb_shift) {
+    size_t n = limb_trimmed_len(src->data, src->num_limbs);
+    int signum = src->signum;
+    if (big_reserve(result, n + limb_shift + 1) != 0) {
+        return;
+    }
+    memmove(result->data + limb_shift, src->data, n * sizeof(big_uint));
+    memset(result->data, 0, limb_shift * sizeof(big_uint));
+    big_normalize(result, n + limb_shift, signum);
+}
+
+/*
+Similar to big_mul, this function multiplies A and B using Karatsuba's logic
+defined in the report. The recursion runs on limb arrays inside a single
+scratch buffer, see limb_mul_karatsuba.
+*/
+int big_karatsuba(bigint *X, const bigint *A, const bigint *B) {
+    if (A == NULL || B == NULL || X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    // Below the threshold big_mul is faster, based on results from the
+    // experiments.
+    if (an <= karatsuba_threshold || bn <= karatsuba_threshold) {
+        return big_mul(X, A, B);
+    }
+    return big_mul_balanced(X, A, B, an, bn, limb_mul_karatsuba, limb_sqr_karatsuba,
+                            karatsuba_scratch_size);
+}
+
+/* 
+This method allows for src to be bit_shifted left by bit_shift bits, allowing
+for easy multiplication by a power of 2. result may be src itself.
+*/
+int big_bit_shift_left(bigint *result, const bigint *src, size_t bit_shift) {
+    size_t n = limb_trimmed_len(src->data, src->num_limbs);
+    size_t limb_shift = bit_shift / 64;
+    int signum = src->signum;
+    int ret = big_reserve(result, n + limb_shift + 1);
+    if (ret != 0) {
+        return ret;
+    }
+    // Handles edge case of 0
+    if (n == 0) {
+        big_normalize(result, 0, 1);
+        return 0;
+    }
+    // Shifting from the top down never overwrites limbs still to be read
+    result->data[n + limb_shift] = limb_lshift(result->data + limb_shift, src->data, n, bit_shift % 64);
+    memset(result->data, 0, limb_shift * sizeof(big_uint));
+    big_normalize(result, n + limb_shift + 1, signum);
+    return 0;
+}
+
+/* 
+This method allows for src to be bit_shifted right by bit_shift bits, allowing
+for easy division by a power of 2. result may be src itself.
+*/
+int big_bit_shift_right(bigint *result, const bigint *src, size_t bit_shift) {
+    size_t n = limb_trimmed_len(src->data, src->num_limbs);
+    size_t limb_shift = bit_shift / 64;
+    int signum = src->signum;
+    int ret = big_reserve(result, 1);
+    if (ret != 0) {
+        return ret;
+    }
+    // Result should be 0 if every limb is shifted out
+    if (n <= limb_shift) {
+        big_normalize(result, 0, 1);
+        return 0;
+    }
+    ret = big_reserve(result, n - limb_shift);
+    if (ret != 0) {
+        return ret;
+    }
+    limb_rshift(result->data, src->data + limb_shift, n - limb_shift, bit_shift % 64);
+    big_normalize(result, n - limb_shift, signum);
+    return 0;
+}
+
+/*
+Divides {ap, n} by the odd limb d when it is known to be a multiple of d,
+Jebelean's exact division. dinv is the inverse of d modulo 2^64, from
+limb_binvert. Each quotient limb is the low limb of what is left times dinv,
+so every division becomes a multiplication, and the high half of q * d is
+what the next limb still owes. Because the result is exact modulo 2^(64n),
+negative two's complement values divide correctly too. rp may alias ap.
+*/
+void limb_divexact_odd(big_uint *rp, const big_uint *ap, size_t n, big_uint d, big_uint dinv) {
+    big_uint borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        big_uint a = ap[i];
+        big_uint t = a - borrow;
+        borrow = a < borrow;
+        big_uint q = t * dinv;
+        rp[i] = q;
+        borrow += (big_uint)(((big_udbl)q * d) >> 64);
+    }
+}
+
+// Exact division by 3 for the Toom-3 interpolation, its inverse is a constant
+void limb_divexact_by3(big_uint *rp, const big_uint *ap, size_t n) {
+    limb_divexact_odd(rp, ap, n, 3, 0xAAAAAAAAAAAAAAABULL);
+}
+
+/*
+Exact division by any nonzero limb d. An even d = d' * 2^k also shifts out
+the k low bits, which a multiple of d has clear, as it divides by d', so
+the shift costs no pass of its own.
+*/
+void limb_divexact_1(big_uint *rp, const big_uint *ap, size_t n, big_uint d) {
+    unsigned shift = __builtin_ctzll(d);
+    if (shift == 0) {
+        limb_divexact_odd(rp, ap, n, d, limb_binvert(d));
+        return;
+    }
+    d >>= shift;
+    big_uint dinv = limb_binvert(d);
+    big_uint borrow = 0;
+    for (size_t i = 0; i < n; i++) {
+        // ap[i + 1] is still unchanged when rp aliases ap
+        big_uint a = ap[i] >> shift;
+        if (i + 1 < n) {
+            a |= ap[i + 1] << (64 - shift);
+        }
+        big_uint t = a - borrow;
+        borrow = a < borrow;
+        big_uint q = t * dinv;
+        rp[i] = q;
+        borrow += (big_uint)(((big_udbl)q * d) >> 64);
+    }
+}
+
+// Halves the two's complement value {rp, n}, which must be even
+void limb_half_signed(big_uint *rp, size_t n) {
+    big_uint sign = rp[n - 1] & ((big_uint)1 << 63);
+    limb_rshift(rp, rp, n, 1);
+    rp[n - 1] |= sign;
+}
+
+/*
+This function evaluates the polynomial a0 + a1 x + a2 x^2 given by the
+3 way split of ap (pieces of m, m and s limbs) at the points Toom-Cook needs
+besides 0 and "inf", which are just a0 and a2. The values at 1, -1 and -2 go
+to consecutive (m + 1)-limb slots of pv, the last two as magnitudes. Bit 0
+of the return value is set if the value at -1 is negative, bit 1 for -2.
+tp needs m + 1 limbs.
+*/
+int evaluate_polynomials(big_uint *pv, const big_uint *ap, size_t m, size_t s, big_uint *tp) {
+    big_uint *p1 = pv;
+    big_uint *p_1 = pv + (m + 1);
+    big_uint *p_2 = pv + 2 * (m + 1);
+    const big_uint *a0 = ap;
+    const big_uint *a1 = ap + m;
+    const big_uint *a2 = ap + 2 * m;
+    int signs = 0;
+
+    // P_1 = A0 + A2 for now, P1 = A0 + A1 + A2
+    p_1[m] = limb_add(p_1, a0, m, a2, s);
+    p1[m] = p_1[m] + limb_add_n(p1, p_1, a1, m);
+    // P_1 = A0 - A1 + A2
+    if (p_1[m] == 0 && limb_cmp(p_1, a1, m) < 0) {
+        limb_sub_n(p_1, a1, p_1, m);
+        signs |= 1;
+    }
+    else {
+        p_1[m] -= limb_sub_n(p_1, p_1, a1, m);
+    }
+
+    // P_2 = A0 - 2*A1 + 4*A2
+    p_2[s] = limb_lshift(p_2, a2, s, 2);
+    memset(p_2 + s + 1, 0, (m - s) * sizeof(big_uint));
+    p_2[m] += limb_add_n(p_2, p_2, a0, m);
+    tp[m] = limb_lshift(tp, a1, m, 1);
+    if (limb_abs_diff(p_2, p_2, m + 1, tp, m + 1)) {
+        signs |= 2;
+    }
+    return signs;
+}
+
+/*
+Solves the system of interpolated points to recover the coefficients of the
+product, following Bodrato's sequence for the points 0, 1, -1, -2 and "inf".
+On entry rp holds R0 in its low 2m limbs and R_inf, inf_n <= 2m limbs, from
+limb 4m on, and R1, R_1, R_2 are (2m + 2)-limb two's complement values. Only
+exact divisions by 2 and 3 are needed. The three middle coefficients are then
+added into rp at their limb offsets, which leaves the full product there.
+*/
+void interpolate_results(big_uint *rp, big_uint *r1, big_uint *r_1, big_uint *r_2, size_t m, size_t inf_n) {
+    size_t len = 2 * m + 2;
+    size_t total = 4 * m + inf_n;
+    const big_uint *r0 = rp;
+    const big_uint *r_inf = rp + 4 * m;
+
+    // r_2 = (R_2 - R1) / 3
+    limb_sub_n(r_2, r_2, r1, len);
+    limb_divexact_by3(r_2, r_2, len);
+    // r1 = (R1 - R_1) / 2
+    limb_sub_n(r1, r1, r_1, len);
+    limb_half_signed(r1, len);
+    // r_1 = R_1 - R0
+    limb_sub(r_1, r_1, len, r0, 2 * m);
+    // r_2 = (r_1 - r_2) / 2 + 2 * R_inf, the x^3 coefficient
+    limb_sub_n(r_2, r_1, r_2, len);
+    limb_half_signed(r_2, len);
+    limb_add(r_2, r_2, len, r_inf, inf_n);
+    limb_add(r_2, r_2, len, r_inf, inf_n);
+    // r_1 = r_1 + r1 - R_inf, the x^2 coefficient
+    limb_add_n(r_1, r_1, r1, len);
+    limb_sub(r_1, r_1, len, r_inf, inf_n);
+    // r1 = r1 - r_2, the x coefficient
+    limb_sub_n(r1, r1, r_2, len);
+
+    // Final Result Calculations, adds each coefficient in at its offset. The
+    // limbs of a coefficient that land past the end of the product are zero.
+    memset(rp + 2 * m, 0, 2 * m * sizeof(big_uint));
+    const big_uint *coeffs[3] = {r1, r_1, r_2};
+    for (size_t k = 1; k <= 3; k++) {
+        size_t offset = k * m;
+        size_t n = (len < total - offset) ? len : total - offset;
+        limb_add(rp + offset, rp + offset, total - offset, coeffs[k - 1], n);
+    }
+}
+
+void limb_mul_n(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp);
+void limb_sqr_n(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp);
+
+/*
+Toom-3 multiplication {rp, 2n} = {ap, n} * {bp, n} for n > toom3_threshold.
+Splits both operands in place into 3 pieces of m = ceil(n / 3) limbs (the
+top one s limbs), multiplies their values at 0, 1, -1, -2 and "inf" through
+limb_mul_n, and interpolates. tp must hold limb_mul_n_scratch_size(n) limbs,
+of which this level takes 12m + 12.
+*/
+void limb_mul_toom3(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp) {
+    size_t m = (n + 2) / 3;
+    size_t s = n - 2 * m;
+    size_t len = 2 * m + 2;
+    big_uint *pa = tp;
+    big_uint *pb = pa + 3 * (m + 1);
+    big_uint *r1 = pb + 3 * (m + 1);
+    big_uint *r_1 = r1 + len;
+    big_uint *r_2 = r_1 + len;
+    big_uint *next = r_2 + len;
+
+    // r1 is free until the products start, so it doubles as evaluation space
+    int signs = evaluate_polynomials(pa, ap, m, s, r1) ^ evaluate_polynomials(pb, bp, m, s, r1);
+
+    // Perform recursive multiplications, R0 and R_inf directly into rp
+    limb_mul_n(r1, pa, pb, m + 1, next);
+    limb_mul_n(r_1, pa + (m + 1), pb + (m + 1), m + 1, next);
+    limb_mul_n(r_2, pa + 2 * (m + 1), pb + 2 * (m + 1), m + 1, next);
+    if (signs & 1) {
+        limb_neg(r_1, r_1, len);
+    }
+    if (signs & 2) {
+        limb_neg(r_2, r_2, len);
+    }
+    limb_mul_n(rp, ap, bp, m, next);
+    limb_mul_n(rp + 4 * m, ap + 2 * m, bp + 2 * m, s, next);
+
+    interpolate_results(rp, r1, r_1, r_2, m, 2 * s);
+}
+
+/*
+Points that Toom-4 and Toom-6.5 evaluate at besides 0 and "inf", as
+homogeneous points (2^ea, 2^eb): 1, 2, 1/2, 4 and 1/4. The value of a
+degree d polynomial at (x, y) is sum c_i x^i y^(d - i), so every weight is a
+power of 2 and every value an integer. A Toom-k product has 2k - 3 of these
+points: the first k - 2 each with its negative, and the next one alone.
+*/
+static const unsigned toom_points[5][2] = {{0, 0}, {1, 0}, {0, 1}, {2, 0}, {0, 2}};
+
+// Weight of the x^i term of a degree d polynomial at the point toom_points[p],
+// as a power of 2
+unsigned toom_shift(size_t p, size_t i, size_t d) {
+    return toom_points[p][0] * i + toom_points[p][1] * (d - i);
+}
+
+/*
+Evaluates the k-way split of ap, pieces of m limbs with the top one s limbs,
+at the points of a Toom-k product. The magnitudes go to consecutive
+(m + 1)-limb slots of pv in the order 1, -1, 2, -2, ... and then the single
+point. Bit p of the return value is set if the value at the negative of
+point p is negative. Each pair is formed from the sums of the even and of the
+odd terms, E + O and E - O. tp needs m + 1 limbs.
+*/
+int evaluate_toom(big_uint *pv, const big_uint *ap, size_t k, size_t m, size_t s, big_uint *tp) {
+    int signs = 0;
+    size_t pairs = k - 2;
+    for (size_t p = 0; p <= pairs; p++) {
+        big_uint *even = pv + 2 * p * (m + 1);
+        big_uint *odd = (p < pairs) ? tp : even;
+        memset(even, 0, (m + 1) * sizeof(big_uint));
+        memset(odd, 0, (m + 1) * sizeof(big_uint));
+        for (size_t i = 0; i < k; i++) {
+            size_t len = (i == k - 1) ? s : m;
+            big_uint *acc = (i % 2) ? odd : even;
+            big_uint cy = limb_addmul_1(acc, ap + i * m, len, (big_uint)1 << toom_shift(p, i, k - 1));
+            limb_add_1(acc + len, acc + len, m + 1 - len, cy);
+        }
+        if (p < pairs) {
+            if (limb_abs_diff(even + (m + 1), even, m + 1, odd, m + 1)) {
+                signs |= 1 << p;
+            }
+            limb_add_n(even, even, odd, m + 1);
+        }
+    }
+    return signs;
+}
+
+/*
+Solutions of the small systems in interpolate_toom, precomputed by exact
+rational elimination. Row j gives the coefficient of x^j of the degree
+2k - 2 product as (sum w_p v_p) / den. For the even j, v_p is the sum of the
+even terms at point p. For the odd j, it is the sum of the odd terms, or what
+is left of the single point. Each row is {den, w_0, w_1, ...}, and rows
+start at j = 1.
+*/
+static const big_sint toom4_rows[5][4] = {
+    {90, -40, 1, 4},
+    {12, 16, -1},
+    {18, 34, -1, -1},
+    {12, -4, 1},
+    {90, -40, 4, 1},
+};
+
+static const big_sint toom6h_rows[9][6] = {
+    {2891700, 91392, -680, -2720, 1, 16},
+    {45360, -21504, 336, 256, -1},
+    {136080, -87360, 674, 2216, -1, -4},
+    {8640, 17664, -324, -64, 1},
+    {32400, 71952, -650, -650, 1, 1},
+    {8640, -5184, 276, 16, -1},
+    {136080, -87360, 2216, 674, -4, -1},
+    {45360, 1344, -84, -4, 1},
+    {2891700, 91392, -2720, -680, 16, 1},
+};
+
+// {rp, len} -= 2^shift * {ap, an} modulo 2^(64 len), for an <= len. tp needs
+// an + 1 limbs.
+void toom_sub_shifted(big_uint *rp, size_t len, const big_uint *ap, size_t an, unsigned shift, big_uint *tp) {
+    if (shift == 0) {
+        limb_sub(rp, rp, len, ap, an);
+        return;
+    }
+    big_uint top = limb_lshift(tp, ap, an, shift);
+    if (an < len) {
+        tp[an++] = top;
+    }
+    limb_sub(rp, rp, len, tp, an);
+}
+
+/*
+Recovers the product of a Toom-k multiplication from the values of its
+degree d = 2k - 2 polynomial. On entry rp holds R0 in its low 2m limbs and
+R_inf, inf_n <= 2m limbs, from limb dm on, and rv holds the values at the
+points in the order evaluate_toom uses, as (2m + 2)-limb two's complement
+values that are overwritten.
+
+Each pair of values at x and -x becomes the sums of the even and of the odd
+terms, (R(x) + R(-x)) / 2 and (R(x) - R(-x)) / 2. With R0 and R_inf taken
+out, the k - 2 even parts determine the even coefficients and the k - 2 odd
+parts plus the single point the odd ones, each coefficient a small linear
+combination with one exact division from the rows tables. The positive and
+the negative terms are summed apart, which needs no subtraction with
+carries per term. The even coefficients are taken out of the single point
+as they are found, and every coefficient is added into rp at its offset as
+soon as it is known. Every step works modulo 2^(64(2m + 2)), which holds all
+true values exactly. tp needs 4m + 4 limbs.
+*/
+void interpolate_toom(big_uint *rp, big_uint *rv, size_t k, size_t m, size_t inf_n, big_uint *tp) {
+    size_t d = 2 * k - 2;
+    size_t len = 2 * m + 2;
+    size_t pairs = k - 2;
+    size_t total = d * m + inf_n;
+    size_t width = (k == 4) ? 4 : 6;
+    const big_sint *rows = (k == 4) ? toom4_rows[0] : toom6h_rows[0];
+    big_uint *single = rv + 2 * pairs * len;
+
+    for (size_t p = 0; p < pairs; p++) {
+        big_uint *even = rv + 2 * p * len;
+        big_uint *odd = even + len;
+        limb_sub_n(odd, even, odd, len);
+        limb_half_signed(odd, len);
+        limb_sub_n(even, even, odd, len);
+        toom_sub_shifted(even, len, rp, 2 * m, toom_shift(p, 0, d), tp);
+        toom_sub_shifted(even, len, rp + d * m, inf_n, toom_shift(p, d, d), tp);
+    }
+    toom_sub_shifted(single, len, rp, 2 * m, toom_shift(pairs, 0, d), tp);
+    toom_sub_shifted(single, len, rp + d * m, inf_n, toom_shift(pairs, d, d), tp);
+
+    // The even coefficients first, then the odd ones
+    memset(rp + 2 * m, 0, (d - 2) * m * sizeof(big_uint));
+    for (size_t first = 2; first >= 1; first--) {
+        for (size_t j = first; j < d; j += 2) {
+            const big_sint *row = rows + (j - 1) * width;
+            big_uint *acc[2] = {tp, tp + len};
+            bool started[2] = {false, false};
+            for (size_t p = 0; p < pairs + (j % 2); p++) {
+                const big_uint *v = (p < pairs) ? rv + (2 * p + j % 2) * len : single;
+                int neg = row[p + 1] < 0;
+                big_uint w = neg ? -row[p + 1] : row[p + 1];
+                if (started[neg]) {
+                    limb_addmul_1(acc[neg], v, len, w);
+                }
+                else {
+                    limb_mul_1(acc[neg], v, len, w);
+                    started[neg] = true;
+                }
+            }
+            if (!started[0]) {
+                memset(tp, 0, len * sizeof(big_uint));
+            }
+            if (started[1]) {
+                limb_sub_n(tp, tp, tp + len, len);
+            }
+            limb_divexact_1(tp, tp, len, row[0]);
+            if (j % 2 == 0) {
+                toom_sub_shifted(single, len, tp, len, toom_shift(pairs, j, d), tp + len);
+            }
+            size_t offset = j * m;
+            size_t n = (len < total - offset) ? len : total - offset;
+            limb_add(rp + offset, rp + offset, total - offset, tp, n);
+        }
+    }
+}
+
+/*
+Toom-k multiplication {rp, 2n} = {ap, n} * {bp, n} for k = 4 or 6, or the
+square of ap if bp is NULL. Splits the operands in place into k pieces of
+m = ceil(n / k) limbs (the top one s limbs, at least 1 for n > 25),
+multiplies their values at 0, "inf" and the 2k - 3 points of toom_points
+through limb_mul_n or limb_sqr_n, and interpolates. tp must hold
+limb_mul_n_scratch_size(n) or limb_sqr_n_scratch_size(n) limbs, of which
+this level takes (2k - 2)(4m + 4) for a product and (6k - 5)(m + 1) for a
+square.
+*/
+void limb_mul_toom(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, size_t k, big_uint *tp) {
+    size_t m = (n + k - 1) / k;
+    size_t s = n - (k - 1) * m;
+    size_t points = 2 * k - 3;
+    size_t len = 2 * m + 2;
+    big_uint *pa = tp;
+    big_uint *pb = (bp != NULL) ? pa + points * (m + 1) : pa;
+    big_uint *rv = pb + points * (m + 1);
+    big_uint *next = rv + points * len;
+
+    // rv is free until the products start, so it doubles as evaluation space
+    int signs = evaluate_toom(pa, ap, k, m, s, rv);
+    if (bp != NULL) {
+        signs ^= evaluate_toom(pb, bp, k, m, s, rv);
+    }
+    for (size_t p = 0; p < points; p++) {
+        if (bp != NULL) {
+            limb_mul_n(rv + p * len, pa + p * (m + 1), pb + p * (m + 1), m + 1, next);
+        }
+        else {
+            limb_sqr_n(rv + p * len, pa + p * (m + 1), m + 1, next);
+        }
+    }
+    // Squares are never negative, only products can be
+    for (size_t p = 0; bp != NULL && p < k - 2; p++) {
+        if (signs & (1 << p)) {
+            limb_neg(rv + (2 * p + 1) * len, rv + (2 * p + 1) * len, len);
+        }
+    }
+    if (bp != NULL) {
+        limb_mul_n(rp, ap, bp, m, next);
+        limb_mul_n(rp + (2 * k - 2) * m, ap + (k - 1) * m, bp + (k - 1) * m, s, next);
+    }
+    else {
+        limb_sqr_n(rp, ap, m, next);
+        limb_sqr_n(rp + (2 * k - 2) * m, ap + (k - 1) * m, s, next);
+    }
+
+    interpolate_toom(rp, rv, k, m, 2 * s, next);
+}
+
+/*
+Toom-4 multiplication {rp, 2n} = {ap, n} * {bp, n} for n > toom4_threshold,
+with 7 points: 0, 1, -1, 2, -2, 1/2 and "inf".
+*/
+void limb_mul_toom4(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp) {
+    limb_mul_toom(rp, ap, bp, n, 4, tp);
+}
+
+/*
+Toom-6.5 multiplication {rp, 2n} = {ap, n} * {bp, n} for n > toom6h_threshold,
+6 pieces and 11 points: 0, +-1, +-2, +-1/2, +-4, 1/4 and "inf". Named like
+GMP's, whose point set also takes a 7-piece operand, the half.
+*/
+void limb_mul_toom6h(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp) {
+    limb_mul_toom(rp, ap, bp, n, 6, tp);
+}
+
+/*
+Balanced multiplication {rp, 2n} = {ap, n} * {bp, n}, picking schoolbook,
+Karatsuba, Toom-3, Toom-4 or Toom-6.5 by size at every level of the
+recursion. tp must hold
+limb_mul_n_scratch_size(n) limbs and rp may not overlap the inputs.
+*/
+void limb_mul_n(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp) {
+    if (n <= karatsuba_threshold) {
+        limb_mul_basecase(rp, ap, n, bp, n);
+    }
+    else if (n <= toom3_threshold) {
+        limb_mul_karatsuba(rp, ap, bp, n, tp);
+    }
+    else if (n <= toom4_threshold) {
+        limb_mul_toom3(rp, ap, bp, n, tp);
+    }
+    else if (n <= toom6h_threshold) {
+        limb_mul_toom4(rp, ap, bp, n, tp);
+    }
+    else {
+        limb_mul_toom6h(rp, ap, bp, n, tp);
+    }
+}
+
+/*
+Toom-3 squaring {rp, 2n} = {ap, n}^2 for n >= 3. A single evaluation pass
+serves both factors, and the five pointwise squares are never negative, so
+the signs evaluate_polynomials reports do not matter. tp must hold
+limb_sqr_n_scratch_size(n) limbs, of which this level takes 9m + 9.
+*/
+void limb_sqr_toom3(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp) {
+    size_t m = (n + 2) / 3;
+    size_t s = n - 2 * m;
+    size_t len = 2 * m + 2;
+    big_uint *pa = tp;
+    big_uint *r1 = pa + 3 * (m + 1);
+    big_uint *r_1 = r1 + len;
+    big_uint *r_2 = r_1 + len;
+    big_uint *next = r_2 + len;
+
+    evaluate_polynomials(pa, ap, m, s, r1);
+    limb_sqr_n(r1, pa, m + 1, next);
+    limb_sqr_n(r_1, pa + (m + 1), m + 1, next);
+    limb_sqr_n(r_2, pa + 2 * (m + 1), m + 1, next);
+    limb_sqr_n(rp, ap, m, next);
+    limb_sqr_n(rp + 4 * m, ap + 2 * m, s, next);
+
+    interpolate_results(rp, r1, r_1, r_2, m, 2 * s);
+}
+
+// Toom-4 squaring {rp, 2n} = {ap, n}^2 for n > sqr_toom4_threshold
+void limb_sqr_toom4(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp) {
+    limb_mul_toom(rp, ap, NULL, n, 4, tp);
+}
+
+// Toom-6.5 squaring {rp, 2n} = {ap, n}^2 for n > sqr_toom6h_threshold
+void limb_sqr_toom6h(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp) {
+    limb_mul_toom(rp, ap, NULL, n, 6, tp);
+}
+
+/*
+Balanced squaring {rp, 2n} = {ap, n}^2, the counterpart of limb_mul_n with
+the sqr_ thresholds. tp must hold limb_sqr_n_scratch_size(n) limbs.
+*/
+void limb_sqr_n(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp) {
+    if (n <= sqr_karatsuba_threshold) {
+        limb_sqr_basecase(rp, ap, n);
+    }
+    else if (n <= sqr_toom3_threshold) {
+        limb_sqr_karatsuba(rp, ap, n, tp);
+    }
+    else if (n <= sqr_toom4_threshold) {
+        limb_sqr_toom3(rp, ap, n, tp);
+    }
+    else if (n <= sqr_toom6h_threshold) {
+        limb_sqr_toom4(rp, ap, n, tp);
+    }
+    else {
+        limb_sqr_toom6h(rp, ap, n, tp);
+    }
+}
+
+/*
+Calculates the product of A and B and puts it into X, correctly splits A and B
+into 3 equal pieces, recursively evaluates the polynomials, and then interpolates
+the results back into X. Described in the report. A and B are left untouched,
+and the whole recursion works out of one scratch buffer allocated up front.
+*/
+int big_toom_cook(bigint *X, const bigint *A, const bigint *B) {
+    if (A == NULL || B == NULL || X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    // Base case for small numbers, use big_mul
+    if (an <= toom3_threshold || bn <= toom3_threshold) {
+        return big_mul(X, A, B);
+    }
+    return big_mul_balanced(X, A, B, an, bn, limb_mul_toom3, limb_sqr_toom3, limb_mul_n_scratch_size);
+}
+
+/*
+Like big_toom_cook with a 4 way split at the top level. Operands too short
+for it to pay off go through big_toom_cook.
+*/
+int big_toom4(bigint *X, const bigint *A, const bigint *B) {
+    if (A == NULL || B == NULL || X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    if (an <= toom4_threshold || bn <= toom4_threshold) {
+        return big_toom_cook(X, A, B);
+    }
+    return big_mul_balanced(X, A, B, an, bn, limb_mul_toom4, limb_sqr_toom4, limb_mul_n_scratch_size);
+}
+
+/*
+Like big_toom_cook with a 6 way split at the top level. Operands too short
+for it to pay off go through big_toom4.
+*/
+int big_toom6h(bigint *X, const bigint *A, const bigint *B) {
+    if (A == NULL || B == NULL || X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    if (an <= toom6h_threshold || bn <= toom6h_threshold) {
+        return big_toom4(X, A, B);
+    }
+    return big_mul_balanced(X, A, B, an, bn, limb_mul_toom6h, limb_sqr_toom6h, limb_mul_n_scratch_size);
+}
+
+// FFT MULTIPLICATION STARTS HERE
+
+/*
+Products where both operands have at least this many limbs go through
+big_mul_fft instead of the Toom methods in big_mul_auto. With Toom-6.5 in
+place the transform only wins from around 450000 limbs.
+*/
+#ifndef FFT_MUL_THRESHOLD
+#define FFT_MUL_THRESHOLD 450000
+#endif
+size_t fft_mul_threshold = FFT_MUL_THRESHOLD;
+
+/*
+The three primes used by the number-theoretic transform, each of the form
+k * 2^s + 1 with s >= 55 so transforms of up to 2^55 points exist, along with
+a primitive root of each. Every prime lies between 2^62 and 2^63, so their
+product exceeds 2^186. A coefficient of the product of two limb vectors is
+below 2^128 * (number of limbs), so it can be recovered exactly from its three
+residues with the Chinese remainder theorem.
+*/
+#define NTT_NUM_PRIMES 3
+const big_uint ntt_primes[NTT_NUM_PRIMES] = {
+    0x5700000000000001, /* 87 * 2^56 + 1 */
+    0x4180000000000001, /* 131 * 2^55 + 1 */
+    0x6280000000000001  /* 197 * 2^55 + 1 */
+};
+const big_uint ntt_generators[NTT_NUM_PRIMES] = {5, 3, 3};
+
+/*
+Arithmetic modulo one NTT prime p. Multiplication uses Montgomery's
+reduction with R = 2^64, so ntt_mul(a, b) returns a * b / R mod p. Keeping
+the twiddle factors in Montgomery form (w * R mod p) means multiplying a plain
+residue by one gives back a plain residue, with no division anywhere.
+*/
+typedef struct {
+    big_uint p;       /*!< the prime                        */
+    big_uint pinv;    /*!< -p^-1 mod 2^64                   */
+    big_uint r2;      /*!< R^2 mod p, to convert into form  */
+} ntt_modulus;
+
+big_uint ntt_mul(big_uint a, big_uint b, const ntt_modulus *mod) {
+    big_udbl t = (big_udbl)a * b;
+    big_uint m = (big_uint)t * mod->pinv;
+    big_uint r = (big_uint)((t + (big_udbl)m * mod->p) >> 64);
+    return (r >= mod->p) ? r - mod->p : r;
+}
+
+big_uint ntt_add(big_uint a, big_uint b, const ntt_modulus *mod) {
+    big_uint r = a + b;
+    return (r >= mod->p) ? r - mod->p : r;
+}
+
+big_uint ntt_sub(big_uint a, big_uint b, const ntt_modulus *mod) {
+    return (a >= b) ? a - b : a + mod->p - b;
+}
+
+// Converts a plain residue into Montgomery form
+big_uint ntt_to_mont(big_uint a, const ntt_modulus *mod) {
+    return ntt_mul(a, mod->r2, mod);
+}
+
+// base^e for a base in Montgomery form, result in Montgomery form
+big_uint ntt_pow(big_uint base, big_uint e, const ntt_modulus *mod) {
+    big_uint result = ntt_to_mont(1, mod);
+    while (e != 0) {
+        if (e & 1) {
+            result = ntt_mul(result, base, mod);
+        }
+        base = ntt_mul(base, base, mod);
+        e >>= 1;
+    }
+    return result;
+}
+
+void ntt_modulus_init(ntt_modulus *mod, big_uint p) {
+    mod->p = p;
+    mod->pinv = -limb_binvert(p);
+    big_uint r = (big_uint)(((big_udbl)1 << 64) % p);
+    mod->r2 = (big_uint)(((big_udbl)r * r) % p);
+}
+
+/*
+Fills roots[len + j] (for every power of two len < size, 0 <= j < len) with
+w^j, where w is a primitive (2 * len)-th root of unity, in Montgomery form.
+The inverse roots are stored the same way in iroots.
+*/
+void ntt_build_roots(big_uint *roots, big_uint *iroots, size_t size, big_uint g,
+                     const ntt_modulus *mod) {
+    big_uint one = ntt_to_mont(1, mod);
+    big_uint g_mont = ntt_to_mont(g, mod);
+    for (size_t len = 1; len < size; len <<= 1) {
+        big_uint w = ntt_pow(g_mont, (mod->p - 1) / (2 * len), mod);
+        // w^-1 = w^(2 * len - 1)
+        big_uint w_inv = ntt_pow(w, 2 * len - 1, mod);
+        roots[len] = one;
+        iroots[len] = one;
+        for (size_t j = 1; j < len; j++) {
+            roots[len + j] = ntt_mul(roots[len + j - 1], w, mod);
+            iroots[len + j] = ntt_mul(iroots[len + j - 1], w_inv, mod);
+        }
+    }
+}
+
+/*
+Forward transform (decimation in frequency). Takes a in natural order and
+leaves it in bit-reversed order, which is all the pointwise product needs.
+*/
+void ntt_forward(big_uint *a, size_t size, const big_uint *roots, const ntt_modulus *mod) {
+    for (size_t len = size / 2; len >= 1; len >>= 1) {
+        for (size_t i = 0; i < size; i += 2 * len) {
+            for (size_t j = 0; j < len; j++) {
+                big_uint u = a[i + j];
+                big_uint v = a[i + j + len];
+                a[i + j] = ntt_add(u, v, mod);
+                a[i + j + len] = ntt_mul(ntt_sub(u, v, mod), roots[len + j], mod);
+            }
+        }
+    }
+}
+
+/*
+Inverse transform (decimation in time), taking bit-reversed input back to
+natural order. The result still has to be scaled by 1 / size.
+*/
+void ntt_inverse(big_uint *a, size_t size, const big_uint *iroots, const ntt_modulus *mod) {
+    for (size_t len = 1; len < size; len <<= 1) {
+        for (size_t i = 0; i < size; i += 2 * len) {
+            for (size_t j = 0; j < len; j++) {
+                big_uint u = a[i + j];
+                big_uint v = ntt_mul(a[i + j + len], iroots[len + j], mod);
+                a[i + j] = ntt_add(u, v, mod);
+                a[i + j + len] = ntt_sub(u, v, mod);
+            }
+        }
+    }
+}
+
+/*
+Computes the cyclic convolution of {ap, an} and {bp, bn} modulo one prime,
+writing the an + bn - 1 coefficients to out. fa, fb, roots and iroots are
+scratch buffers of size entries each, size being a power of two that is at
+least an + bn - 1. Squaring (ap == bp) only transforms once.
+*/
+void ntt_convolution(big_uint *out, const big_uint *ap, size_t an, const big_uint *bp, size_t bn,
+                     size_t size, int prime, big_uint *fa, big_uint *fb,
+                     big_uint *roots, big_uint *iroots) {
+    ntt_modulus mod;
+    ntt_modulus_init(&mod, ntt_primes[prime]);
+    ntt_build_roots(roots, iroots, size, ntt_generators[prime], &mod);
+    bool square = (ap == bp && an == bn);
+
+    for (size_t i = 0; i < size; i++) {
+        fa[i] = (i < an) ? ap[i] % mod.p : 0;
+    }
+    ntt_forward(fa, size, roots, &mod);
+    if (!square) {
+        for (size_t i = 0; i < size; i++) {
+            fb[i] = (i < bn) ? bp[i] % mod.p : 0;
+        }
+        ntt_forward(fb, size, roots, &mod);
+    }
+    else {
+        fb = fa;
+    }
+
+    // Each pointwise product picks up a factor 1 / R, so the final
+    // Montgomery multiplication by R^2 / size both undoes it and divides by
+    // size. Fermat's little theorem gives the inverse of size.
+    big_uint scale = ntt_pow(ntt_to_mont(size, &mod), mod.p - 2, &mod);
+    scale = ntt_mul(scale, mod.r2, &mod);
+    for (size_t i = 0; i < size; i++) {
+        fa[i] = ntt_mul(fa[i], fb[i], &mod);
+    }
+    ntt_inverse(fa, size, iroots, &mod);
+    for (size_t i = 0; i < an + bn - 1; i++) {
+        out[i] = ntt_mul(fa[i], scale, &mod);
+    }
+}
+
+// Transform length for an an-by-bn limb product
+size_t ntt_size(size_t an, size_t bn) {
+    size_t size = 1;
+    while (size < an + bn - 1) {
+        size <<= 1;
+    }
+    return size;
+}
+
+// Scratch limbs limb_mul_fft needs: two transforms, the root tables and the
+// residues of every coefficient
+size_t fft_scratch_size(size_t an, size_t bn) {
+    return 4 * ntt_size(an, bn) + NTT_NUM_PRIMES * (an + bn - 1);
+}
+
+/*
+Computes {rp, an + bn} = {ap, an} * {bp, bn} using three NTTs (one per
+prime), then rebuilds every coefficient from its residues with Garner's
+form of the Chinese remainder theorem and adds it in at its limb position.
+tp must hold fft_scratch_size(an, bn) limbs.
+*/
+void limb_mul_fft(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn,
+                  big_uint *tp) {
+    size_t coeffs = an + bn - 1;
+    size_t size = ntt_size(an, bn);
+    big_uint *fa = tp;
+    big_uint *fb = fa + size;
+    big_uint *roots = fb + size;
+    big_uint *iroots = roots + size;
+    big_uint *residues[NTT_NUM_PRIMES];
+    for (int k = 0; k < NTT_NUM_PRIMES; k++) {
+        residues[k] = iroots + size + k * coeffs;
+        ntt_convolution(residues[k], ap, an, bp, bn, size, k, fa, fb, roots, iroots);
+    }
+
+    ntt_modulus m2, m3;
+    ntt_modulus_init(&m2, ntt_primes[1]);
+    ntt_modulus_init(&m3, ntt_primes[2]);
+    big_uint p1 = ntt_primes[0];
+    big_uint p2 = ntt_primes[1];
+    // Garner constants in Montgomery form: p1^-1 mod p2, p1 mod p3 and
+    // (p1 * p2)^-1 mod p3
+    big_uint inv_p1_m2 = ntt_pow(ntt_to_mont(p1 % p2, &m2), p2 - 2, &m2);
+    big_uint p1_m3 = ntt_to_mont(p1 % m3.p, &m3);
+    big_uint p1p2_m3 = ntt_mul(p1_m3, ntt_to_mont(p2 % m3.p, &m3), &m3);
+    big_uint inv_p1p2_m3 = ntt_pow(p1p2_m3, m3.p - 2, &m3);
+
+    // acc holds the pending carry into the next limb, up to three limbs
+    big_uint acc0 = 0, acc1 = 0, acc2 = 0;
+    for (size_t i = 0; i < an + bn; i++) {
+        if (i < coeffs) {
+            big_uint x1 = residues[0][i];
+            big_uint x1_m2 = (x1 >= p2) ? x1 - p2 : x1;
+            big_uint x2 = ntt_mul(ntt_sub(residues[1][i], x1_m2, &m2), inv_p1_m2, &m2);
+            big_uint x1_m3 = x1 % m3.p;
+            big_uint t = ntt_sub(residues[2][i], x1_m3, &m3);
+            t = ntt_sub(t, ntt_mul(x2, p1_m3, &m3), &m3);
+            big_uint x3 = ntt_mul(t, inv_p1p2_m3, &m3);
+
+            // value = x1 + x2 * p1 + x3 * p1 * p2, as three limbs
+            big_udbl v = (big_udbl)x2 * p1 + x1;
+            big_uint v0 = (big_uint)v;
+            big_uint v1 = (big_uint)(v >> 64);
+            big_udbl p1p2 = (big_udbl)p1 * p2;
+            big_udbl lo = (big_udbl)x3 * (big_uint)p1p2;
+            big_udbl hi = (big_udbl)x3 * (big_uint)(p1p2 >> 64);
+            big_udbl s = (big_udbl)v0 + (big_uint)lo;
+            v0 = (big_uint)s;
+            s = (s >> 64) + (big_udbl)v1 + (big_uint)(lo >> 64) + (big_uint)hi;
+            v1 = (big_uint)s;
+            big_uint v2 = (big_uint)(s >> 64) + (big_uint)(hi >> 64);
+
+            s = (big_udbl)acc0 + v0;
+            acc0 = (big_uint)s;
+            s = (s >> 64) + (big_udbl)acc1 + v1;
+            acc1 = (big_uint)s;
+            acc2 += (big_uint)(s >> 64) + v2;
+        }
+        rp[i] = acc0;
+        acc0 = acc1;
+        acc1 = acc2;
+        acc2 = 0;
+    }
+}
+
+/*
+Multiplies A and B with the number-theoretic transform above, which runs in
+O(n log n) instead of big_toom_cook's O(n^1.47). Pays off only for very large
+operands, see fft_mul_threshold.
+*/
+int big_mul_fft(bigint *X, const bigint *A, const bigint *B) {
+    if (A == NULL || B == NULL || X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    int sign = ((A->signum < 0) != (B->signum < 0)) ? -1 : 1;
+    big_uint *tp = NULL;
+    if (an > 0 && bn > 0) {
+        tp = (big_uint *)malloc(fft_scratch_size(an, bn) * sizeof(big_uint));
+        if (tp == NULL) {
+            return ERR_BIGINT_ALLOC_FAILED;
+        }
+    }
+    big_uint *rp = big_result_buffer(X, A, B, (an + bn > 0) ? an + bn : 1);
+    if (rp == NULL) {
+        free(tp);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    if (an == 0 || bn == 0) {
+        big_finish_result(X, rp, 0, 1);
+        return 0;
+    }
+    limb_mul_fft(rp, A->data, an, B->data, bn, tp);
+    free(tp);
+    big_finish_result(X, rp, an + bn, sign);
+    return 0;
+}
+
+/*
+Number of scratch limbs limb_mul needs for an an-by-bn limb product, see
+bigint.h. The bound covers every path limb_mul may take for any shape up to
+an by bn limbs, so one buffer can be sized for the largest product a caller
+will ever form. 12an + 1024 covers the balanced methods as well as each
+unbalanced level plus the recursion below it: Toom-2.5 takes 9m + 9 with
+m <= an / 2 + 1, Toom-4x2 12m + 12 with m <= 2an / 7 + 1, and the chunks 2bn
+with bn <= an / 3, or next to one balanced product when the remainder is
+under bn / 16 limbs.
+*/
+size_t big_mul_scratch_size(size_t an, size_t bn) {
+    if (an < bn) {
+        size_t t = an;
+        an = bn;
+        bn = t;
+    }
+    // Equal operands may be squared instead, see limb_sqr
+    size_t limbs = limb_sqr_n_scratch_size(bn);
+    if (bn > karatsuba_threshold && 12 * an + 1024 > limbs) {
+        limbs = 12 * an + 1024;
+    }
+    if (bn >= fft_mul_threshold && fft_scratch_size(an, bn) > limbs) {
+        limbs = fft_scratch_size(an, bn);
+    }
+    return limbs;
+}
+
+/*
+Computes {rp, 2n} = {ap, n}^2 with the squaring versions of every method,
+the FFT included, which only transforms ap once. tp must hold
+big_mul_scratch_size(n, n) limbs and rp may not overlap ap.
+*/
+void limb_sqr(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp) {
+    if (n >= fft_mul_threshold) {
+        limb_mul_fft(rp, ap, n, ap, n, tp);
+    }
+    else {
+        limb_sqr_n(rp, ap, n, tp);
+    }
+}
+
+void limb_mul(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn, big_uint *tp);
+
+/*
+Evaluates b0 + b1 x, the 2 way split of bp into pieces of m and t <= m limbs,
+at 1, -1 and, if points is 3, at -2. The values go to consecutive (m + 1)-limb
+slots of pv with the same sign bits as evaluate_polynomials. tp needs m + 1
+limbs.
+*/
+int evaluate_linear(big_uint *pv, const big_uint *bp, size_t m, size_t t, int points, big_uint *tp) {
+    big_uint *p1 = pv;
+    big_uint *p_1 = pv + (m + 1);
+    big_uint *p_2 = pv + 2 * (m + 1);
+    const big_uint *b0 = bp;
+    const big_uint *b1 = bp + m;
+    int signs = 0;
+
+    p1[m] = limb_add(p1, b0, m, b1, t);
+    p_1[m] = 0;
+    if (limb_abs_diff(p_1, b0, m, b1, t)) {
+        signs |= 1;
+    }
+    if (points == 3) {
+        // P_2 = B0 - 2*B1
+        memcpy(p_2, b0, m * sizeof(big_uint));
+        p_2[m] = 0;
+        tp[t] = limb_lshift(tp, b1, t, 1);
+        memset(tp + t + 1, 0, (m - t) * sizeof(big_uint));
+        if (limb_abs_diff(p_2, p_2, m + 1, tp, m + 1)) {
+            signs |= 2;
+        }
+    }
+    return signs;
+}
+
+/*
+Evaluates a0 + a1 x + a2 x^2 + a3 x^3, the 4 way split of ap into pieces of
+m, m, m and s <= m limbs, at 1, -1 and -2, laid out like evaluate_polynomials.
+The even and odd halves are formed once and shared by the points 1 and -1.
+tp needs m + 1 limbs.
+*/
+int evaluate_4way(big_uint *pv, const big_uint *ap, size_t m, size_t s, big_uint *tp) {
+    big_uint *p1 = pv;
+    big_uint *p_1 = pv + (m + 1);
+    big_uint *p_2 = pv + 2 * (m + 1);
+    const big_uint *a0 = ap;
+    const big_uint *a1 = ap + m;
+    const big_uint *a2 = ap + 2 * m;
+    const big_uint *a3 = ap + 3 * m;
+    int signs = 0;
+
+    // P_1 = A0 + A2 and tp = A1 + A3 for now, then P1 is their sum and P_1
+    // their difference
+    p_1[m] = limb_add_n(p_1, a0, a2, m);
+    tp[m] = limb_add(tp, a1, m, a3, s);
+    limb_add_n(p1, p_1, tp, m + 1);
+    if (limb_abs_diff(p_1, p_1, m + 1, tp, m + 1)) {
+        signs |= 1;
+    }
+
+    // P_2 = (A0 + 4*A2) - 2*(A1 + 4*A3)
+    p_2[m] = limb_lshift(p_2, a2, m, 2);
+    p_2[m] += limb_add_n(p_2, p_2, a0, m);
+    tp[s] = limb_lshift(tp, a3, s, 2);
+    memset(tp + s + 1, 0, (m - s) * sizeof(big_uint));
+    tp[m] += limb_add_n(tp, tp, a1, m);
+    limb_lshift(tp, tp, m + 1, 1);
+    if (limb_abs_diff(p_2, p_2, m + 1, tp, m + 1)) {
+        signs |= 2;
+    }
+    return signs;
+}
+
+/*
+Toom-2.5 multiplication {rp, an + bn} = {ap, an} * {bp, bn} for
+17bn / 16 <= an < 7bn / 4. Splits ap into 3 pieces and bp into 2, both of
+m = max(ceil(an / 3), ceil(bn / 2)) limbs except the top ones of s and t
+limbs, so neither operand is padded and the product of the two top pieces
+keeps its real s * t size. The degree 3 product only needs the points 0, 1,
+-1 and "inf", and the interpolation is just a half sum and a half difference.
+tp must hold big_mul_scratch_size(an, bn) limbs, of which
+this level takes 9m + 9.
+*/
+void limb_mul_toom32(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn,
+                     big_uint *tp) {
+    size_t m = (an + 2) / 3;
+    if (m < (bn + 1) / 2) {
+        m = (bn + 1) / 2;
+    }
+    size_t s = an - 2 * m;
+    size_t t = bn - m;
+    size_t len = 2 * m + 2;
+    size_t total = an + bn;
+    big_uint *pa = tp;
+    big_uint *pb = pa + 3 * (m + 1);
+    big_uint *r1 = pb + 2 * (m + 1);
+    big_uint *r_1 = r1 + len;
+    big_uint *next = r_1 + len;
+
+    // evaluate_polynomials also fills in the point -2, which goes unused
+    int signs = evaluate_polynomials(pa, ap, m, s, r1) ^ evaluate_linear(pb, bp, m, t, 2, r1);
+    limb_mul(r1, pa, m + 1, pb, m + 1, next);
+    limb_mul(r_1, pa + (m + 1), m + 1, pb + (m + 1), m + 1, next);
+    if (signs & 1) {
+        limb_neg(r_1, r_1, len);
+    }
+    limb_mul(rp, ap, m, bp, m, next);
+    limb_mul(rp + 3 * m, ap + 2 * m, s, bp + m, t, next);
+
+    // r_1 = (R1 + R_1) / 2 - R0, the x^2 coefficient, and
+    // r1 = (R1 - R_1) / 2 - R_inf, the x coefficient
+    limb_add_n(r_1, r1, r_1, len);
+    limb_half_signed(r_1, len);
+    limb_sub_n(r1, r1, r_1, len);
+    limb_sub(r_1, r_1, len, rp, 2 * m);
+    limb_sub(r1, r1, len, rp + 3 * m, s + t);
+
+    memset(rp + 2 * m, 0, m * sizeof(big_uint));
+    const big_uint *coeffs[2] = {r1, r_1};
+    for (size_t k = 1; k <= 2; k++) {
+        size_t offset = k * m;
+        size_t n = (len < total - offset) ? len : total - offset;
+        limb_add(rp + offset, rp + offset, total - offset, coeffs[k - 1], n);
+    }
+}
+
+/*
+Toom-4x2 multiplication {rp, an + bn} = {ap, an} * {bp, bn} for
+7bn / 4 <= an < 3bn. Splits ap into 4 pieces and bp into 2 of
+m = max(ceil(an / 4), ceil(bn / 2)) limbs, the top ones s and t limbs. The
+product has degree 4 like Toom-3, so it uses the same points and
+interpolate_results. tp must hold big_mul_scratch_size(an, bn) limbs, of
+which this level takes 12m + 12.
+*/
+void limb_mul_toom42(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn,
+                     big_uint *tp) {
+    size_t m = (an + 3) / 4;
+    if (m < (bn + 1) / 2) {
+        m = (bn + 1) / 2;
+    }
+    size_t s = an - 3 * m;
+    size_t t = bn - m;
+    size_t len = 2 * m + 2;
+    big_uint *pa = tp;
+    big_uint *pb = pa + 3 * (m + 1);
+    big_uint *r1 = pb + 3 * (m + 1);
+    big_uint *r_1 = r1 + len;
+    big_uint *r_2 = r_1 + len;
+    big_uint *next = r_2 + len;
+
+    int signs = evaluate_4way(pa, ap, m, s, r1) ^ evaluate_linear(pb, bp, m, t, 3, r1);
+    limb_mul(r1, pa, m + 1, pb, m + 1, next);
+    limb_mul(r_1, pa + (m + 1), m + 1, pb + (m + 1), m + 1, next);
+    limb_mul(r_2, pa + 2 * (m + 1), m + 1, pb + 2 * (m + 1), m + 1, next);
+    if (signs & 1) {
+        limb_neg(r_1, r_1, len);
+    }
+    if (signs & 2) {
+        limb_neg(r_2, r_2, len);
+    }
+    limb_mul(rp, ap, m, bp, m, next);
+    limb_mul(rp + 4 * m, ap + 3 * m, s, bp + m, t, next);
+
+    interpolate_results(rp, r1, r_1, r_2, m, s + t);
+}
+
+/*
+Multiplies {ap, an} by the shorter {bp, bn} by slicing ap into chunks of bn
+limbs. Every chunk is a balanced product, added into rp at the chunk's
+offset, and the last partial chunk goes back through limb_mul as a product
+of its own shape. tp must hold big_mul_scratch_size(an, bn) limbs, of which
+this level takes 2bn.
+*/
+void limb_mul_chunked(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn,
+                      big_uint *tp) {
+    big_uint *prod = tp;
+    big_uint *next = tp + 2 * bn;
+    limb_mul(rp, ap, bn, bp, bn, next);
+    for (size_t done = bn; done < an; ) {
+        size_t len = (an - done < bn) ? an - done : bn;
+        limb_mul(prod, ap + done, len, bp, bn, next);
+        // The low bn limbs overlap the top of what is already in rp
+        big_uint cy = limb_add_n(rp + done, rp + done, prod, bn);
+        limb_add_1(rp + done + bn, prod + bn, len, cy);
+        done += len;
+    }
+}
+
+/*
+Computes {rp, an + bn} = {ap, an} * {bp, bn} for an, bn >= 1, picking the
+algorithm from the shorter length: schoolbook, then Karatsuba and Toom-3,
+and finally the FFT. Equal operands are squared with limb_sqr, and operands
+of different lengths use the unbalanced Toom variants or chunks of the
+shorter length, so nothing is ever zero-extended. tp must hold
+big_mul_scratch_size(an, bn) limbs and rp may not overlap the inputs.
+*/
+void limb_mul(big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp, size_t bn, big_uint *tp) {
+    if (ap == bp && an == bn) {
+        limb_sqr(rp, ap, an, tp);
+        return;
+    }
+    if (an < bn) {
+        const big_uint *t = ap;
+        ap = bp;
+        bp = t;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    if (bn <= karatsuba_threshold) {
+        limb_mul_basecase(rp, ap, an, bp, bn);
+    }
+    else if (bn >= fft_mul_threshold) {
+        limb_mul_fft(rp, ap, an, bp, bn, tp);
+    }
+    else if (an == bn) {
+        limb_mul_n(rp, ap, bp, an, tp);
+    }
+    else if (an >= 3 * bn) {
+        limb_mul_chunked(rp, ap, an, bp, bn, tp);
+    }
+    else if (4 * an >= 7 * bn) {
+        limb_mul_toom42(rp, ap, an, bp, bn, tp);
+    }
+    else if (16 * an >= 17 * bn) {
+        limb_mul_toom32(rp, ap, an, bp, bn, tp);
+    }
+    else {
+        // Nearly balanced, one balanced product and a thin remainder beat
+        // splitting both operands again
+        limb_mul_chunked(rp, ap, an, bp, bn, tp);
+    }
+}
+
+/*
+Multiplies A and B with limb_mul, taking its scratch space from the caller's
+buffer of big_mul_scratch_size limbs, or allocating it once here if scratch
+is NULL. Either way the recursion makes no further allocations, and with a
+caller buffer and an X that is large enough and not aliased, none at all.
+*/
+int big_mul_with_scratch(bigint *X, const bigint *A, const bigint *B, big_uint *scratch) {
+    if (A == NULL || B == NULL || X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    int sign = ((A->signum < 0) != (B->signum < 0)) ? -1 : 1;
+    big_uint *tp = scratch;
+    size_t scratch_limbs = big_mul_scratch_size(an, bn);
+    if (tp == NULL && scratch_limbs > 0) {
+        tp = (big_uint *)malloc(scratch_limbs * sizeof(big_uint));
+        if (tp == NULL) {
+            return ERR_BIGINT_ALLOC_FAILED;
+        }
+    }
+    big_uint *rp = big_result_buffer(X, A, B, (an + bn > 0) ? an + bn : 1);
+    if (rp == NULL) {
+        if (tp != scratch) {
+            free(tp);
+        }
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    size_t rn = (an > 0 && bn > 0) ? an + bn : 0;
+    if (rn > 0) {
+        limb_mul(rp, A->data, an, B->data, bn, tp);
+    }
+    if (tp != scratch) {
+        free(tp);
+    }
+    big_finish_result(X, rp, rn, sign);
+    return 0;
+}
+
+/*
+Multiplies A and B with whichever algorithm suits their sizes: schoolbook
+for short operands, then Karatsuba, Toom-3 and finally the FFT. A and B are
+never modified, and X may alias either of them.
+*/
+int big_mul_auto(bigint *X, const bigint *A, const bigint *B) {
+    return big_mul_with_scratch(X, A, B, NULL);
+}
+
+/*
+Squares A, which limb_mul recognizes and hands to limb_sqr. X may alias A.
+*/
+int big_sqr(bigint *X, const bigint *A) {
+    return big_mul_with_scratch(X, A, A, NULL);
+}
+
+/*
+X = X + A * B, or X - A * B if subtract is set, in X's own buffer of
+max(xn, an + bn) + 1 limbs. A product that fits in ADDMUL_STACK_LIMBS
+together with its scratch space is formed there by limb_mul and added in
+one pass, so no heap is touched. Longer ones with the shorter operand below
+karatsuba_threshold limbs, as in a Horner step, go in a row at a time with
+limb_addmul_1 or limb_submul_1, the schoolbook product without a buffer for
+it. Anything else, and short ones when X aliases A or B, is formed in
+malloc'd scratch space. A subtraction that crosses zero leaves the two's
+complement of the result, negated at the end like in big_comb_ui.
+*/
+#define ADDMUL_STACK_LIMBS 512
+
+int big_addmul_signed(bigint *X, const bigint *A, const bigint *B, bool subtract) {
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    if (an == 0 || bn == 0) {
+        return 0;
+    }
+    if (an < bn) {
+        const bigint *T = A;
+        A = B;
+        B = T;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    int p_sign = ((A->signum < 0) != (B->signum < 0)) ? -1 : 1;
+    if (subtract) {
+        p_sign = -p_sign;
+    }
+    size_t xn = limb_trimmed_len(X->data, X->num_limbs);
+    int x_sign = (xn == 0) ? p_sign : (X->signum < 0) ? -1 : 1;
+    size_t n = ((xn > an + bn) ? xn : an + bn) + 1;
+    size_t tn = an + bn + big_mul_scratch_size(an, bn);
+    bool rows = tn > ADDMUL_STACK_LIMBS && bn < karatsuba_threshold && X->data != A->data &&
+                X->data != B->data;
+
+    // The product comes first, reserving may move A's or B's data if X aliases them
+    big_uint stack[ADDMUL_STACK_LIMBS];
+    big_uint *tp = NULL;
+    if (!rows) {
+        tp = (tn <= ADDMUL_STACK_LIMBS) ? stack : (big_uint *)malloc(tn * sizeof(big_uint));
+        if (tp == NULL) {
+            return ERR_BIGINT_ALLOC_FAILED;
+        }
+        limb_mul(tp, A->data, an, B->data, bn, tp + an + bn);
+    }
+    int ret = big_reserve(X, n);
+    if (ret != 0) {
+        free(tp);
+        return ret;
+    }
+    big_uint *xp = X->data;
+    memset(xp + xn, 0, (n - xn) * sizeof(big_uint));
+    big_uint borrow = 0;
+    if (rows) {
+        for (size_t j = 0; j < bn; j++) {
+            if (x_sign == p_sign) {
+                big_uint cy = limb_addmul_1(xp + j, A->data, an, B->data[j]);
+                limb_add_1(xp + j + an, xp + j + an, n - j - an, cy);
+            }
+            else {
+                big_uint bw = limb_submul_1(xp + j, A->data, an, B->data[j]);
+                borrow |= limb_sub_1(xp + j + an, xp + j + an, n - j - an, bw);
+            }
+        }
+    }
+    else if (x_sign == p_sign) {
+        limb_add(xp, xp, n, tp, an + bn);
+    }
+    else {
+        borrow = limb_sub(xp, xp, n, tp, an + bn);
+    }
+    if (tp != stack) {
+        free(tp);
+    }
+    int sign = x_sign;
+    if (borrow != 0) {
+        limb_neg(xp, xp, n);
+        sign = -x_sign;
+    }
+    big_normalize(X, n, sign);
+    return 0;
+}
+
+int big_addmul(bigint *X, const bigint *A, const bigint *B) {
+    if (X == NULL || A == NULL || B == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return big_addmul_signed(X, A, B, false);
+}
+
+int big_submul(bigint *X, const bigint *A, const bigint *B) {
+    if (X == NULL || A == NULL || B == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return big_addmul_signed(X, A, B, true);
+}
+
+int big_mul_ui(bigint *X, const bigint *A, big_uint u) {
+    if (X == NULL || A == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    int sign = (A->signum < 0) ? -1 : 1;
+    // Reserving first matters when X aliases A, its data may move
+    int ret = big_reserve(X, an + 1);
+    if (ret != 0) {
+        return ret;
+    }
+    X->data[an] = limb_mul_1(X->data, A->data, an, u);
+    big_normalize(X, an + 1, sign);
+    return 0;
+}
+
+/*
+X = A + u, or A - u if subtract is set, in X's own buffer like
+big_add_signed. Only a carry or borrow has to travel past the lowest limb.
+*/
+int big_add_ui_signed(bigint *X, const bigint *A, big_uint u, bool subtract) {
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    int a_sign = (A->signum < 0) ? -1 : 1;
+    int u_sign = subtract ? -1 : 1;
+    int ret = big_reserve(X, an + 1);
+    if (ret != 0) {
+        return ret;
+    }
+    big_uint *xp = X->data;
+    const big_uint *ap = A->data;
+    if (an == 0) {
+        xp[0] = u;
+        big_normalize(X, 1, u_sign);
+    }
+    else if (a_sign == u_sign) {
+        xp[an] = limb_add_1(xp, ap, an, u);
+        big_normalize(X, an + 1, a_sign);
+    }
+    else if (an == 1 && ap[0] < u) {
+        xp[0] = u - ap[0];
+        big_normalize(X, 1, u_sign);
+    }
+    else {
+        limb_sub_1(xp, ap, an, u);
+        big_normalize(X, an, a_sign);
+    }
+    return 0;
+}
+
+int big_add_ui(bigint *X, const bigint *A, big_uint u) {
+    if (X == NULL || A == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return big_add_ui_signed(X, A, u, false);
+}
+
+int big_sub_ui(bigint *X, const bigint *A, big_uint u) {
+    if (X == NULL || A == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return big_add_ui_signed(X, A, u, true);
+}
+
+// PARALLEL MULTIPLICATION STARTS HERE
+
+/*
+big_mul_parallel forks the independent subproducts of Karatsuba and Toom-3
+as tasks for a pool of threads, down to operands of parallel_mul_threshold
+limbs. Below that, a task multiplies serially with limb_mul, so the forking
+overhead only ever applies to products that take long enough to pay for it.
+*/
+#ifndef PARALLEL_MUL_THRESHOLD
+#define PARALLEL_MUL_THRESHOLD 2000
+#endif
+size_t parallel_mul_threshold = PARALLEL_MUL_THRESHOLD;
+
+#ifndef BIGINT_NO_THREADS
+
+/*
+A subproduct {rp, an + bn} = {ap, an} * {bp, bn} waiting to be run. pending
+points at the counter of the node that forked it, which is decremented once
+the product is done. prev and next link it into a worker's deque.
+*/
+typedef struct big_task {
+    big_uint *rp;
+    const big_uint *ap;
+    const big_uint *bp;
+    size_t an;
+    size_t bn;
+    size_t *pending;
+    struct big_task *prev;
+    struct big_task *next;
+} big_task;
+
+/*
+Every worker owns a deque of tasks. It pushes and pops its own at the tail,
+so it keeps working on the subproducts it forked last, whose operands are
+still in its cache, and idle workers steal from the head, where the oldest
+and therefore largest tasks sit. The arena is scratch space for the serial
+products at the leaves, kept and grown across calls.
+*/
+typedef struct {
+    big_thread_pool *pool;
+    size_t index;
+    big_task *head;
+    big_task *tail;
+    big_uint *arena;
+    size_t arena_limbs;
+    pthread_t thread;
+} big_worker;
+
+/*
+All deques, pending counters and the flags are guarded by lock. work is
+signalled whenever a task is pushed, and broadcast when a node's last
+subproduct is done or the pool shuts down. Worker 0 is the thread inside
+big_mul_parallel, the others are the threads - 1 threads started by
+big_pool_init. call_lock lets only one big_mul_parallel use the pool at a
+time.
+*/
+struct big_thread_pool {
+    size_t threads;
+    big_worker *workers;
+    pthread_mutex_t lock;
+    pthread_cond_t work;
+    pthread_mutex_t call_lock;
+    bool stop;
+    bool failed;
+};
+
+// Takes a task for worker w, its own newest one or else the oldest of another's
+big_task *pool_take(big_thread_pool *pool, big_worker *w) {
+    big_task *t = w->tail;
+    if (t != NULL) {
+        w->tail = t->prev;
+        if (w->tail == NULL) {
+            w->head = NULL;
+        }
+        else {
+            w->tail->next = NULL;
+        }
+        return t;
+    }
+    for (size_t i = 1; i < pool->threads; i++) {
+        big_worker *victim = &pool->workers[(w->index + i) % pool->threads];
+        t = victim->head;
+        if (t != NULL) {
+            victim->head = t->next;
+            if (victim->head == NULL) {
+                victim->tail = NULL;
+            }
+            else {
+                victim->head->prev = NULL;
+            }
+            return t;
+        }
+    }
+    return NULL;
+}
+
+void pool_push(big_worker *w, big_task *t) {
+    big_thread_pool *pool = w->pool;
+    pthread_mutex_lock(&pool->lock);
+    t->prev = w->tail;
+    t->next = NULL;
+    if (w->tail == NULL) {
+        w->head = t;
+    }
+    else {
+        w->tail->next = t;
+    }
+    w->tail = t;
+    (*t->pending)++;
+    pthread_cond_signal(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+}
+
+// Records a failed allocation, which makes the remaining tasks return early
+void pool_fail(big_thread_pool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    pool->failed = true;
+    pthread_mutex_unlock(&pool->lock);
+}
+
+bool pool_failed(big_thread_pool *pool) {
+    pthread_mutex_lock(&pool->lock);
+    bool failed = pool->failed;
+    pthread_mutex_unlock(&pool->lock);
+    return failed;
+}
+
+/*
+Scratch space of at least n limbs from w's arena, NULL only if it cannot be
+grown. Only the serial products at the leaves use it, and those never wait
+for other tasks, so a worker cannot start a second leaf while its arena is
+still in use.
+*/
+big_uint *worker_scratch(big_worker *w, size_t n) {
+    if (n == 0) {
+        n = 1;
+    }
+    if (n > w->arena_limbs) {
+        big_uint *arena = (big_uint *)realloc(w->arena, n * sizeof(big_uint));
+        if (arena == NULL) {
+            return NULL;
+        }
+        w->arena = arena;
+        w->arena_limbs = n;
+    }
+    return w->arena;
+}
+
+void limb_mul_parallel(big_worker *w, big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp,
+                       size_t bn);
+
+void pool_run(big_worker *w, big_task *t) {
+    limb_mul_parallel(w, t->rp, t->ap, t->an, t->bp, t->bn);
+    big_thread_pool *pool = w->pool;
+    pthread_mutex_lock(&pool->lock);
+    if (--(*t->pending) == 0) {
+        pthread_cond_broadcast(&pool->work);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+Waits until all tasks forked against pending are done. Rather than block,
+the worker runs tasks in the meantime, its own first, so a node whose
+children nobody has stolen simply runs them itself.
+*/
+void pool_join(big_worker *w, size_t *pending) {
+    big_thread_pool *pool = w->pool;
+    pthread_mutex_lock(&pool->lock);
+    while (*pending > 0) {
+        big_task *t = pool_take(pool, w);
+        if (t == NULL) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        pool_run(w, t);
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+}
+
+/*
+Forks tasks[1..count) and runs tasks[0] on the calling worker, then waits
+for the rest.
+*/
+void pool_fork_join(big_worker *w, big_task *tasks, size_t count) {
+    size_t pending = 0;
+    for (size_t i = 1; i < count; i++) {
+        tasks[i].pending = &pending;
+        pool_push(w, &tasks[i]);
+    }
+    limb_mul_parallel(w, tasks[0].rp, tasks[0].ap, tasks[0].an, tasks[0].bp, tasks[0].bn);
+    pool_join(w, &pending);
+}
+
+void *pool_worker_main(void *arg) {
+    big_worker *w = (big_worker *)arg;
+    big_thread_pool *pool = w->pool;
+    pthread_mutex_lock(&pool->lock);
+    while (!pool->stop) {
+        big_task *t = pool_take(pool, w);
+        if (t == NULL) {
+            pthread_cond_wait(&pool->work, &pool->lock);
+            continue;
+        }
+        pthread_mutex_unlock(&pool->lock);
+        pool_run(w, t);
+        pthread_mutex_lock(&pool->lock);
+    }
+    pthread_mutex_unlock(&pool->lock);
+    return NULL;
+}
+
+/*
+Toom-3 node of the parallel recursion, laid out like limb_mul_toom3 except
+that the evaluations and the three middle products get their own buffer,
+since the five products now run at the same time. A square evaluates its
+operand once, so the products at the points are squares as well.
+*/
+void par_mul_toom3(big_worker *w, big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    size_t m = (n + 2) / 3;
+    size_t s = n - 2 * m;
+    size_t len = 2 * m + 2;
+    big_uint *buf = (big_uint *)malloc((6 * (m + 1) + 3 * len) * sizeof(big_uint));
+    if (buf == NULL) {
+        pool_fail(w->pool);
+        return;
+    }
+    big_uint *pa = buf;
+    big_uint *pb = pa + 3 * (m + 1);
+    big_uint *r1 = pb + 3 * (m + 1);
+    big_uint *r_1 = r1 + len;
+    big_uint *r_2 = r_1 + len;
+
+    int signs = evaluate_polynomials(pa, ap, m, s, r1);
+    if (ap == bp) {
+        pb = pa;
+        signs = 0;
+    }
+    else {
+        signs ^= evaluate_polynomials(pb, bp, m, s, r1);
+    }
+
+    big_task tasks[5] = {
+        {.rp = r1, .ap = pa, .bp = pb, .an = m + 1, .bn = m + 1},
+        {.rp = r_1, .ap = pa + (m + 1), .bp = pb + (m + 1), .an = m + 1, .bn = m + 1},
+        {.rp = r_2, .ap = pa + 2 * (m + 1), .bp = pb + 2 * (m + 1), .an = m + 1, .bn = m + 1},
+        {.rp = rp, .ap = ap, .bp = bp, .an = m, .bn = m},
+        {.rp = rp + 4 * m, .ap = ap + 2 * m, .bp = bp + 2 * m, .an = s, .bn = s},
+    };
+    pool_fork_join(w, tasks, 5);
+
+    if (!pool_failed(w->pool)) {
+        if (signs & 1) {
+            limb_neg(r_1, r_1, len);
+        }
+        if (signs & 2) {
+            limb_neg(r_2, r_2, len);
+        }
+        interpolate_results(rp, r1, r_1, r_2, m, 2 * s);
+    }
+    free(buf);
+}
+
+// Karatsuba node of the parallel recursion, see limb_mul_karatsuba
+void par_mul_karatsuba(big_worker *w, big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    size_t m = (n + 1) / 2;
+    size_t h = n - m;
+    big_uint *buf = (big_uint *)malloc(4 * m * sizeof(big_uint));
+    if (buf == NULL) {
+        pool_fail(w->pool);
+        return;
+    }
+    big_uint *da = buf;
+    big_uint *db = buf + m;
+    big_uint *zm = buf + 2 * m;
+    int negative = limb_abs_diff(da, ap, m, ap + m, h);
+    if (ap == bp) {
+        db = da;
+        negative = 0;
+    }
+    else {
+        negative ^= limb_abs_diff(db, bp, m, bp + m, h);
+    }
+
+    big_task tasks[3] = {
+        {.rp = rp, .ap = ap, .bp = bp, .an = m, .bn = m},
+        {.rp = rp + 2 * m, .ap = ap + m, .bp = bp + m, .an = h, .bn = h},
+        {.rp = zm, .ap = da, .bp = db, .an = m, .bn = m},
+    };
+    pool_fork_join(w, tasks, 3);
+
+    if (!pool_failed(w->pool)) {
+        big_uint *z1 = buf;
+        big_uint cy = limb_add(z1, rp, 2 * m, rp + 2 * m, 2 * h);
+        if (negative) {
+            cy += limb_add_n(z1, z1, zm, 2 * m);
+        }
+        else {
+            cy -= limb_sub_n(z1, z1, zm, 2 * m);
+        }
+        cy += limb_add_n(rp + m, rp + m, z1, 2 * m);
+        limb_add_1(rp + 3 * m, rp + 3 * m, 2 * n - 3 * m, cy);
+    }
+    free(buf);
+}
+
+/*
+Unbalanced node: the longer operand is cut into pieces of at least bn limbs,
+enough of them to keep every worker busy but none so short that its product
+falls under the cutoff, and the piece products run as tasks. Each goes to
+its own buffer, and adding them up afterwards only touches the bn limbs
+where neighbours overlap.
+*/
+void par_mul_pieces(big_worker *w, big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp,
+                    size_t bn) {
+    size_t cutoff = parallel_mul_threshold * parallel_mul_threshold;
+    size_t piece = (an + 4 * w->pool->threads - 1) / (4 * w->pool->threads);
+    if (piece < bn) {
+        piece = bn;
+    }
+    if (piece < (cutoff + bn - 1) / bn) {
+        piece = (cutoff + bn - 1) / bn;
+    }
+    size_t count = (an + piece - 1) / piece;
+    if (count < 2) {
+        big_uint *tp = worker_scratch(w, big_mul_scratch_size(an, bn));
+        if (tp == NULL) {
+            pool_fail(w->pool);
+            return;
+        }
+        limb_mul(rp, ap, an, bp, bn, tp);
+        return;
+    }
+    big_task *tasks = (big_task *)malloc(count * sizeof(big_task));
+    big_uint *buf = (big_uint *)malloc((an + count * bn) * sizeof(big_uint));
+    if (tasks == NULL || buf == NULL) {
+        free(tasks);
+        free(buf);
+        pool_fail(w->pool);
+        return;
+    }
+    big_uint *prod = buf;
+    for (size_t i = 0; i < count; i++) {
+        size_t len = (i + 1 < count) ? piece : an - i * piece;
+        tasks[i] = (big_task){.rp = prod, .ap = ap + i * piece, .bp = bp, .an = len, .bn = bn};
+        prod += len + bn;
+    }
+    pool_fork_join(w, tasks, count);
+
+    if (!pool_failed(w->pool)) {
+        memcpy(rp, tasks[0].rp, (piece + bn) * sizeof(big_uint));
+        for (size_t i = 1; i < count; i++) {
+            big_uint *at = rp + i * piece;
+            big_uint cy = limb_add_n(at, at, tasks[i].rp, bn);
+            limb_add_1(at + bn, tasks[i].rp + bn, tasks[i].an, cy);
+        }
+    }
+    free(tasks);
+    free(buf);
+}
+
+/*
+{rp, an + bn} = {ap, an} * {bp, bn} on worker w. Products under the cutoff
+are formed serially with limb_mul. Balanced ones above it split with Toom-3
+or Karatsuba, and unbalanced ones into pieces. rp may not overlap the
+inputs. On an allocation failure the pool is marked failed and rp is left
+undefined.
+*/
+void limb_mul_parallel(big_worker *w, big_uint *rp, const big_uint *ap, size_t an, const big_uint *bp,
+                       size_t bn) {
+    if (pool_failed(w->pool)) {
+        return;
+    }
+    if (an < bn) {
+        const big_uint *t = ap;
+        ap = bp;
+        bp = t;
+        size_t tn = an;
+        an = bn;
+        bn = tn;
+    }
+    size_t cutoff = parallel_mul_threshold;
+    if ((bn <= cutoff && an <= cutoff * cutoff / bn) || an <= karatsuba_threshold) {
+        big_uint *tp = worker_scratch(w, big_mul_scratch_size(an, bn));
+        if (tp == NULL) {
+            pool_fail(w->pool);
+            return;
+        }
+        limb_mul(rp, ap, an, bp, bn, tp);
+    }
+    else if (an != bn) {
+        par_mul_pieces(w, rp, ap, an, bp, bn);
+    }
+    else if (an > toom3_threshold) {
+        par_mul_toom3(w, rp, ap, bp, an);
+    }
+    else {
+        par_mul_karatsuba(w, rp, ap, bp, an);
+    }
+}
+
+int big_pool_init(big_thread_pool **pool, size_t threads) {
+    if (pool == NULL || threads == 0) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    big_thread_pool *p = (big_thread_pool *)calloc(1, sizeof(big_thread_pool));
+    if (p == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    p->workers = (big_worker *)calloc(threads, sizeof(big_worker));
+    if (p->workers == NULL) {
+        free(p);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    p->threads = threads;
+    pthread_mutex_init(&p->lock, NULL);
+    pthread_cond_init(&p->work, NULL);
+    pthread_mutex_init(&p->call_lock, NULL);
+    for (size_t i = 0; i < threads; i++) {
+        p->workers[i].pool = p;
+        p->workers[i].index = i;
+    }
+    for (size_t i = 1; i < threads; i++) {
+        if (pthread_create(&p->workers[i].thread, NULL, pool_worker_main, &p->workers[i]) != 0) {
+            // Only the threads started so far are joined
+            p->threads = i;
+            big_pool_free(p);
+            return ERR_BIGINT_ALLOC_FAILED;
+        }
+    }
+    *pool = p;
+    return 0;
+}
+
+void big_pool_free(big_thread_pool *pool) {
+    if (pool == NULL) {
+        return;
+    }
+    pthread_mutex_lock(&pool->lock);
+    pool->stop = true;
+    pthread_cond_broadcast(&pool->work);
+    pthread_mutex_unlock(&pool->lock);
+    for (size_t i = 1; i < pool->threads; i++) {
+        pthread_join(pool->workers[i].thread, NULL);
+    }
+    for (size_t i = 0; i < pool->threads; i++) {
+        free(pool->workers[i].arena);
+    }
+    pthread_mutex_destroy(&pool->lock);
+    pthread_cond_destroy(&pool->work);
+    pthread_mutex_destroy(&pool->call_lock);
+    free(pool->workers);
+    free(pool);
+}
+
+int big_mul_parallel(bigint *X, const bigint *A, const bigint *B, big_thread_pool *pool) {
+    if (A == NULL || B == NULL || X == NULL || pool == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    int sign = ((A->signum < 0) != (B->signum < 0)) ? -1 : 1;
+    big_uint *rp = big_result_buffer(X, A, B, (an + bn > 0) ? an + bn : 1);
+    if (rp == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    size_t rn = (an > 0 && bn > 0) ? an + bn : 0;
+    if (rn > 0) {
+        pthread_mutex_lock(&pool->call_lock);
+        pthread_mutex_lock(&pool->lock);
+        pool->failed = false;
+        pthread_mutex_unlock(&pool->lock);
+        limb_mul_parallel(&pool->workers[0], rp, A->data, an, B->data, bn);
+        bool failed = pool_failed(pool);
+        pthread_mutex_unlock(&pool->call_lock);
+        if (failed) {
+            if (rp != X->data) {
+                free(rp);
+            }
+            return ERR_BIGINT_ALLOC_FAILED;
+        }
+    }
+    big_finish_result(X, rp, rn, sign);
+    return 0;
+}
+
+#else
+
+// Without threads the pool only remembers its size and products run serially
+struct big_thread_pool {
+    size_t threads;
+};
+
+int big_pool_init(big_thread_pool **pool, size_t threads) {
+    if (pool == NULL || threads == 0) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    *pool = (big_thread_pool *)malloc(sizeof(big_thread_pool));
+    if (*pool == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    (*pool)->threads = threads;
+    return 0;
+}
+
+void big_pool_free(big_thread_pool *pool) {
+    free(pool);
+}
+
+int big_mul_parallel(bigint *X, const bigint *A, const bigint *B, big_thread_pool *pool) {
+    if (pool == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return big_mul_with_scratch(X, A, B, NULL);
+}
+
+#endif
+
+// DIVISION STARTS HERE
+
+/*
+Recursive division hands over to the Knuth basecase once either the divisor
+or the quotient drops below this many limbs. Below it the products formed by
+the recursion are schoolbook sized anyway, so splitting only adds overhead.
+*/
+#ifndef BZ_DIV_THRESHOLD
+#define BZ_DIV_THRESHOLD 80
+#endif
+size_t bz_div_threshold = BZ_DIV_THRESHOLD;
+
+#if BZ_DIV_THRESHOLD < 2
+#error "the division basecase needs divisors of at least 2 limbs"
+#endif
+
+/*
+Reciprocal of a normalized limb d (top bit set): floor((2^128 - 1) / d) - 2^64.
+Precomputing it once per divisor turns every quotient estimate in the loops
+below into multiplications instead of a full 128-by-64 bit division.
+*/
+big_uint limb_invert(big_uint d) {
+    big_udbl numerator = ((big_udbl)~d << 64) | UINT64_MAX;
+    return (big_uint)(numerator / d);
+}
+
+/*
+Reciprocal of the normalized two limb divisor (d1, d0):
+floor((2^192 - 1) / (d1 * 2^64 + d0)) - 2^64, obtained by correcting the
+single limb reciprocal of d1 for the influence of d0.
+*/
+big_uint limb_invert_3by2(big_uint d1, big_uint d0) {
+    big_uint v = limb_invert(d1);
+    big_uint p = d1 * v;
+    p += d0;
+    if (p < d0) {
+        v--;
+        big_uint mask = -(big_uint)(p >= d1);
+        p -= d1;
+        v += mask;
+        p -= mask & d1;
+    }
+    big_udbl t = (big_udbl)d0 * v;
+    big_uint t1 = (big_uint)(t >> 64);
+    big_uint t0 = (big_uint)t;
+    p += t1;
+    if (p < t1) {
+        v--;
+        if (p >= d1) {
+            if (p > d1 || t0 >= d0) {
+                v--;
+            }
+        }
+    }
+    return v;
+}
+
+/*
+Divides the two limb number (nh, nl) by the normalized limb d using its
+reciprocal dinv, where nh < d. Moller and Granlund's method, it needs at
+most one correction step.
+*/
+big_uint limb_udiv_qr_2by1(big_uint *r, big_uint nh, big_uint nl, big_uint d, big_uint dinv) {
+    big_udbl p = (big_udbl)nh * dinv;
+    p += ((big_udbl)(nh + 1) << 64) | nl;
+    big_uint q = (big_uint)(p >> 64);
+    big_uint q0 = (big_uint)p;
+    big_uint rem = nl - q * d;
+    if (rem > q0) {
+        q--;
+        rem += d;
+    }
+    if (rem >= d) {
+        rem -= d;
+        q++;
+    }
+    *r = rem;
+    return q;
+}
+
+/*
+Divides the three limb number (n2, n1, n0) by the normalized two limb
+divisor (d1, d0), where (n2, n1) < (d1, d0). Returns the quotient limb and
+leaves the two limb remainder in *r1, *r0.
+*/
+big_uint limb_udiv_qr_3by2(big_uint *r1, big_uint *r0, big_uint n2, big_uint n1, big_uint n0,
+                           big_uint d1, big_uint d0, big_uint dinv) {
+    big_udbl d = ((big_udbl)d1 << 64) | d0;
+    big_udbl p = (big_udbl)n2 * dinv;
+    p += ((big_udbl)n2 << 64) | n1;
+    big_uint q = (big_uint)(p >> 64);
+    big_uint q0 = (big_uint)p;
+
+    big_udbl rem = ((big_udbl)(n1 - d1 * q) << 64) | n0;
+    rem -= d;
+    rem -= (big_udbl)d0 * q;
+    q++;
+
+    big_uint mask = -(big_uint)((big_uint)(rem >> 64) >= q0);
+    q += mask;
+    rem += d & (((big_udbl)mask << 64) | mask);
+    if (rem >= d) {
+        q++;
+        rem -= d;
+    }
+    *r1 = (big_uint)(rem >> 64);
+    *r0 = (big_uint)rem;
+    return q;
+}
+
+/*
+A single limb divisor prepared for any number of divisions: d shifted up
+until its top bit is set, the shift, and the reciprocal of the shifted d.
+Code that keeps dividing by the same limb computes the reciprocal only once.
+*/
+typedef struct {
+    big_uint d;
+    big_uint dinv;
+    unsigned shift;
+} limb_divisor;
+
+void limb_divisor_init(limb_divisor *dv, big_uint d) {
+    dv->shift = __builtin_clzll(d);
+    dv->d = d << dv->shift;
+    dv->dinv = limb_invert(dv->d);
+}
+
+/*
+Divides {ap, n} by the single limb divisor dv into {qp, n} and returns the
+remainder. qp may alias ap.
+*/
+big_uint limb_divrem_1_preinv(big_uint *qp, const big_uint *ap, size_t n, const limb_divisor *dv) {
+    unsigned shift = dv->shift;
+    big_uint d = dv->d;
+    big_uint dinv = dv->dinv;
+    big_uint r = 0;
+    if (n == 0) {
+        return 0;
+    }
+    if (shift == 0) {
+        for (size_t i = n; i-- > 0; ) {
+            qp[i] = limb_udiv_qr_2by1(&r, r, ap[i], d, dinv);
+        }
+        return r;
+    }
+    r = ap[n - 1] >> (64 - shift);
+    for (size_t i = n - 1; i > 0; i--) {
+        big_uint next = (ap[i] << shift) | (ap[i - 1] >> (64 - shift));
+        qp[i] = limb_udiv_qr_2by1(&r, r, next, d, dinv);
+    }
+    qp[0] = limb_udiv_qr_2by1(&r, r, ap[0] << shift, d, dinv);
+    return r >> shift;
+}
+
+// Returns {ap, n} mod dv, like limb_divrem_1_preinv without storing the quotient
+big_uint limb_mod_1_preinv(const big_uint *ap, size_t n, const limb_divisor *dv) {
+    unsigned shift = dv->shift;
+    big_uint d = dv->d;
+    big_uint dinv = dv->dinv;
+    big_uint r = 0;
+    if (n == 0) {
+        return 0;
+    }
+    if (shift != 0) {
+        r = ap[n - 1] >> (64 - shift);
+        for (size_t i = n - 1; i > 0; i--) {
+            big_uint next = (ap[i] << shift) | (ap[i - 1] >> (64 - shift));
+            limb_udiv_qr_2by1(&r, r, next, d, dinv);
+        }
+        limb_udiv_qr_2by1(&r, r, ap[0] << shift, d, dinv);
+        return r >> shift;
+    }
+    for (size_t i = n; i-- > 0; ) {
+        limb_udiv_qr_2by1(&r, r, ap[i], d, dinv);
+    }
+    return r;
+}
+
+/*
+Divides {ap, n} by the single limb d into {qp, n} and returns the remainder.
+d does not have to be normalized, and qp may alias ap.
+*/
+big_uint limb_divrem_1(big_uint *qp, const big_uint *ap, size_t n, big_uint d) {
+    limb_divisor dv;
+    limb_divisor_init(&dv, d);
+    return limb_divrem_1_preinv(qp, ap, n, &dv);
+}
+
+// Returns {ap, n} mod d, like limb_divrem_1 without storing the quotient
+big_uint limb_mod_1(const big_uint *ap, size_t n, big_uint d) {
+    limb_divisor dv;
+    limb_divisor_init(&dv, d);
+    return limb_mod_1_preinv(ap, n, &dv);
+}
+
+/*
+Knuth's algorithm D. Divides {np, nn} by the normalized divisor {dp, dn},
+dn >= 2, writing the low nn - dn quotient limbs to qp and returning the top
+quotient limb (0 or 1). The remainder is left in {np, dn}. Every quotient
+limb is estimated from the top three limbs of the running remainder using
+the 3/2 reciprocal dinv, which is at most one too large.
+*/
+big_uint limb_div_basecase(big_uint *qp, big_uint *np, size_t nn,
+                           const big_uint *dp, size_t dn, big_uint dinv) {
+    big_uint qh = limb_cmp(np + nn - dn, dp, dn) >= 0;
+    if (qh) {
+        limb_sub_n(np + nn - dn, np + nn - dn, dp, dn);
+    }
+
+    big_uint d1 = dp[dn - 1];
+    big_uint d0 = dp[dn - 2];
+    // n1 holds the top limb of the running remainder, which is never stored
+    big_uint n1 = np[nn - 1];
+    for (size_t i = nn - dn; i-- > 0; ) {
+        big_uint *cur = np + i;
+        big_uint q;
+        if (n1 == d1 && cur[dn - 1] == d0) {
+            q = UINT64_MAX;
+            limb_submul_1(cur, dp, dn, q);
+            n1 = cur[dn - 1];
+        }
+        else {
+            big_uint n0;
+            q = limb_udiv_qr_3by2(&n1, &n0, n1, cur[dn - 1], cur[dn - 2], d1, d0, dinv);
+            big_uint cy = limb_submul_1(cur, dp, dn - 2, q);
+            big_uint cy1 = n0 < cy;
+            n0 -= cy;
+            cy = n1 < cy1;
+            n1 -= cy1;
+            cur[dn - 2] = n0;
+            // The estimate was one too large, add the divisor back
+            if (cy != 0) {
+                n1 += d1 + limb_add_n(cur, cur, dp, dn - 1);
+                q--;
+            }
+        }
+        qp[i] = q;
+    }
+    np[dn - 1] = n1;
+    return qh;
+}
+
+/*
+Burnikel-Ziegler style recursive division of {np, dn + qn} by the normalized
+divisor {dp, dn}, for qn <= dn. Writes qn quotient limbs to qp, returns the
+top quotient limb and leaves the remainder in {np, dn}. tp needs room for
+dn + big_mul_scratch_size(dn, dn) limbs.
+
+If the quotient is shorter than the divisor, it is first estimated from the
+top 2 * qn limbs of np divided by the top qn limbs of dp. Then the product of
+that estimate with the ignored low part of the divisor is subtracted, which
+only ever overestimates by a couple of units. A balanced division splits the
+quotient in half and does two such steps. Altogether this costs O(M(n) log n)
+instead of the O(n^2) of the basecase.
+*/
+big_uint limb_div_dc(big_uint *qp, big_uint *np, const big_uint *dp, size_t dn, size_t qn,
+                     big_uint dinv, big_uint *tp) {
+    if (qn < bz_div_threshold || dn < bz_div_threshold) {
+        return limb_div_basecase(qp, np, dn + qn, dp, dn, dinv);
+    }
+    if (qn < dn) {
+        size_t lo = dn - qn;
+        big_uint qh = limb_div_dc(qp, np + lo, dp + lo, qn, qn, dinv, tp);
+        limb_mul(tp, qp, qn, dp, lo, tp + dn);
+        big_uint cy = limb_sub_n(np, np, tp, dn);
+        if (qh != 0) {
+            cy += limb_sub_n(np + qn, np + qn, dp, lo);
+        }
+        while (cy != 0) {
+            qh -= limb_sub_1(qp, qp, qn, 1);
+            cy -= limb_add_n(np, np, dp, dn);
+        }
+        return qh;
+    }
+    size_t lo = qn / 2;
+    size_t hi = qn - lo;
+    big_uint qh = limb_div_dc(qp + lo, np + lo, dp, dn, hi, dinv, tp);
+    big_uint ql = limb_div_dc(qp, np, dp, dn, lo, dinv, tp);
+    // The high step leaves a remainder below the divisor, so ql is always 0
+    qh += limb_add_1(qp + lo, qp + lo, hi, ql);
+    return qh;
+}
+
+/*
+Divides {np, nn} by the normalized divisor {dp, dn}, dn >= 2, into
+nn - dn quotient limbs plus the returned top limb. Quotients longer than
+the divisor are produced dn limbs at a time from the top, each block being
+one balanced recursive division.
+*/
+big_uint limb_div_qr(big_uint *qp, big_uint *np, size_t nn, const big_uint *dp, size_t dn,
+                     big_uint *tp) {
+    size_t qn = nn - dn;
+    big_uint dinv = limb_invert_3by2(dp[dn - 1], dp[dn - 2]);
+    if (qn <= dn) {
+        return limb_div_dc(qp, np, dp, dn, qn, dinv, tp);
+    }
+    size_t chunk = qn % dn;
+    if (chunk == 0) {
+        chunk = dn;
+    }
+    qn -= chunk;
+    big_uint qh = limb_div_dc(qp + qn, np + qn, dp, dn, chunk, dinv, tp);
+    while (qn > 0) {
+        qn -= dn;
+        limb_div_dc(qp + qn, np + qn, dp, dn, dn, dinv, tp);
+    }
+    return qh;
+}
+
+int big_div(bigint *Q, bigint *R, const bigint *A, const bigint *B) {
+    if (A == NULL || B == NULL || (Q == NULL && R == NULL) || Q == R) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    if (bn == 0) {
+        return ERR_BIGINT_DIVISION_BY_ZERO;
+    }
+    int a_sign = (A->signum < 0) ? -1 : 1;
+    int q_sign = (B->signum < 0) ? -a_sign : a_sign;
+
+    // |A| < |B|, so the quotient is 0 and A is its own remainder
+    if (an < bn || (an == bn && limb_cmp(A->data, B->data, an) < 0)) {
+        if (R != NULL) {
+            big_uint *rp = (big_uint *)malloc((an > 0 ? an : 1) * sizeof(big_uint));
+            if (rp == NULL) {
+                return ERR_BIGINT_ALLOC_FAILED;
+            }
+            // A freshly initialized zero has no limbs to copy
+            if (an > 0) {
+                memcpy(rp, A->data, an * sizeof(big_uint));
+            }
+            big_adopt_limbs(R, rp, an, a_sign);
+        }
+        if (Q != NULL) {
+            big_uint *qp = (big_uint *)malloc(sizeof(big_uint));
+            if (qp == NULL) {
+                return ERR_BIGINT_ALLOC_FAILED;
+            }
+            big_adopt_limbs(Q, qp, 0, 1);
+        }
+        return 0;
+    }
+
+    if (bn == 1) {
+        big_uint *qp = (big_uint *)malloc(an * sizeof(big_uint));
+        big_uint *rp = (big_uint *)malloc(sizeof(big_uint));
+        if (qp == NULL || rp == NULL) {
+            free(qp);
+            free(rp);
+            return ERR_BIGINT_ALLOC_FAILED;
+        }
+        rp[0] = limb_divrem_1(qp, A->data, an, B->data[0]);
+        if (R != NULL) {
+            big_adopt_limbs(R, rp, 1, a_sign);
+        }
+        else {
+            free(rp);
+        }
+        if (Q != NULL) {
+            big_adopt_limbs(Q, qp, an, q_sign);
+        }
+        else {
+            free(qp);
+        }
+        return 0;
+    }
+
+    // Normalize so the divisor's top bit is set, this keeps the quotient
+    // estimates within one or two of the true value.
+    unsigned shift = __builtin_clzll(B->data[bn - 1]);
+    size_t qn = an + 1 - bn;
+    big_uint *np = (big_uint *)malloc((an + 1) * sizeof(big_uint));
+    big_uint *qp = (big_uint *)malloc(qn * sizeof(big_uint));
+    big_uint *tp = (big_uint *)malloc((bn + big_mul_scratch_size(bn, bn)) * sizeof(big_uint));
+    // An unshifted divisor is used in place. Ownership is decided here, since
+    // adopting the results below repoints B->data when Q or R is B.
+    bool dp_owned = (shift != 0);
+    big_uint *dp = dp_owned ? (big_uint *)malloc(bn * sizeof(big_uint)) : B->data;
+    if (np == NULL || qp == NULL || tp == NULL || dp == NULL) {
+        free(np);
+        free(qp);
+        free(tp);
+        if (dp_owned) {
+            free(dp);
+        }
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    if (shift != 0) {
+        limb_lshift(dp, B->data, bn, shift);
+    }
+    np[an] = limb_lshift(np, A->data, an, shift);
+
+    // The extra top limb of np guarantees the returned top quotient limb is 0
+    limb_div_qr(qp, np, an + 1, dp, bn, tp);
+    limb_rshift(np, np, bn, shift);
+
+    if (R != NULL) {
+        big_adopt_limbs(R, np, bn, a_sign);
+    }
+    else {
+        free(np);
+    }
+    if (Q != NULL) {
+        big_adopt_limbs(Q, qp, qn, q_sign);
+    }
+    else {
+        free(qp);
+    }
+    free(tp);
+    if (dp_owned) {
+        free(dp);
+    }
+    return 0;
+}
+
+int big_div_ui(bigint *Q, big_uint *R, const bigint *A, big_uint d) {
+    if (A == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (d == 0) {
+        return ERR_BIGINT_DIVISION_BY_ZERO;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    int a_sign = (A->signum < 0) ? -1 : 1;
+    big_uint r;
+    if (Q != NULL) {
+        // Reserving first matters when Q aliases A, its data may move
+        int ret = big_reserve(Q, (an > 0) ? an : 1);
+        if (ret != 0) {
+            return ret;
+        }
+        r = limb_divrem_1(Q->data, A->data, an, d);
+        big_normalize(Q, an, a_sign);
+    }
+    else {
+        r = limb_mod_1(A->data, an, d);
+    }
+    if (R != NULL) {
+        *R = r;
+    }
+    return 0;
+}
+
+int big_divexact_ui(bigint *Q, const bigint *A, big_uint d) {
+    if (Q == NULL || A == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (d == 0) {
+        return ERR_BIGINT_DIVISION_BY_ZERO;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    int a_sign = (A->signum < 0) ? -1 : 1;
+    int ret = big_reserve(Q, (an > 0) ? an : 1);
+    if (ret != 0) {
+        return ret;
+    }
+    limb_divexact_1(Q->data, A->data, an, d);
+    big_normalize(Q, an, a_sign);
+    return 0;
+}
+
+// BARRETT REDUCTION STARTS HERE
+
+/*
+Short products of fewer than this many limbs are formed with the schoolbook
+method, which for one half of a product does half the work. Longer ones
+split off a balanced full product of about 70% of the operands and recurse
+on the two corners that are left (Mulders), which saves around a fifth of a
+Karatsuba or Toom product.
+*/
+#ifndef MULLO_THRESHOLD
+#define MULLO_THRESHOLD 128
+#endif
+size_t mullo_threshold = MULLO_THRESHOLD;
+
+#if MULLO_THRESHOLD < 8
+#error "the short product threshold must be at least 8 limbs"
+#endif
+
+// Limbs of the balanced product a short product of n limbs splits off
+size_t short_mul_split(size_t n) {
+    return (7 * n + 9) / 10;
+}
+
+/*
+Scratch limbs limb_mullo_n and limb_mulhi_n need for n-limb operands: the
+balanced product and its own scratch. The corners the recursion goes on with
+are under a third of n, so they fit in the same space.
+*/
+size_t short_mul_scratch_size(size_t n) {
+    return 2 * n + limb_mul_n_scratch_size(n);
+}
+
+/*
+{rp, n} = {ap, n} * {bp, n} mod 2^(64n). With a = a1 * 2^(64l) + a0 and b
+split alike, the low n limbs of a0 * b0 come from one full product, and
+a1 * b0 + a0 * b1 only matter modulo 2^(64(n - l)), which makes them two
+short products again. rp must not overlap ap or bp.
+*/
+void limb_mullo_n(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp) {
+    if (n < mullo_threshold) {
+        limb_mul_1(rp, ap, n, bp[0]);
+        for (size_t i = 1; i < n; i++) {
+            limb_addmul_1(rp + i, ap, n - i, bp[i]);
+        }
+        return;
+    }
+    size_t l = short_mul_split(n);
+    size_t h = n - l;
+    limb_mul_n(tp, ap, bp, l, tp + 2 * l);
+    memcpy(rp, tp, n * sizeof(big_uint));
+    limb_mullo_n(tp, ap + l, bp, h, tp + h);
+    limb_add_n(rp + l, rp + l, tp, h);
+    limb_mullo_n(tp, ap, bp + l, h, tp + h);
+    limb_add_n(rp + l, rp + l, tp, h);
+}
+
+/*
+Approximates {rp, n} = floor({ap, n} * {bp, n} / 2^(64n)) from below, by at
+most 2n. The schoolbook method only adds up the partial products a[i] * b[j]
+with i + j >= n - 1, and the ones it leaves out sum to less than n units.
+Longer operands are split with a1 and b1 the top l limbs. The top n limbs
+of a1 * b1 come from a full product, and of the corners a1 * b0 and a0 * b1
+only the top n - l limbs of a1 and b1 take part, in two short products
+again. Each level loses at most 5 more units, which keeps the total
+under 2n. rp must not overlap ap or bp.
+*/
+void limb_mulhi_n(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp) {
+    if (n < mullo_threshold) {
+        // tp[0] is column n - 1, and every row reaches one column further down
+        tp[1] = limb_mul_1(tp, ap + n - 1, 1, bp[0]);
+        for (size_t j = 1; j < n; j++) {
+            tp[j + 1] = limb_addmul_1(tp, ap + n - 1 - j, j + 1, bp[j]);
+        }
+        memcpy(rp, tp + 1, n * sizeof(big_uint));
+        return;
+    }
+    size_t l = short_mul_split(n);
+    size_t h = n - l;
+    limb_mul_n(tp, ap + h, bp + h, l, tp + 2 * l);
+    memcpy(rp, tp + l - h, n * sizeof(big_uint));
+    limb_mulhi_n(tp, ap + l, bp, h, tp + h);
+    limb_add(rp, rp, n, tp, h);
+    limb_mulhi_n(tp, ap, bp + l, h, tp + h);
+    limb_add(rp, rp, n, tp, h);
+}
+
+/*
+{rp, n} = floor({ap, n} * {bp, n} / 2^(64n)) exactly. limb_mulhi_n of the
+operands shifted up by one limb gives an extra limb below the result, off by
+at most 2n + 2, so unless that limb is that close to overflowing the limbs
+above it are exact. For random operands the full product is needed with a
+probability of about n / 2^63. tp needs mulhi_scratch_size(n) limbs.
+*/
+void limb_mulhi_n_exact(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp) {
+    big_uint *as = tp;
+    big_uint *bs = tp + n + 1;
+    big_uint *gp = tp + 2 * n + 2;
+    as[0] = 0;
+    bs[0] = 0;
+    memcpy(as + 1, ap, n * sizeof(big_uint));
+    memcpy(bs + 1, bp, n * sizeof(big_uint));
+    limb_mulhi_n(gp, as, bs, n + 1, tp + 3 * n + 3);
+    if (gp[0] <= UINT64_MAX - (2 * n + 2)) {
+        memcpy(rp, gp + 1, n * sizeof(big_uint));
+        return;
+    }
+    limb_mul_n(tp, ap, bp, n, tp + 2 * n);
+    memcpy(rp, tp + n, n * sizeof(big_uint));
+}
+
+size_t mulhi_scratch_size(size_t n) {
+    return 3 * n + 3 + short_mul_scratch_size(n + 1);
+}
+
+int big_mullo(bigint *X, const bigint *A, const bigint *B, size_t n) {
+    if (X == NULL || A == NULL || B == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    int sign = ((A->signum < 0) != (B->signum < 0)) ? -1 : 1;
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    if (n == 0 || an == 0 || bn == 0) {
+        return big_set_nonzero(X, 0);
+    }
+    an = (an < n) ? an : n;
+    bn = (bn < n) ? bn : n;
+    // Both operands zero-extended to n limbs, only the low n limbs matter
+    big_uint *tp = (big_uint *)calloc(2 * n + short_mul_scratch_size(n), sizeof(big_uint));
+    if (tp == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    big_uint *rp = big_result_buffer(X, A, B, n);
+    if (rp == NULL) {
+        free(tp);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    memcpy(tp, A->data, an * sizeof(big_uint));
+    memcpy(tp + n, B->data, bn * sizeof(big_uint));
+    limb_mullo_n(rp, tp, tp + n, n, tp + 2 * n);
+    free(tp);
+    big_finish_result(X, rp, n, sign);
+    return 0;
+}
+
+int big_mulhi(bigint *X, const bigint *A, const bigint *B, size_t n) {
+    if (X == NULL || A == NULL || B == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    int sign = ((A->signum < 0) != (B->signum < 0)) ? -1 : 1;
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    // The low half only saves work when both operands fit in it
+    if (n == 0 || an > n || bn > n) {
+        int ret = big_mul_auto(X, A, B);
+        return (ret != 0) ? ret : big_bit_shift_right(X, X, 64 * n);
+    }
+    big_uint *tp = (big_uint *)calloc(2 * n + mulhi_scratch_size(n), sizeof(big_uint));
+    if (tp == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    big_uint *rp = big_result_buffer(X, A, B, n);
+    if (rp == NULL) {
+        free(tp);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    memcpy(tp, A->data, an * sizeof(big_uint));
+    memcpy(tp + n, B->data, bn * sizeof(big_uint));
+    limb_mulhi_n_exact(rp, tp, tp + n, n, tp + 2 * n);
+    free(tp);
+    big_finish_result(X, rp, n, sign);
+    return 0;
+}
+
+size_t barrett_scratch_size(size_t n) {
+    return 2 * n + 2 + mulhi_scratch_size(n + 1);
+}
+
+/*
+Reduces {xp, 2n} modulo the n-limb M of ctx into {rp, n}, following HAC
+14.42 with b = 2^64. q = floor(floor(x / b^(n - 1)) * mu / b^(n + 1)) is at
+most 2 below floor(x / M), or 3 if mu had to be capped, so x - q * M is
+below 4M < b^(n + 1) and only its low n + 1 limbs need to be formed. A few
+subtractions of M then finish the job. tp needs barrett_scratch_size(n)
+limbs.
+*/
+void limb_barrett_reduce(big_uint *rp, const big_uint *xp, const big_barrett_ctx *ctx, big_uint *tp) {
+    size_t n = ctx->n;
+    big_uint *qp = tp;
+    big_uint *r = tp + n + 1;
+    limb_mulhi_n_exact(qp, xp + n - 1, ctx->mu, n + 1, tp + 2 * n + 2);
+    limb_mullo_n(r, qp, ctx->M, n + 1, tp + 2 * n + 2);
+    limb_sub_n(r, xp, r, n + 1);
+    while (r[n] != 0 || limb_cmp(r, ctx->M, n) >= 0) {
+        limb_sub_n(r, r, ctx->M, n + 1);
+    }
+    memcpy(rp, r, n * sizeof(big_uint));
+}
+
+int big_barrett_init(big_barrett_ctx *ctx, const bigint *M) {
+    if (ctx == NULL || M == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t n = limb_trimmed_len(M->data, M->num_limbs);
+    if (n == 0 || M->signum < 0) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    ctx->n = n;
+    ctx->M = (big_uint *)malloc((n + 1) * sizeof(big_uint));
+    ctx->mu = (big_uint *)calloc(n + 1, sizeof(big_uint));
+    if (ctx->M == NULL || ctx->mu == NULL) {
+        big_barrett_free(ctx);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    memcpy(ctx->M, M->data, n * sizeof(big_uint));
+    ctx->M[n] = 0;
+
+    // mu = floor(b^2n / M), the only division this context ever needs
+    bigint R2, mu, modulus;
+    big_init(&R2);
+    big_init(&mu);
+    modulus = (bigint){.signum = 1, .num_limbs = n, .alloc = n, .data = ctx->M};
+    int ret = big_reserve(&R2, 2 * n + 1);
+    if (ret == 0) {
+        memset(R2.data, 0, 2 * n * sizeof(big_uint));
+        R2.data[2 * n] = 1;
+        R2.num_limbs = 2 * n + 1;
+        R2.signum = 1;
+        ret = big_div(&mu, NULL, &R2, &modulus);
+    }
+    if (ret == 0) {
+        size_t mn = limb_trimmed_len(mu.data, mu.num_limbs);
+        // Only M = b^(n - 1) gives mu = b^(n + 1), capping it costs one more subtraction
+        if (mn > n + 1) {
+            memset(ctx->mu, 0xff, (n + 1) * sizeof(big_uint));
+        }
+        else {
+            memcpy(ctx->mu, mu.data, mn * sizeof(big_uint));
+        }
+    }
+    big_free(&R2);
+    big_free(&mu);
+    if (ret != 0) {
+        big_barrett_free(ctx);
+    }
+    return ret;
+}
+
+void big_barrett_free(big_barrett_ctx *ctx) {
+    if (ctx == NULL) {
+        return;
+    }
+    free(ctx->M);
+    free(ctx->mu);
+    ctx->M = NULL;
+    ctx->mu = NULL;
+    ctx->n = 0;
+}
+
+int big_barrett_reduce(bigint *X, const bigint *A, const big_barrett_ctx *ctx) {
+    if (X == NULL || A == NULL || ctx == NULL || ctx->M == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t n = ctx->n;
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    big_uint *tp = (big_uint *)malloc((3 * n + barrett_scratch_size(n)) * sizeof(big_uint));
+    if (tp == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    big_uint *xp = tp;
+    big_uint *r = tp + 2 * n;
+
+    // The top 2n limbs of A first, then the rest n limbs at a time below
+    // the remainder so far
+    size_t pos = (an > 2 * n) ? an - 2 * n : 0;
+    memcpy(xp, A->data + pos, (an - pos) * sizeof(big_uint));
+    memset(xp + an - pos, 0, (2 * n - (an - pos)) * sizeof(big_uint));
+    limb_barrett_reduce(r, xp, ctx, tp + 3 * n);
+    while (pos > 0) {
+        size_t step = (pos < n) ? pos : n;
+        pos -= step;
+        memcpy(xp, A->data + pos, step * sizeof(big_uint));
+        memcpy(xp + step, r, n * sizeof(big_uint));
+        memset(xp + step + n, 0, (n - step) * sizeof(big_uint));
+        limb_barrett_reduce(r, xp, ctx, tp + 3 * n);
+    }
+    // A negative A leaves M - r, so the result is never negative
+    if (A->signum < 0 && limb_trimmed_len(r, n) > 0) {
+        limb_sub_n(r, ctx->M, r, n);
+    }
+
+    int ret = big_reserve(X, n);
+    if (ret == 0) {
+        memcpy(X->data, r, n * sizeof(big_uint));
+        big_normalize(X, n, 1);
+    }
+    free(tp);
+    return ret;
+}
+
+// GCD STARTS HERE
+
+/*
+GCDs of operands with at least this many limbs reduce them a sixth at a
+time with the half-GCD, which replaces the quadratic run of Lehmer steps by
+a few products of the operands with its cofactor matrix. Shorter ones go
+straight through Lehmer steps, and so does the half-GCD below it.
+*/
+#ifndef HGCD_THRESHOLD
+#define HGCD_THRESHOLD 500
+#endif
+size_t hgcd_threshold = HGCD_THRESHOLD;
+
+#if HGCD_THRESHOLD < 4
+#error "the half-GCD threshold must be at least 4 limbs"
+#endif
+
+// Binary GCD of two limbs (Stein): the common powers of 2, then repeated subtraction of odd values
+big_uint limb_gcd_1(big_uint a, big_uint b) {
+    if (a == 0 || b == 0) {
+        return a | b;
+    }
+    int shift = __builtin_ctzll(a | b);
+    a >>= __builtin_ctzll(a);
+    while (b != 0) {
+        b >>= __builtin_ctzll(b);
+        if (a > b) {
+            big_uint t = a;
+            a = b;
+            b = t;
+        }
+        b -= a;
+    }
+    return a << shift;
+}
+
+// floor({ap, n} / 2^h), which the caller knows to fit in 128 bits
+big_udbl limb_top_bits(const big_uint *ap, size_t n, size_t h) {
+    size_t i = h / 64;
+    unsigned cnt = h % 64;
+    big_uint l0 = (i < n) ? ap[i] : 0;
+    big_uint l1 = (i + 1 < n) ? ap[i + 1] : 0;
+    big_uint l2 = (i + 2 < n) ? ap[i + 2] : 0;
+    if (cnt == 0) {
+        return ((big_udbl)l1 << 64) | l0;
+    }
+    big_uint lo = (l0 >> cnt) | (l1 << (64 - cnt));
+    big_uint hi = (l1 >> cnt) | (l2 << (64 - cnt));
+    return ((big_udbl)hi << 64) | lo;
+}
+
+size_t big_max_len(const bigint *A, const bigint *B) {
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    return (an > bn) ? an : bn;
+}
+
+// X = |A| with no leading zero limbs, which cmp_abs relies on
+int big_copy_abs(bigint *X, const bigint *A) {
+    int ret = big_copy(X, A);
+    if (ret == 0) {
+        ret = big_reserve(X, 1);
+    }
+    if (ret == 0) {
+        big_normalize(X, X->num_limbs, 1);
+    }
+    return ret;
+}
+
+void big_swap(bigint *X, bigint *Y) {
+    bigint t = *X;
+    *X = *Y;
+    *Y = t;
+}
+
+/*
+Cofactors of Euclid steps taken on the top bits of two numbers A and B:
+(A; B) = L (A'; B') with L = (a b; c d), det L = 1 and every entry below
+2^64, so A' = d * A - b * B and B' = a * B - c * A.
+*/
+typedef struct {
+    big_uint a, b, c, d;
+} lehmer_matrix;
+
+/*
+Runs Euclid's algorithm on x = floor(A / 2^h) and y = floor(B / 2^h), both
+below 2^128, collecting the steps in L, and returns how many it took. The
+low bits x and y leave out put A' between (x' - b) * 2^h and (x' + d) * 2^h,
+and B' likewise, so a step is only taken while x' >= b + lim or y' >= c + lim
+for the number it reduces. Then A' and B' stay at least lim * 2^h and no
+step can take either below 0. If exact is set, h = 0 and only lim counts.
+*/
+size_t lehmer_steps(lehmer_matrix *L, big_udbl x, big_udbl y, big_udbl lim, bool exact) {
+    big_udbl a = 1, b = 0, c = 0, d = 1;
+    size_t steps = 0;
+    for (;;) {
+        bool reduce_x = x >= y;
+        big_udbl num = reduce_x ? x : y;
+        big_udbl den = reduce_x ? y : x;
+        if (den == 0) {
+            break;
+        }
+        // Most quotients are 1 or 2, which need no 128-bit division
+        big_udbl q = 1;
+        big_udbl r = num - den;
+        if (r >= den) {
+            r -= den;
+            q = 2;
+            if (r >= den) {
+                q += r / den;
+                r %= den;
+            }
+        }
+        if (q > UINT64_MAX) {
+            break;
+        }
+        // The column of the number that is reduced gains q times the other
+        big_udbl u = reduce_x ? b + q * a : a + q * b;
+        big_udbl v = reduce_x ? d + q * c : c + q * d;
+        if (u > UINT64_MAX || v > UINT64_MAX || r < (exact ? 0 : (reduce_x ? u : v)) + lim) {
+            break;
+        }
+        if (reduce_x) {
+            x = r;
+            b = u;
+            d = v;
+        }
+        else {
+            y = r;
+            a = u;
+            c = v;
+        }
+        steps++;
+    }
+    L->a = (big_uint)a;
+    L->b = (big_uint)b;
+    L->c = (big_uint)c;
+    L->d = (big_uint)d;
+    return steps;
+}
+
+/*
+Sets up the Lehmer steps for A and B from their top 128 bits, or all of
+them if they are shorter, and returns how many were found. A' and B' are
+kept at least 2^(64s), which s = 0 reduces to keeping them positive.
+*/
+size_t lehmer_steps_for(lehmer_matrix *L, const bigint *A, const bigint *B, size_t s) {
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    size_t bits = (big_bitlen(A) > big_bitlen(B)) ? big_bitlen(A) : big_bitlen(B);
+    size_t h = (bits > 128) ? bits - 128 : 0;
+    big_udbl lim = 1;
+    if (64 * s >= h) {
+        // A bound of 2^127 or more leaves no room for any step
+        if (64 * s - h >= 127) {
+            return 0;
+        }
+        lim = (big_udbl)1 << (64 * s - h);
+    }
+    return lehmer_steps(L, limb_top_bits(A->data, an, h), limb_top_bits(B->data, bn, h), lim, h == 0);
+}
+
+/*
+{rp, n + 1} = x * {ap, an} - y * {bp, bn} for an, bn <= n, when the caller
+knows the difference is not negative.
+*/
+void limb_mul_sub_1(big_uint *rp, size_t n, const big_uint *ap, size_t an, big_uint x,
+                    const big_uint *bp, size_t bn, big_uint y) {
+    memset(rp + an, 0, (n + 1 - an) * sizeof(big_uint));
+    rp[an] = limb_mul_1(rp, ap, an, x);
+    big_uint borrow = limb_submul_1(rp, bp, bn, y);
+    limb_sub_1(rp + bn, rp + bn, n + 1 - bn, borrow);
+}
+
+/*
+(A, B) = (d * A - b * B, a * B - c * A) for positive A and B and a Lehmer
+matrix from lehmer_steps. T1 and T2 are work space whose buffers trade
+places with those of A and B.
+*/
+int lehmer_apply(bigint *A, bigint *B, const lehmer_matrix *L, bigint *T1, bigint *T2) {
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    size_t n = (an > bn) ? an : bn;
+    int ret = big_reserve(T1, n + 1);
+    if (ret == 0) {
+        ret = big_reserve(T2, n + 1);
+    }
+    if (ret != 0) {
+        return ret;
+    }
+    limb_mul_sub_1(T1->data, n, A->data, an, L->d, B->data, bn, L->b);
+    limb_mul_sub_1(T2->data, n, B->data, bn, L->a, A->data, an, L->c);
+    big_normalize(T1, n + 1, 1);
+    big_normalize(T2, n + 1, 1);
+    big_swap(A, T1);
+    big_swap(B, T2);
+    return 0;
+}
+
+/*
+X = x * U + y * V, or x * U - y * V if subtract is set, for U and V of
+either sign. X must be neither of them.
+*/
+int big_comb_ui(bigint *X, big_uint x, const bigint *U, big_uint y, const bigint *V, bool subtract) {
+    size_t un = limb_trimmed_len(U->data, U->num_limbs);
+    size_t vn = limb_trimmed_len(V->data, V->num_limbs);
+    size_t n = ((un > vn) ? un : vn) + 2;
+    int ret = big_reserve(X, n);
+    if (ret != 0) {
+        return ret;
+    }
+    big_uint *xp = X->data;
+    int u_sign = (U->signum < 0) ? -1 : 1;
+    int v_sign = (V->signum < 0) ? -1 : 1;
+    if (subtract) {
+        v_sign = -v_sign;
+    }
+    int sign = u_sign;
+    memset(xp + un, 0, (n - un) * sizeof(big_uint));
+    xp[un] = limb_mul_1(xp, U->data, un, x);
+    if (u_sign == v_sign) {
+        big_uint cy = limb_addmul_1(xp, V->data, vn, y);
+        limb_add_1(xp + vn, xp + vn, n - vn, cy);
+    }
+    else {
+        big_uint borrow = limb_submul_1(xp, V->data, vn, y);
+        if (limb_sub_1(xp + vn, xp + vn, n - vn, borrow) != 0) {
+            limb_neg(xp, xp, n);
+            sign = -u_sign;
+        }
+    }
+    big_normalize(X, n, sign);
+    return 0;
+}
+
+// X = A * B + C * D, or A * B - C * D if subtract is set. X must be none of them.
+int big_mul_comb(bigint *X, const bigint *A, const bigint *B, const bigint *C, const bigint *D,
+                 bool subtract) {
+    int ret = big_mul_auto(X, A, B);
+    if (ret == 0) {
+        ret = big_addmul_signed(X, C, D, subtract);
+    }
+    return ret;
+}
+
+/*
+Cofactors of a half-GCD: (A; B) = M (A'; B') for the numbers it started
+from and the ones it reduced them to. M = (m00 m01; m10 m11) is a product of
+Euclid steps, so its entries are not negative and det M = 1, which gives
+A' = m11 * A - m01 * B and B' = m00 * B - m10 * A.
+*/
+typedef struct {
+    bigint m00, m01, m10, m11;
+} hgcd_matrix;
+
+void hgcd_matrix_free(hgcd_matrix *M) {
+    big_free(&M->m00);
+    big_free(&M->m01);
+    big_free(&M->m10);
+    big_free(&M->m11);
+}
+
+// Sets M to the identity, M must be freed even if this fails
+int hgcd_matrix_init(hgcd_matrix *M) {
+    big_init(&M->m00);
+    big_init(&M->m01);
+    big_init(&M->m10);
+    big_init(&M->m11);
+    int ret = big_set_nonzero(&M->m00, 1);
+    if (ret == 0) {
+        ret = big_set_nonzero(&M->m01, 0);
+    }
+    if (ret == 0) {
+        ret = big_set_nonzero(&M->m10, 0);
+    }
+    if (ret == 0) {
+        ret = big_set_nonzero(&M->m11, 1);
+    }
+    return ret;
+}
+
+/*
+M = M * L for a Lehmer matrix. Row by row, (m00, m01) becomes
+(a * m00 + c * m01, b * m00 + d * m01). T1 and T2 are work space.
+*/
+int hgcd_matrix_mul_1(hgcd_matrix *M, const lehmer_matrix *L, bigint *T1, bigint *T2) {
+    bigint *rows[2][2] = {{&M->m00, &M->m01}, {&M->m10, &M->m11}};
+    int ret = 0;
+    for (int i = 0; i < 2 && ret == 0; i++) {
+        ret = big_comb_ui(T1, L->a, rows[i][0], L->c, rows[i][1], false);
+        if (ret == 0) {
+            ret = big_comb_ui(T2, L->b, rows[i][0], L->d, rows[i][1], false);
+        }
+        if (ret == 0) {
+            big_swap(rows[i][0], T1);
+            big_swap(rows[i][1], T2);
+        }
+    }
+    return ret;
+}
+
+// M = M * N, eight products of the entries
+int hgcd_matrix_mul(hgcd_matrix *M, const hgcd_matrix *N) {
+    bigint *rows[2][2] = {{&M->m00, &M->m01}, {&M->m10, &M->m11}};
+    bigint X0, X1;
+    big_init(&X0);
+    big_init(&X1);
+    int ret = 0;
+    for (int i = 0; i < 2 && ret == 0; i++) {
+        ret = big_mul_comb(&X0, rows[i][0], &N->m00, rows[i][1], &N->m10, false);
+        if (ret == 0) {
+            ret = big_mul_comb(&X1, rows[i][0], &N->m01, rows[i][1], &N->m11, false);
+        }
+        if (ret == 0) {
+            big_swap(rows[i][0], &X0);
+            big_swap(rows[i][1], &X1);
+        }
+    }
+    big_free(&X0);
+    big_free(&X1);
+    return ret;
+}
+
+/*
+One step of the half-GCD on A and B of more than s limbs each: Lehmer steps
+that keep both at least 2^(64s), or when there are none, a division of the
+larger by the smaller with the quotient cut down to keep the remainder at
+least 2^(64s) too. The steps are added to M. Returns 1 if A and B were
+reduced, 0 if they are as far as they go, or an error code.
+*/
+int hgcd_step(hgcd_matrix *M, bigint *A, bigint *B, size_t s, bigint *T1, bigint *T2) {
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+    if (an <= s || bn <= s) {
+        return 0;
+    }
+    lehmer_matrix L;
+    if (lehmer_steps_for(&L, A, B, s) > 0) {
+        int ret = lehmer_apply(A, B, &L, T1, T2);
+        if (ret == 0) {
+            ret = hgcd_matrix_mul_1(M, &L, T1, T2);
+        }
+        return (ret == 0) ? 1 : ret;
+    }
+
+    // q = floor((X - 2^(64s)) / Y) leaves X - q * Y at least 2^(64s)
+    bool reduce_a = cmp_abs(A, B) >= 0;
+    bigint *X = reduce_a ? A : B;
+    bigint *Y = reduce_a ? B : A;
+    bigint Q;
+    big_init(&Q);
+    int ret = big_copy(T1, X);
+    if (ret == 0) {
+        limb_sub_1(T1->data + s, T1->data + s, T1->num_limbs - s, 1);
+        big_normalize(T1, T1->num_limbs, 1);
+        ret = big_div(&Q, NULL, T1, Y);
+    }
+    bool progress = ret == 0 && !big_is_zero(&Q);
+    if (progress) {
+        ret = big_mul_auto(T1, &Q, Y);
+    }
+    if (progress && ret == 0) {
+        ret = big_sub(X, X, T1);
+    }
+    // The column of the number that is reduced gains q times the other
+    if (progress && ret == 0) {
+        ret = big_mul_auto(T1, &Q, reduce_a ? &M->m00 : &M->m01);
+    }
+    if (progress && ret == 0) {
+        ret = big_add(reduce_a ? &M->m01 : &M->m00, reduce_a ? &M->m01 : &M->m00, T1);
+    }
+    if (progress && ret == 0) {
+        ret = big_mul_auto(T1, &Q, reduce_a ? &M->m10 : &M->m11);
+    }
+    if (progress && ret == 0) {
+        ret = big_add(reduce_a ? &M->m11 : &M->m10, reduce_a ? &M->m11 : &M->m10, T1);
+    }
+    big_free(&Q);
+    if (ret != 0) {
+        return ret;
+    }
+    return progress ? 1 : 0;
+}
+
+int hgcd(hgcd_matrix *M, bigint *A, bigint *B);
+
+/*
+Reduces A and B through a half-GCD of the parts above their low p limbs.
+With A = A1 * 2^(64p) + A0 and B split alike, the matrix N that takes A1
+and B1 to A1' and B1' takes A and B to A1' * 2^(64p) + m11 * A0 - m01 * B0
+and B1' * 2^(64p) + m00 * B0 - m10 * A0. Those are not negative because N
+is small next to A1' and B1', but they are checked anyway before A and B are
+replaced and M becomes M * N. Returns 1 if A and B were reduced, 0 if not,
+or an error code.
+*/
+int hgcd_part(hgcd_matrix *M, bigint *A, bigint *B, size_t p) {
+    bigint A1, B1, A0, B0, X, Y, T;
+    big_init(&A1);
+    big_init(&B1);
+    big_init(&A0);
+    big_init(&B0);
+    big_init(&X);
+    big_init(&Y);
+    big_init(&T);
+    hgcd_matrix N;
+    int ret = hgcd_matrix_init(&N);
+    if (ret == 0) {
+        ret = big_bit_shift_right(&A1, A, 64 * p);
+    }
+    if (ret == 0) {
+        ret = big_bit_shift_right(&B1, B, 64 * p);
+    }
+    if (ret == 0) {
+        ret = big_copy(&A0, A);
+    }
+    if (ret == 0) {
+        ret = big_copy(&B0, B);
+    }
+    int reduced = 0;
+    if (ret == 0) {
+        big_normalize(&A0, (A0.num_limbs < p) ? A0.num_limbs : p, 1);
+        big_normalize(&B0, (B0.num_limbs < p) ? B0.num_limbs : p, 1);
+        reduced = hgcd(&N, &A1, &B1);
+        ret = (reduced < 0) ? reduced : 0;
+    }
+    if (reduced > 0) {
+        ret = big_mul_comb(&X, &N.m11, &A0, &N.m01, &B0, true);
+        if (ret == 0) {
+            ret = big_mul_comb(&Y, &N.m00, &B0, &N.m10, &A0, true);
+        }
+        if (ret == 0) {
+            big_shift_left(&T, &A1, p);
+            ret = big_add(&X, &X, &T);
+        }
+        if (ret == 0) {
+            big_shift_left(&T, &B1, p);
+            ret = big_add(&Y, &Y, &T);
+        }
+        if (ret == 0 && (X.signum < 0 || Y.signum < 0 || big_is_zero(&X) || big_is_zero(&Y))) {
+            reduced = 0;
+        }
+        if (ret == 0 && reduced > 0) {
+            big_swap(A, &X);
+            big_swap(B, &Y);
+            ret = hgcd_matrix_mul(M, &N);
+        }
+    }
+    hgcd_matrix_free(&N);
+    big_free(&A1);
+    big_free(&B1);
+    big_free(&A0);
+    big_free(&B0);
+    big_free(&X);
+    big_free(&Y);
+    big_free(&T);
+    return (ret != 0) ? ret : reduced;
+}
+
+/*
+Half-GCD after Moller and GMP's mpn_hgcd. For A and B of at most n limbs,
+reduces them by Euclid steps as long as both stay at least 2^(64s) with
+s = n / 2 + 1, which leaves them about half as long, and sets M so that
+(A; B) = M (A'; B') for the A and B it was called with, multiplying M by
+the matrix of those steps like hgcd_step does. From hgcd_threshold limbs up, a
+recursive half-GCD of the top half of A and B takes them down to about 3n/4
+limbs, single steps to at most 3n/4 + 1, and a second recursive call on
+their top 2(n - s) limbs or so close most of the remaining gap; single
+steps finish the job either way. Returns 1 if A and B were reduced, 0 if
+either was below 2^(64s) to begin with, or an error code.
+*/
+int hgcd(hgcd_matrix *M, bigint *A, bigint *B) {
+    size_t n = big_max_len(A, B);
+    size_t s = n / 2 + 1;
+    if (limb_trimmed_len(A->data, A->num_limbs) <= s || limb_trimmed_len(B->data, B->num_limbs) <= s) {
+        return 0;
+    }
+    bigint T1, T2;
+    big_init(&T1);
+    big_init(&T2);
+    int reduced = 0;
+    int step = 1;
+    if (n >= hgcd_threshold) {
+        step = hgcd_part(M, A, B, n / 2);
+        reduced = (step > 0);
+        step = (step < 0) ? step : 1;
+        while (step > 0 && big_max_len(A, B) > 3 * n / 4 + 1) {
+            step = hgcd_step(M, A, B, s, &T1, &T2);
+            reduced |= (step > 0);
+        }
+        size_t nn = big_max_len(A, B);
+        if (step > 0 && nn > s + 2) {
+            step = hgcd_part(M, A, B, 2 * s - nn + 1);
+            reduced |= (step > 0);
+            step = (step < 0) ? step : 1;
+        }
+    }
+    while (step > 0) {
+        step = hgcd_step(M, A, B, s, &T1, &T2);
+        reduced |= (step > 0);
+    }
+    big_free(&T1);
+    big_free(&T2);
+    return (step < 0) ? step : reduced;
+}
+
+/*
+Reduces A >= 0 and B >= 0 until one of them is 0, which leaves their GCD in
+the other. U0 and U1 track cofactors if they are not NULL: started at 1 and
+0, they keep A = U0 * A_start and B = U1 * A_start modulo B_start. Long
+operands lose a sixth of their limbs per half-GCD of their top third,
+shorter ones a limb or so per round of Lehmer steps, and a plain division
+step is taken whenever neither gets anywhere, mostly for unbalanced sizes.
+Without cofactors, the last limb is left to limb_gcd_1.
+*/
+int gcd_reduce(bigint *A, bigint *B, bigint *U0, bigint *U1) {
+    bigint T1, T2, Q, R;
+    big_init(&T1);
+    big_init(&T2);
+    big_init(&Q);
+    big_init(&R);
+    int ret = 0;
+    while (ret == 0) {
+        size_t an = limb_trimmed_len(A->data, A->num_limbs);
+        size_t bn = limb_trimmed_len(B->data, B->num_limbs);
+        if (an == 0 || bn == 0) {
+            break;
+        }
+        if (U0 == NULL && (an == 1 || bn == 1)) {
+            bigint *X = (an == 1) ? A : B;
+            bigint *Y = (an == 1) ? B : A;
+            size_t yn = (an == 1) ? bn : an;
+            big_uint g = limb_gcd_1(X->data[0], limb_mod_1(Y->data, yn, X->data[0]));
+            ret = big_set_nonzero(X, g);
+            if (ret == 0) {
+                ret = big_set_nonzero(Y, 0);
+            }
+            break;
+        }
+        size_t n = (an > bn) ? an : bn;
+        int reduced = 0;
+        if (n >= hgcd_threshold) {
+            hgcd_matrix M;
+            reduced = hgcd_matrix_init(&M);
+            if (reduced == 0) {
+                reduced = hgcd_part(&M, A, B, 2 * n / 3);
+            }
+            if (reduced > 0 && U0 != NULL) {
+                ret = big_mul_comb(&T1, &M.m11, U0, &M.m01, U1, true);
+                if (ret == 0) {
+                    ret = big_mul_comb(&T2, &M.m00, U1, &M.m10, U0, true);
+                }
+                if (ret == 0) {
+                    big_swap(U0, &T1);
+                    big_swap(U1, &T2);
+                }
+            }
+            hgcd_matrix_free(&M);
+            if (reduced < 0) {
+                ret = reduced;
+            }
+        }
+        if (ret != 0 || reduced > 0) {
+            continue;
+        }
+        lehmer_matrix L;
+        if (lehmer_steps_for(&L, A, B, 0) > 0) {
+            ret = lehmer_apply(A, B, &L, &T1, &T2);
+            if (ret == 0 && U0 != NULL) {
+                ret = big_comb_ui(&T1, L.d, U0, L.b, U1, true);
+                if (ret == 0) {
+                    ret = big_comb_ui(&T2, L.a, U1, L.c, U0, true);
+                }
+                if (ret == 0) {
+                    big_swap(U0, &T1);
+                    big_swap(U1, &T2);
+                }
+            }
+            continue;
+        }
+        // Division step, the larger of A and B is replaced by its remainder
+        bool reduce_a = cmp_abs(A, B) >= 0;
+        bigint *X = reduce_a ? A : B;
+        bigint *Y = reduce_a ? B : A;
+        ret = big_div((U0 != NULL) ? &Q : NULL, &R, X, Y);
+        if (ret == 0) {
+            big_swap(X, &R);
+        }
+        if (ret == 0 && U0 != NULL) {
+            bigint *UX = reduce_a ? U0 : U1;
+            bigint *UY = reduce_a ? U1 : U0;
+            ret = big_mul_auto(&T1, &Q, UY);
+            if (ret == 0) {
+                ret = big_sub(UX, UX, &T1);
+            }
+        }
+    }
+    big_free(&T1);
+    big_free(&T2);
+    big_free(&Q);
+    big_free(&R);
+    return ret;
+}
+
+int big_gcd(bigint *G, const bigint *A, const bigint *B) {
+    if (G == NULL || A == NULL || B == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    bigint X, Y;
+    big_init(&X);
+    big_init(&Y);
+    int ret = big_copy_abs(&X, A);
+    if (ret == 0) {
+        ret = big_copy_abs(&Y, B);
+    }
+    if (ret == 0) {
+        ret = gcd_reduce(&X, &Y, NULL, NULL);
+    }
+    if (ret == 0) {
+        big_swap(G, big_is_zero(&X) ? &Y : &X);
+    }
+    big_free(&X);
+    big_free(&Y);
+    return ret;
+}
+
+int big_gcdext(bigint *G, bigint *S, bigint *T, const bigint *A, const bigint *B) {
+    if (A == NULL || B == NULL || (G != NULL && (G == S || G == T)) || (S != NULL && S == T)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    bigint X, Y, U0, U1, V, W;
+    big_init(&X);
+    big_init(&Y);
+    big_init(&U0);
+    big_init(&U1);
+    big_init(&V);
+    big_init(&W);
+    int ret = big_copy_abs(&X, A);
+    if (ret == 0) {
+        ret = big_copy_abs(&Y, B);
+    }
+    if (ret == 0) {
+        ret = big_set_nonzero(&U0, 1);
+    }
+    if (ret == 0) {
+        ret = big_set_nonzero(&U1, 0);
+    }
+    if (ret == 0) {
+        ret = gcd_reduce(&X, &Y, &U0, &U1);
+    }
+    // The GCD is whichever is left, with its cofactor for |A|
+    bigint *g = big_is_zero(&X) ? &Y : &X;
+    bigint *s = big_is_zero(&X) ? &U1 : &U0;
+    if (ret == 0 && big_is_zero(g)) {
+        big_normalize(s, 0, 1);
+    }
+    // t = (g - s * |A|) / |B|, exactly, or 0 if B = 0
+    if (ret == 0 && T != NULL) {
+        ret = big_mul_auto(&W, s, A);
+        if (ret == 0) {
+            if (A->signum < 0 && !big_is_zero(&W)) {
+                W.signum = -W.signum;
+            }
+            ret = big_sub(&W, g, &W);
+        }
+        if (ret == 0 && big_is_zero(B)) {
+            ret = big_set_nonzero(&V, 0);
+        }
+        else if (ret == 0) {
+            ret = big_div(&V, NULL, &W, B);
+        }
+    }
+    if (ret == 0 && A->signum < 0 && !big_is_zero(s)) {
+        s->signum = -s->signum;
+    }
+    if (ret == 0 && T != NULL) {
+        big_swap(T, &V);
+    }
+    if (ret == 0 && S != NULL) {
+        big_swap(S, s);
+    }
+    if (ret == 0 && G != NULL) {
+        big_swap(G, g);
+    }
+    big_free(&X);
+    big_free(&Y);
+    big_free(&U0);
+    big_free(&U1);
+    big_free(&V);
+    big_free(&W);
+    return ret;
+}
+
+int big_invmod(bigint *X, const bigint *A, const bigint *N) {
+    if (X == NULL || A == NULL || N == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (N->signum < 0 || big_is_zero(N)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    bigint R, G, S;
+    big_init(&R);
+    big_init(&G);
+    big_init(&S);
+    int ret = big_div(NULL, &R, A, N);
+    if (ret == 0) {
+        R.signum = 1;
+        ret = big_gcdext(&G, &S, NULL, &R, N);
+    }
+    if (ret == 0 && (G.num_limbs != 1 || G.data[0] != 1)) {
+        ret = ERR_BIGINT_NOT_ACCEPTABLE;
+    }
+    // A remainder r = -|r| of a negative A needs the inverse of N - |r|, which is -s
+    if (ret == 0 && A->signum < 0 && !big_is_zero(&S)) {
+        S.signum = -S.signum;
+    }
+    if (ret == 0 && S.signum < 0) {
+        ret = big_add(&S, &S, N);
+    }
+    if (ret == 0) {
+        big_swap(X, &S);
+    }
+    big_free(&R);
+    big_free(&G);
+    big_free(&S);
+    return ret;
+}
+
+/*
+Montgomery's trick: with the prefix products P_i = A_0 * ... * A_i mod N,
+one inversion gives 1 / P_(count - 1), and walking back down,
+1 / A_i = P_(i - 1) / P_i and 1 / P_(i - 1) = A_i / P_i. That is three
+multiplications per element besides the single inversion, all reduced with
+one Barrett context.
+*/
+int big_invmod_batch(bigint *X, const bigint *A, size_t count, const bigint *N) {
+    if (X == NULL || A == NULL || N == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (count == 0) {
+        return 0;
+    }
+    big_barrett_ctx ctx;
+    int ret = big_barrett_init(&ctx, N);
+    if (ret != 0) {
+        return ret;
+    }
+    bigint *prefix = (bigint *)malloc(count * sizeof(bigint));
+    if (prefix == NULL) {
+        big_barrett_free(&ctx);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    for (size_t i = 0; i < count; i++) {
+        big_init(&prefix[i]);
+    }
+    bigint inv, next, P;
+    big_init(&inv);
+    big_init(&next);
+    big_init(&P);
+
+    ret = big_barrett_reduce(&prefix[0], &A[0], &ctx);
+    for (size_t i = 1; i < count && ret == 0; i++) {
+        ret = big_mul_auto(&P, &prefix[i - 1], &A[i]);
+        if (ret == 0) {
+            ret = big_barrett_reduce(&prefix[i], &P, &ctx);
+        }
+    }
+    // Fails if any A_i shares a factor with N
+    if (ret == 0) {
+        ret = big_invmod(&inv, &prefix[count - 1], N);
+    }
+    // X may be A, so A_i is read before X_i is written
+    for (size_t i = count - 1; i > 0 && ret == 0; i--) {
+        ret = big_mul_auto(&P, &inv, &A[i]);
+        if (ret == 0) {
+            ret = big_barrett_reduce(&next, &P, &ctx);
+        }
+        if (ret == 0) {
+            ret = big_mul_auto(&P, &inv, &prefix[i - 1]);
+        }
+        if (ret == 0) {
+            ret = big_barrett_reduce(&X[i], &P, &ctx);
+        }
+        big_swap(&inv, &next);
+    }
+    if (ret == 0) {
+        big_swap(&X[0], &inv);
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        big_free(&prefix[i]);
+    }
+    free(prefix);
+    big_free(&inv);
+    big_free(&next);
+    big_free(&P);
+    big_barrett_free(&ctx);
+    return ret;
+}
+
+// PRODUCT TREES STARTS HERE
+
+/*
+A tree over count leaves has the leaves at level 0, and each level above
+pairs up the nodes of the one below, carrying an odd last node up as it is,
+until a single root remains. The nodes are stored level by level, about
+2 * count of them.
+*/
+size_t tree_levels(size_t count) {
+    size_t levels = 1;
+    while (count > 1) {
+        count = (count + 1) / 2;
+        levels++;
+    }
+    return levels;
+}
+
+// A read-only bigint over n limbs of an arena, with room for alloc of them
+bigint tree_node(big_uint *data, size_t n, size_t alloc) {
+    return (bigint){.signum = 1, .num_limbs = n, .alloc = alloc, .data = data};
+}
+
+void big_tree_free(big_tree *T) {
+    if (T == NULL) {
+        return;
+    }
+    free(T->start);
+    free(T->nodes);
+    free(T->arena);
+    T->start = NULL;
+    T->nodes = NULL;
+    T->arena = NULL;
+    T->count = 0;
+    T->levels = 0;
+}
+
+// Sets up the level layout of T for count leaves and allocates all but the arena
+int tree_alloc(big_tree *T, size_t count) {
+    T->count = count;
+    T->levels = tree_levels(count);
+    T->start = (size_t *)malloc((T->levels + 1) * sizeof(size_t));
+    T->nodes = NULL;
+    T->arena = NULL;
+    if (T->start == NULL) {
+        big_tree_free(T);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    size_t k = 0;
+    for (size_t l = 0, width = count; l < T->levels; l++, width = (width + 1) / 2) {
+        T->start[l] = k;
+        k += width;
+    }
+    T->start[T->levels] = k;
+    T->nodes = (bigint *)malloc(k * sizeof(bigint));
+    if (T->nodes == NULL) {
+        big_tree_free(T);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    return 0;
+}
+
+/*
+Every level of the tree takes at most as many limbs as the leaves together,
+since a product has at most the limbs of its two factors, so one arena of
+levels times that many limbs holds them all. The products go through
+limb_mul, which picks Karatsuba, Toom-Cook or the FFT as the nodes grow,
+with one scratch buffer grown along the way.
+*/
+int big_product_tree(big_tree *T, const bigint *X, size_t count) {
+    if (T == NULL || X == NULL || count == 0) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        size_t n = limb_trimmed_len(X[i].data, X[i].num_limbs);
+        if (n == 0 || X[i].signum < 0) {
+            return ERR_BIGINT_BAD_INPUT_DATA;
+        }
+        total += n;
+    }
+    int ret = tree_alloc(T, count);
+    if (ret != 0) {
+        return ret;
+    }
+    T->arena = (big_uint *)malloc(T->levels * total * sizeof(big_uint));
+    if (T->arena == NULL) {
+        big_tree_free(T);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+
+    big_uint *slot = T->arena;
+    for (size_t i = 0; i < count; i++) {
+        size_t n = limb_trimmed_len(X[i].data, X[i].num_limbs);
+        memcpy(slot, X[i].data, n * sizeof(big_uint));
+        T->nodes[i] = tree_node(slot, n, n);
+        slot += n;
+    }
+    big_uint *tp = NULL;
+    size_t tp_size = 0;
+    for (size_t l = 1; l < T->levels && ret == 0; l++) {
+        size_t first = T->start[l - 1];
+        size_t width = T->start[l] - first;
+        size_t k = T->start[l];
+        for (size_t i = 0; i < width; i += 2) {
+            const bigint *a = &T->nodes[first + i];
+            if (i + 1 == width) {
+                memcpy(slot, a->data, a->num_limbs * sizeof(big_uint));
+                T->nodes[k++] = tree_node(slot, a->num_limbs, a->num_limbs);
+                slot += a->num_limbs;
+                break;
+            }
+            const bigint *b = &T->nodes[first + i + 1];
+            size_t n = a->num_limbs + b->num_limbs;
+            size_t need = big_mul_scratch_size(a->num_limbs, b->num_limbs);
+            if (need > tp_size) {
+                free(tp);
+                tp = (big_uint *)malloc(need * sizeof(big_uint));
+                tp_size = need;
+                if (tp == NULL) {
+                    ret = ERR_BIGINT_ALLOC_FAILED;
+                    break;
+                }
+            }
+            limb_mul(slot, a->data, a->num_limbs, b->data, b->num_limbs, tp);
+            T->nodes[k++] = tree_node(slot, limb_trimmed_len(slot, n), n);
+            slot += n;
+        }
+    }
+    free(tp);
+    if (ret != 0) {
+        big_tree_free(T);
+    }
+    return ret;
+}
+
+/*
+Works down from the root: the root takes A mod the root of T, and every
+other node the remainder of its parent modulo its own node of T. Each
+remainder is below its node, so the arena needs no more limbs than T's
+nodes have.
+*/
+int big_remainder_tree(big_tree *R, const big_tree *T, const bigint *A) {
+    if (R == NULL || T == NULL || A == NULL || R == T || T->nodes == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (A->signum < 0 && !big_is_zero(A)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    int ret = tree_alloc(R, T->count);
+    if (ret != 0) {
+        return ret;
+    }
+    size_t total = 0;
+    for (size_t k = 0; k < T->start[T->levels]; k++) {
+        total += T->nodes[k].num_limbs;
+    }
+    R->arena = (big_uint *)malloc(total * sizeof(big_uint));
+    if (R->arena == NULL) {
+        big_tree_free(R);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    big_uint *slot = R->arena;
+    for (size_t k = 0; k < T->start[T->levels]; k++) {
+        R->nodes[k] = tree_node(slot, 0, T->nodes[k].num_limbs);
+        slot += T->nodes[k].num_limbs;
+    }
+
+    bigint rem;
+    big_init(&rem);
+    for (size_t l = T->levels; l-- > 0 && ret == 0;) {
+        for (size_t i = 0; i < T->start[l + 1] - T->start[l]; i++) {
+            size_t k = T->start[l] + i;
+            const bigint *parent = (l + 1 == T->levels) ? A : &R->nodes[T->start[l + 1] + i / 2];
+            ret = big_div(NULL, &rem, parent, &T->nodes[k]);
+            if (ret != 0) {
+                break;
+            }
+            size_t n = limb_trimmed_len(rem.data, rem.num_limbs);
+            memcpy(R->nodes[k].data, rem.data, n * sizeof(big_uint));
+            R->nodes[k].num_limbs = n;
+        }
+    }
+    big_free(&rem);
+    if (ret != 0) {
+        big_tree_free(R);
+    }
+    return ret;
+}
+
+/*
+Bernstein's batch GCD: with P the product of all N[j] at the root, the
+remainders go down the tree modulo the squares of the nodes, so each leaf
+gets P mod N[i]^2. That is N[i] times the product of the others modulo N[i],
+and one exact division and one ordinary GCD per leaf finish the job. Only
+two levels of remainders are alive at a time.
+*/
+int big_batch_gcd(bigint *G, const bigint *N, size_t count) {
+    if (G == NULL || N == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    big_tree T;
+    int ret = big_product_tree(&T, N, count);
+    if (ret != 0) {
+        return ret;
+    }
+    bigint *cur = (bigint *)malloc(count * sizeof(bigint));
+    bigint *next = (bigint *)malloc(count * sizeof(bigint));
+    if (cur == NULL || next == NULL) {
+        free(cur);
+        free(next);
+        big_tree_free(&T);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    for (size_t i = 0; i < count; i++) {
+        big_init(&cur[i]);
+        big_init(&next[i]);
+    }
+    bigint sq;
+    big_init(&sq);
+
+    // P mod P^2 is P itself
+    ret = big_copy(&cur[0], &T.nodes[T.start[T.levels - 1]]);
+    for (size_t l = T.levels - 1; l-- > 0 && ret == 0;) {
+        for (size_t i = 0; i < T.start[l + 1] - T.start[l] && ret == 0; i++) {
+            ret = big_sqr(&sq, &T.nodes[T.start[l] + i]);
+            if (ret == 0) {
+                ret = big_div(NULL, &next[i], &cur[i / 2], &sq);
+            }
+        }
+        bigint *t = cur;
+        cur = next;
+        next = t;
+    }
+    for (size_t i = 0; i < count && ret == 0; i++) {
+        ret = big_div(&next[i], NULL, &cur[i], &T.nodes[i]);
+        if (ret == 0) {
+            ret = big_gcd(&G[i], &next[i], &T.nodes[i]);
+        }
+    }
+
+    for (size_t i = 0; i < count; i++) {
+        big_free(&cur[i]);
+        big_free(&next[i]);
+    }
+    free(cur);
+    free(next);
+    big_free(&sq);
+    big_tree_free(&T);
+    return ret;
+}
+
+// ROOTS STARTS HERE
+
+// X = A^e for e >= 1 by repeated squaring, X must not be A
+int big_pow_ui(bigint *X, const bigint *A, big_uint e) {
+    int ret = big_copy(X, A);
+    for (int i = 62 - __builtin_clzll(e); i >= 0 && ret == 0; i--) {
+        ret = big_sqr(X, X);
+        if (ret == 0 && ((e >> i) & 1)) {
+            ret = big_mul_auto(X, X, A);
+        }
+    }
+    return ret;
+}
+
+// floor(a^(1/k)) for 2 <= k < 64, bit by bit with the powers checked for overflow
+big_uint root_limb(big_uint a, big_uint k, big_uint *power) {
+    big_uint x = 0;
+    big_uint xk = 0;
+    for (int i = (63 - __builtin_clzll(a)) / k; i >= 0; i--) {
+        big_uint y = x | ((big_uint)1 << i);
+        big_uint yk = 1;
+        // A separate flag, a + 1 would wrap to 0 for a = 2^64 - 1
+        bool over = false;
+        for (big_uint j = 0; j < k && !over; j++) {
+            over = __builtin_mul_overflow(yk, y, &yk) || yk > a;
+        }
+        if (!over) {
+            x = y;
+            xk = yk;
+        }
+    }
+    *power = xk;
+    return x;
+}
+
+/*
+X = floor(A^(1/k)) for A > 0 and k >= 2, leaving P = X^k. T and Q are
+scratch. The root has at most r bits. Its top half comes from the root of A
+shifted right by k * t bits, shifted back left by t, which is at most the
+true root and off by less than about 2^t. One Newton step
+X = ((k - 1) * X + A / X^(k - 1)) / k roughly squares that error, so with t
+a little under half of r it lands within 1 of the root, and each level of
+the recursion works at twice the precision of the one below: the whole root
+costs a few divisions and powers at full size. Integer Newton steps never
+go below the floor of the root, so from there on X is too large only while
+X^k > A, and every further step brings it down. Short roots are found bit
+by bit instead, within a limb if A fits in one, since Newton converges
+slowly from far off for large k.
+*/
+int root_rec(bigint *X, bigint *P, const bigint *A, big_uint k, bigint *T, bigint *Q) {
+    size_t b = big_bitlen(A);
+    // 2^(b - 1) <= A < 2^b <= 2^k, so the root is 1
+    if (k >= b) {
+        int ret = big_set_nonzero(X, 1);
+        return (ret == 0) ? big_set_nonzero(P, 1) : ret;
+    }
+    if (b <= 64) {
+        big_uint power;
+        int ret = big_set_nonzero(X, root_limb(A->data[0], k, &power));
+        return (ret == 0) ? big_set_nonzero(P, power) : ret;
+    }
+    size_t r = (b + k - 1) / k;
+    size_t guard = 65 - __builtin_clzll(k);
+    size_t t = (r > guard + 1) ? (r - guard) / 2 : 0;
+    int ret = 0;
+    if (t == 0) {
+        ret = big_set_nonzero(X, 0);
+        for (size_t i = r; i-- > 0 && ret == 0;) {
+            ret = big_set_nonzero(T, 1);
+            if (ret == 0) {
+                ret = big_bit_shift_left(T, T, i);
+            }
+            if (ret == 0) {
+                ret = big_add(T, T, X);
+            }
+            if (ret == 0) {
+                ret = big_pow_ui(P, T, k);
+            }
+            if (ret == 0 && big_cmp(P, A) <= 0) {
+                big_swap(X, T);
+            }
+        }
+    }
+    else {
+        bigint B;
+        big_init(&B);
+        ret = big_bit_shift_right(&B, A, k * t);
+        if (ret == 0) {
+            ret = root_rec(X, P, &B, k, T, Q);
+        }
+        big_free(&B);
+        if (ret == 0) {
+            ret = big_bit_shift_left(X, X, t);
+        }
+    }
+
+    // The first step from below always runs, after that only while X^k > A
+    bool above = (t == 0);
+    while (ret == 0) {
+        const bigint *D = X;
+        if (k > 2) {
+            ret = big_pow_ui(T, X, k - 1);
+            D = T;
+        }
+        if (ret == 0 && above) {
+            ret = (k == 2) ? big_sqr(P, X) : big_mul_auto(P, T, X);
+            if (ret == 0 && big_cmp(P, A) <= 0) {
+                break;
+            }
+        }
+        if (ret == 0) {
+            ret = big_div(Q, NULL, A, D);
+        }
+        if (ret == 0) {
+            ret = big_comb_ui(T, k - 1, X, 1, Q, false);
+        }
+        if (ret == 0) {
+            ret = (k == 2) ? big_bit_shift_right(X, T, 1) : big_div_ui(X, NULL, T, k);
+        }
+        above = true;
+    }
+    return ret;
+}
+
+/*
+X = A^(1/k) rounded towards zero and, if R is not NULL, R = A - X^k, for
+k >= 2. The results go to temporaries first, so X and R may alias A.
+*/
+int root_rem(bigint *X, bigint *R, const bigint *A, big_uint k) {
+    if (X == NULL || A == NULL || X == R || k == 0) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    bool negative = (A->signum < 0 && !big_is_zero(A));
+    if (negative && k % 2 == 0) {
+        return ERR_BIGINT_NEGATIVE_VALUE;
+    }
+    if (big_is_zero(A) || k == 1) {
+        int ret = big_copy(X, A);
+        return (ret == 0 && R != NULL) ? big_set_nonzero(R, 0) : ret;
+    }
+    bigint root, P, T, Q;
+    big_init(&root);
+    big_init(&P);
+    big_init(&T);
+    big_init(&Q);
+    bigint magnitude = {.signum = 1, .num_limbs = A->num_limbs, .alloc = A->alloc, .data = A->data};
+    int ret = root_rec(&root, &P, &magnitude, k, &T, &Q);
+    if (ret == 0 && R != NULL) {
+        ret = big_sub(&T, &magnitude, &P);
+        if (negative) {
+            T.signum = -T.signum;
+        }
+    }
+    if (ret == 0 && R != NULL) {
+        big_swap(R, &T);
+    }
+    if (ret == 0) {
+        big_swap(X, &root);
+        if (negative) {
+            X->signum = -1;
+        }
+    }
+    big_free(&root);
+    big_free(&P);
+    big_free(&T);
+    big_free(&Q);
+    return ret;
+}
+
+int big_sqrt(bigint *S, const bigint *A) {
+    return root_rem(S, NULL, A, 2);
+}
+
+int big_sqrtrem(bigint *S, bigint *R, const bigint *A) {
+    return root_rem(S, R, A, 2);
+}
+
+int big_root(bigint *X, const bigint *A, big_uint k) {
+    return root_rem(X, NULL, A, k);
+}
+
+int big_rootrem(bigint *X, bigint *R, const bigint *A, big_uint k) {
+    return root_rem(X, R, A, k);
+}
+
+// FACTORIALS AND PI STARTS HERE
+
+/*
+X = (lo + 1) * (lo + 2) * ... * hi, which is 1 for lo >= hi. Long ranges are
+split in the middle, so the two halves have about the same length and every
+product above the leaves is a balanced one for Karatsuba, Toom-Cook or the
+FFT. Short ranges pack as many factors into a limb as fit before
+multiplying it in.
+*/
+int range_product(bigint *X, big_uint lo, big_uint hi) {
+    if (hi <= lo || hi - lo <= 32) {
+        int ret = big_set_nonzero(X, 1);
+        big_uint m = 1;
+        // Counting up to hi - 1 so that hi = UINT64_MAX cannot wrap around
+        for (big_uint i = lo; i < hi && ret == 0; i++) {
+            if (m > UINT64_MAX / (i + 1)) {
+                ret = big_mul_ui(X, X, m);
+                m = 1;
+            }
+            m *= i + 1;
+        }
+        return (ret == 0) ? big_mul_ui(X, X, m) : ret;
+    }
+    big_uint mid = lo + (hi - lo) / 2;
+    bigint H;
+    big_init(&H);
+    int ret = range_product(X, lo, mid);
+    if (ret == 0) {
+        ret = range_product(&H, mid, hi);
+    }
+    if (ret == 0) {
+        ret = big_mul_auto(X, X, &H);
+    }
+    big_free(&H);
+    return ret;
+}
+
+int big_fac_ui(bigint *X, big_uint n) {
+    if (X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return range_product(X, 1, n);
+}
+
+int big_bin_uiui(bigint *X, big_uint n, big_uint k) {
+    if (X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (k > n) {
+        return big_set_nonzero(X, 0);
+    }
+    if (k > n - k) {
+        k = n - k;
+    }
+    // n! / (k! (n - k)!) = (n - k + 1) * ... * n / k!, and the division is exact
+    bigint D;
+    big_init(&D);
+    int ret = range_product(X, n - k, n);
+    if (ret == 0) {
+        ret = range_product(&D, 1, k);
+    }
+    if (ret == 0) {
+        ret = big_div(X, NULL, X, &D);
+    }
+    big_free(&D);
+    return ret;
+}
+
+/*
+Binary splitting of the Chudnovsky series
+    1 / pi = 12 / 640320^(3/2) * sum_a (-1)^a (6a)! (13591409 + 545140134 a)
+                                       / ((3a)! (a!)^3 640320^(3a))
+over the terms lo <= a < hi. Term a is term a - 1 times -p(a) / q(a) with
+p(a) = (6a - 5)(2a - 1)(6a - 1) and q(a) = a^3 640320^3 / 24, and the
+splitting keeps P = p(lo) ... p(hi - 1), Q = q(lo) ... q(hi - 1) and T, the
+sum of the terms times Q, with p(0) = q(0) = 1. Two halves combine as
+P = P1 P2, Q = Q1 Q2 and T = T1 Q2 + P1 T2, so nearly all the work is
+balanced products, and the last P is never needed.
+*/
+int pi_split(bigint *P, bigint *Q, bigint *T, big_uint lo, big_uint hi, bool need_p) {
+    int ret = 0;
+    if (hi == lo + 1) {
+        big_uint a = lo;
+        ret = big_set_nonzero(P, 1);
+        if (ret == 0) {
+            ret = big_set_nonzero(Q, 1);
+        }
+        if (ret == 0 && a > 0) {
+            ret = big_mul_ui(P, P, (6 * a - 5) * (2 * a - 1));
+            if (ret == 0) {
+                ret = big_mul_ui(P, P, 6 * a - 1);
+            }
+            if (ret == 0) {
+                ret = big_mul_ui(Q, Q, a * a);
+            }
+            if (ret == 0) {
+                ret = big_mul_ui(Q, Q, a);
+            }
+            if (ret == 0) {
+                ret = big_mul_ui(Q, Q, 10939058860032000);
+            }
+        }
+        if (ret == 0) {
+            ret = big_mul_ui(T, P, 13591409 + 545140134 * a);
+        }
+        if (a % 2 == 1) {
+            T->signum = -1;
+        }
+        return ret;
+    }
+    big_uint mid = lo + (hi - lo) / 2;
+    bigint P2, Q2, T2;
+    big_init(&P2);
+    big_init(&Q2);
+    big_init(&T2);
+    ret = pi_split(P, Q, T, lo, mid, true);
+    if (ret == 0) {
+        ret = pi_split(&P2, &Q2, &T2, mid, hi, need_p);
+    }
+    if (ret == 0) {
+        ret = big_mul_auto(T, T, &Q2);
+    }
+    if (ret == 0) {
+        ret = big_addmul(T, P, &T2);
+    }
+    if (ret == 0) {
+        ret = big_mul_auto(Q, Q, &Q2);
+    }
+    if (ret == 0 && need_p) {
+        ret = big_mul_auto(P, P, &P2);
+    }
+    big_free(&P2);
+    big_free(&Q2);
+    big_free(&T2);
+    return ret;
+}
+
+/*
+pi = 426880 sqrt(10005) Q / T over the first terms of the series, each of
+which adds about 47.11 bits. The work is done with 64 guard bits below the
+4 * digits wanted: Q and T lose the bits beyond that precision before the
+division, and sqrt(10005) comes from big_sqrt at the same precision.
+*/
+int big_pi_hex(bigint *X, size_t digits) {
+    if (X == NULL || digits > (SIZE_MAX - 128) / 8) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t bits = 4 * digits + 64;
+    big_uint terms = bits / 47 + 2;
+    bigint P, Q, T, S;
+    big_init(&P);
+    big_init(&Q);
+    big_init(&T);
+    big_init(&S);
+    int ret = pi_split(&P, &Q, &T, 0, terms, false);
+    size_t t_bits = big_bitlen(&T);
+    if (ret == 0 && t_bits > bits + 64) {
+        ret = big_bit_shift_right(&Q, &Q, t_bits - bits - 64);
+        if (ret == 0) {
+            ret = big_bit_shift_right(&T, &T, t_bits - bits - 64);
+        }
+    }
+    if (ret == 0) {
+        ret = big_set_nonzero(&S, 10005);
+    }
+    if (ret == 0) {
+        ret = big_bit_shift_left(&S, &S, 2 * bits);
+    }
+    if (ret == 0) {
+        ret = big_sqrt(&S, &S);
+    }
+    if (ret == 0) {
+        ret = big_mul_auto(&S, &S, &Q);
+    }
+    if (ret == 0) {
+        ret = big_mul_ui(&S, &S, 426880);
+    }
+    if (ret == 0) {
+        ret = big_div(&S, NULL, &S, &T);
+    }
+    if (ret == 0) {
+        ret = big_bit_shift_right(X, &S, 64);
+    }
+    big_free(&P);
+    big_free(&Q);
+    big_free(&T);
+    big_free(&S);
+    return ret;
+}
+
+// RADIX CONVERSION STARTS HERE
+
+/*
+Strings of up to radix_read_threshold limbs' worth of digits are parsed a
+limb's worth of digits at a time, and values of up to radix_write_threshold
+limbs are printed by repeated division by a single limb. Both take quadratic
+time. Anything longer is split in two at a power of the radix, so the work
+moves into a few large multiplications or divisions instead.
+*/
+#ifndef RADIX_READ_THRESHOLD
+#define RADIX_READ_THRESHOLD 200
+#endif
+size_t radix_read_threshold = RADIX_READ_THRESHOLD;
+#ifndef RADIX_WRITE_THRESHOLD
+#define RADIX_WRITE_THRESHOLD 20
+#endif
+size_t radix_write_threshold = RADIX_WRITE_THRESHOLD;
+
+#if RADIX_READ_THRESHOLD < 1 || RADIX_WRITE_THRESHOLD < 1
+#error "the radix conversion thresholds must be at least 1 limb"
+#endif
+
+static const char radix_digit_chars[] = "0123456789abcdefghijklmnopqrstuvwxyz";
+
+// Value of the digit c in any radix up to 36, or 36 if c is no digit at all
+int radix_digit_value(char c) {
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'z') {
+        return c - 'a' + 10;
+    }
+    if (c >= 'A' && c <= 'Z') {
+        return c - 'A' + 10;
+    }
+    return 36;
+}
+
+/*
+State of one conversion in a radix that is not a power of 2. A limb holds
+digits digits, base = radix^digits, base_div is base prepared for the
+basecase divisions, and pow[i] = base^(2^i) is the power the divide and
+conquer steps split at, worth digits * 2^i digits. The powers are squared up
+only as far as a conversion needs them.
+*/
+typedef struct {
+    int radix;
+    size_t digits;
+    big_uint base;
+    limb_divisor base_div;
+    size_t count;
+    bigint pow[64];
+} radix_conv;
+
+void radix_conv_init(radix_conv *rc, int radix) {
+    rc->radix = radix;
+    rc->digits = 0;
+    rc->base = 1;
+    while (rc->base <= UINT64_MAX / radix) {
+        rc->base *= radix;
+        rc->digits++;
+    }
+    limb_divisor_init(&rc->base_div, rc->base);
+    rc->count = 0;
+}
+
+void radix_conv_free(radix_conv *rc) {
+    for (size_t i = 0; i < rc->count; i++) {
+        big_free(&rc->pow[i]);
+    }
+    rc->count = 0;
+}
+
+// Returns pow[i], computing the missing powers first, or NULL if out of memory
+const bigint *radix_power(radix_conv *rc, size_t i) {
+    while (rc->count <= i) {
+        bigint *p = &rc->pow[rc->count];
+        big_init(p);
+        int ret = (rc->count == 0) ? big_set_nonzero(p, rc->base) : big_sqr(p, &rc->pow[rc->count - 1]);
+        if (ret != 0) {
+            big_free(p);
+            return NULL;
+        }
+        rc->count++;
+    }
+    return &rc->pow[i];
+}
+
+/*
+Parses the len digits at s into X, one chunk of rc->digits digits per step:
+X = X * base + chunk. The first chunk takes the len % digits digits left
+over, so every later one is a full limb's worth.
+*/
+int radix_read_basecase(bigint *X, const char *s, size_t len, const radix_conv *rc) {
+    int ret = big_reserve(X, len / rc->digits + 1);
+    if (ret != 0) {
+        return ret;
+    }
+    big_uint *xp = X->data;
+    size_t n = 0;
+    size_t chunk = (len % rc->digits != 0) ? len % rc->digits : rc->digits;
+    for (size_t i = 0; i < len; i += chunk, chunk = rc->digits) {
+        big_uint v = 0;
+        for (size_t j = 0; j < chunk; j++) {
+            v = v * rc->radix + radix_digit_value(s[i + j]);
+        }
+        big_uint cy = limb_mul_1(xp, xp, n, rc->base);
+        cy += limb_add_1(xp, xp, n, v);
+        if (cy != 0) {
+            xp[n++] = cy;
+        }
+    }
+    big_normalize(X, n, 1);
+    return 0;
+}
+
+/*
+Parses the len digits at s into X. Long strings are split so that the low
+part is digits * 2^i digits, at least half of them, and then
+X = high * pow[i] + low.
+*/
+int radix_read_dc(bigint *X, const char *s, size_t len, radix_conv *rc) {
+    if (len <= radix_read_threshold * rc->digits) {
+        return radix_read_basecase(X, s, len, rc);
+    }
+    size_t i = 0;
+    while ((rc->digits << (i + 1)) < len) {
+        i++;
+    }
+    size_t low = rc->digits << i;
+    const bigint *P = radix_power(rc, i);
+    if (P == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    bigint high;
+    big_init(&high);
+    int ret = radix_read_dc(&high, s, len - low, rc);
+    if (ret == 0) {
+        ret = radix_read_dc(X, s + len - low, low, rc);
+    }
+    if (ret == 0) {
+        ret = big_mul_auto(&high, &high, P);
+    }
+    if (ret == 0) {
+        ret = big_add(X, X, &high);
+    }
+    big_free(&high);
+    return ret;
+}
+
+// Radices 2, 4, 8, 16 and 32 place every digit's bits directly
+int radix_read_pow2(bigint *X, const char *s, size_t len, unsigned bits) {
+    size_t n = (len * bits + 63) / 64;
+    int ret = big_reserve(X, n);
+    if (ret != 0) {
+        return ret;
+    }
+    memset(X->data, 0, n * sizeof(big_uint));
+    for (size_t i = 0; i < len; i++) {
+        size_t pos = (len - 1 - i) * bits;
+        big_uint d = radix_digit_value(s[i]);
+        X->data[pos / 64] |= d << (pos % 64);
+        if (pos % 64 + bits > 64) {
+            X->data[pos / 64 + 1] |= d >> (64 - pos % 64);
+        }
+    }
+    big_normalize(X, n, 1);
+    return 0;
+}
+
+int big_read_string_radix(bigint *X, const char *s, int radix) {
+    if (X == NULL || s == NULL || radix < 2 || radix > 36) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    int signum = 1;
+    if (s[0] == '-') {
+        signum = -1;
+        s++;
+    }
+    size_t len = strlen(s);
+    if (len == 0) {
+        return ERR_BIGINT_INVALID_CHARACTER;
+    }
+    for (size_t i = 0; i < len; i++) {
+        if (radix_digit_value(s[i]) >= radix) {
+            return ERR_BIGINT_INVALID_CHARACTER;
+        }
+    }
+    // The divide and conquer parse can run out of memory halfway, so it
+    // works on a scratch bigint and X is only replaced on success
+    bigint T;
+    big_init(&T);
+    int ret;
+    if ((radix & (radix - 1)) == 0) {
+        ret = radix_read_pow2(&T, s, len, __builtin_ctz(radix));
+    }
+    else {
+        radix_conv rc;
+        radix_conv_init(&rc, radix);
+        ret = radix_read_dc(&T, s, len, &rc);
+        radix_conv_free(&rc);
+    }
+    if (ret == 0) {
+        big_normalize(&T, T.num_limbs, signum);
+        big_swap(X, &T);
+    }
+    big_free(&T);
+    return ret;
+}
+
+/*
+Writes the digits of {ap, n} to out, padded with leading zeros to at least
+pad digits, and returns how many it wrote. Each division by base yields the
+next rc->digits digits from the bottom, which are reversed at the end. ap
+is overwritten.
+*/
+size_t radix_write_basecase(char *out, big_uint *ap, size_t n, size_t pad, const radix_conv *rc) {
+    size_t count = 0;
+    n = limb_trimmed_len(ap, n);
+    while (n > 0) {
+        big_uint rem = limb_divrem_1_preinv(ap, ap, n, &rc->base_div);
+        n = limb_trimmed_len(ap, n);
+        // Only the top chunk may be shorter than a limb's worth
+        for (size_t j = 0; j < rc->digits && (n > 0 || rem != 0); j++) {
+            out[count++] = radix_digit_chars[rem % rc->radix];
+            rem /= rc->radix;
+        }
+    }
+    while (count < pad) {
+        out[count++] = '0';
+    }
+    for (size_t i = 0; i < count / 2; i++) {
+        char c = out[i];
+        out[i] = out[count - 1 - i];
+        out[count - 1 - i] = c;
+    }
+    return count;
+}
+
+/*
+Writes the digits of V >= 0 to out like radix_write_basecase, setting *count
+to their number. Long values are divided by the largest pow[i] of at most
+half their limbs, and the remainder fills exactly digits * 2^i digits after
+the quotient's. pow[i] has at most 2^i limbs, which keeps the quotient
+nonzero. V is overwritten.
+*/
+int radix_write_dc(char *out, bigint *V, size_t pad, radix_conv *rc, size_t *count) {
+    size_t n = limb_trimmed_len(V->data, V->num_limbs);
+    if (n <= radix_write_threshold) {
+        *count = radix_write_basecase(out, V->data, n, pad, rc);
+        return 0;
+    }
+    size_t i = 0;
+    while (((size_t)2 << i) <= (n + 1) / 2) {
+        i++;
+    }
+    size_t low = rc->digits << i;
+    const bigint *P = radix_power(rc, i);
+    if (P == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    bigint Q, R;
+    big_init(&Q);
+    big_init(&R);
+    size_t high_count = 0;
+    size_t low_count = 0;
+    int ret = big_div(&Q, &R, V, P);
+    if (ret == 0) {
+        ret = radix_write_dc(out, &Q, (pad > low) ? pad - low : 0, rc, &high_count);
+    }
+    if (ret == 0) {
+        ret = radix_write_dc(out + high_count, &R, low, rc, &low_count);
+    }
+    big_free(&Q);
+    big_free(&R);
+    *count = high_count + low_count;
+    return ret;
+}
+
+// Writes the digits digits of {ap, n} in a radix of 2^bits, most significant first
+void radix_write_pow2(char *out, const big_uint *ap, size_t n, size_t digits, unsigned bits) {
+    for (size_t i = 0; i < digits; i++) {
+        size_t pos = (digits - 1 - i) * bits;
+        big_uint d = ap[pos / 64] >> (pos % 64);
+        if (pos % 64 + bits > 64 && pos / 64 + 1 < n) {
+            d |= ap[pos / 64 + 1] << (64 - pos % 64);
+        }
+        out[i] = radix_digit_chars[d & ((1u << bits) - 1)];
+    }
+}
+
+int big_write_string_radix(const bigint *X, int radix, char *buf, size_t buflen, size_t *olen) {
+    if (X == NULL || olen == NULL || (buf == NULL && buflen > 0) || radix < 2 || radix > 36) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t n = limb_trimmed_len(X->data, X->num_limbs);
+    size_t sign = (X->signum < 0 && n > 0) ? 1 : 0;
+    if (n == 0) {
+        *olen = 2;
+        if (buflen < *olen) {
+            return ERR_BIGINT_BUFFER_TOO_SMALL;
+        }
+        strcpy(buf, "0");
+        return 0;
+    }
+    size_t bits = 64 * n - __builtin_clzll(X->data[n - 1]);
+    if ((radix & (radix - 1)) == 0) {
+        unsigned digit_bits = __builtin_ctz(radix);
+        size_t digits = (bits + digit_bits - 1) / digit_bits;
+        *olen = sign + digits + 1;
+        if (buflen < *olen) {
+            return ERR_BIGINT_BUFFER_TOO_SMALL;
+        }
+        radix_write_pow2(buf + sign, X->data, n, digits, digit_bits);
+    }
+    else {
+        // radix^digits = base >= 2^floor(log2(base)) bounds the number of digits
+        radix_conv rc;
+        radix_conv_init(&rc, radix);
+        size_t bound = bits * rc.digits / (63 - __builtin_clzll(rc.base)) + 1;
+        // Straight into buf if it surely fits, otherwise into a buffer of our own
+        bool fits = buflen >= sign + bound + 1;
+        char *out = fits ? buf + sign : (char *)malloc(bound);
+        bigint V;
+        big_init(&V);
+        int ret = (out == NULL) ? ERR_BIGINT_ALLOC_FAILED : big_copy(&V, X);
+        size_t digits = 0;
+        if (ret == 0) {
+            V.signum = 1;
+            ret = radix_write_dc(out, &V, 0, &rc, &digits);
+        }
+        *olen = sign + digits + 1;
+        if (ret == 0 && buflen < *olen) {
+            ret = ERR_BIGINT_BUFFER_TOO_SMALL;
+        }
+        if (!fits) {
+            if (ret == 0) {
+                memcpy(buf + sign, out, digits);
+            }
+            free(out);
+        }
+        big_free(&V);
+        radix_conv_free(&rc);
+        if (ret != 0) {
+            return ret;
+        }
+    }
+    if (sign) {
+        buf[0] = '-';
+    }
+    buf[*olen - 1] = '\0';
+    return 0;
+}
+
+// MODULAR EXPONENTIATION STARTS HERE
+
+/*
+Moduli of at most this many limbs use the fused CIOS multiply below. Longer
+ones form the full product with limb_mul first, so they profit from
+Karatsuba and Toom-3, and reduce it afterwards.
+*/
+#ifndef MONT_CIOS_THRESHOLD
+#define MONT_CIOS_THRESHOLD KARATSUBA_THRESHOLD
+#endif
+size_t mont_cios_threshold = MONT_CIOS_THRESHOLD;
+
+/*
+Scratch limbs limb_mont_mul needs for an n-limb modulus: room for a full
+product, since squarings go through limb_sqr at every size, which also
+covers the n + 2 limbs of the CIOS accumulator.
+*/
+size_t mont_scratch_size(size_t n) {
+    return 2 * n + 2 + big_mul_scratch_size(n, n);
+}
+
+/*
+Montgomery reduction of the 2n-limb value {tp, 2n} < N * R, writing
+tp * R^-1 mod N to {rp, n}. Each step clears the lowest remaining limb of tp
+by adding a multiple of N, and parks the carry of that step in the limb it
+just cleared, so all carries are added in one pass at the end.
+*/
+void limb_mont_redc(big_uint *rp, big_uint *tp, const big_mont_ctx *ctx) {
+    size_t n = ctx->n;
+    const big_uint *np = ctx->N;
+    for (size_t i = 0; i < n; i++) {
+        big_uint q = tp[i] * ctx->ninv;
+        tp[i] = limb_addmul_1(tp + i, np, n, q);
+    }
+    big_uint cy = limb_add_n(rp, tp + n, tp, n);
+    if (cy != 0 || limb_cmp(rp, np, n) >= 0) {
+        limb_sub_n(rp, rp, np, n);
+    }
+}
+
+/*
+Computes {rp, n} = a * b * R^-1 mod N for a, b < N, where R = 2^(64n). Short
+moduli use the coarsely integrated operand scanning (CIOS) method: for each
+limb of b, add a * b[i] to the accumulator, then add the multiple of N that
+clears its low limb and shift it down one limb in the same pass. The
+accumulator stays n + 2 limbs and never needs a division. Squarings
+(a == b) instead take limb_sqr and a separate reduction at every size, which
+skips half the cross products. rp may alias a or b, it is only written once
+the product is complete. tp must hold mont_scratch_size(n) limbs.
+*/
+void limb_mont_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, const big_mont_ctx *ctx,
+                   big_uint *tp) {
+    size_t n = ctx->n;
+    const big_uint *np = ctx->N;
+    if (limb_is_fixed_width(n)) {
+        limb_mont_mul_fixed(rp, ap, bp, np, ctx->ninv, n);
+        return;
+    }
+    if (n > mont_cios_threshold || ap == bp) {
+        limb_mul(tp, ap, n, bp, n, tp + 2 * n);
+        limb_mont_redc(rp, tp, ctx);
+        return;
+    }
+    memset(tp, 0, (n + 2) * sizeof(big_uint));
+    for (size_t i = 0; i < n; i++) {
+        big_uint cy = limb_addmul_1(tp, ap, n, bp[i]);
+        big_udbl top = (big_udbl)tp[n] + cy;
+        tp[n] = (big_uint)top;
+        tp[n + 1] = (big_uint)(top >> 64);
+
+        // tp = (tp + m * N) / 2^64, the low limb of the sum is zero
+        big_uint m = tp[0] * ctx->ninv;
+        big_udbl p = (big_udbl)m * np[0] + tp[0];
+        big_uint carry = (big_uint)(p >> 64);
+        for (size_t j = 1; j < n; j++) {
+            p = (big_udbl)m * np[j] + tp[j] + carry;
+            tp[j - 1] = (big_uint)p;
+            carry = (big_uint)(p >> 64);
+        }
+        top = (big_udbl)tp[n] + carry;
+        tp[n - 1] = (big_uint)top;
+        tp[n] = tp[n + 1] + (big_uint)(top >> 64);
+    }
+    // The result is below 2N, one subtraction brings it under N
+    if (tp[n] != 0 || limb_cmp(tp, np, n) >= 0) {
+        limb_sub_n(tp, tp, np, n);
+    }
+    memcpy(rp, tp, n * sizeof(big_uint));
+}
+
+int big_mont_init(big_mont_ctx *ctx, const bigint *N) {
+    if (ctx == NULL || N == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t n = limb_trimmed_len(N->data, N->num_limbs);
+    if (n == 0 || N->signum < 0 || (N->data[0] & 1) == 0) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    ctx->n = n;
+    ctx->ninv = -limb_binvert(N->data[0]);
+    ctx->N = (big_uint *)malloc(n * sizeof(big_uint));
+    ctx->RR = (big_uint *)malloc(n * sizeof(big_uint));
+    if (ctx->N == NULL || ctx->RR == NULL) {
+        big_mont_free(ctx);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    memcpy(ctx->N, N->data, n * sizeof(big_uint));
+
+    // R^2 mod N = 2^(128n) mod N, the only division this context ever needs
+    bigint R2, rem, modulus;
+    big_init(&R2);
+    big_init(&rem);
+    modulus = (bigint){.signum = 1, .num_limbs = n, .alloc = n, .data = ctx->N};
+    int ret = big_reserve(&R2, 2 * n + 1);
+    if (ret == 0) {
+        memset(R2.data, 0, 2 * n * sizeof(big_uint));
+        R2.data[2 * n] = 1;
+        R2.num_limbs = 2 * n + 1;
+        R2.signum = 1;
+        ret = big_div(NULL, &rem, &R2, &modulus);
+    }
+    if (ret == 0) {
+        memset(ctx->RR, 0, n * sizeof(big_uint));
+        memcpy(ctx->RR, rem.data, limb_trimmed_len(rem.data, rem.num_limbs) * sizeof(big_uint));
+    }
+    big_free(&R2);
+    big_free(&rem);
+    if (ret != 0) {
+        big_mont_free(ctx);
+    }
+    return ret;
+}
+
+void big_mont_free(big_mont_ctx *ctx) {
+    if (ctx == NULL) {
+        return;
+    }
+    free(ctx->N);
+    free(ctx->RR);
+    ctx->N = NULL;
+    ctx->RR = NULL;
+    ctx->n = 0;
+}
+
+/*
+Window size for an exponent of the given bit length. Each extra bit halves
+the number of multiplications but doubles the table of odd powers, so it
+only pays off for longer exponents.
+*/
+size_t exp_window_size(size_t bits) {
+    return (bits > 671) ? 6 : (bits > 239) ? 5 : (bits > 79) ? 4 : (bits > 23) ? 3 : 1;
+}
+
+// Bit i of the n-limb value ep
+int limb_bit(const big_uint *ep, size_t i) {
+    return (ep[i / 64] >> (i % 64)) & 1;
+}
+
+/*
+Limbs of work limb_exp_mod needs for an n-limb modulus and an exponent of
+bits bits: the table of odd powers, the running result, the base and the
+scratch of limb_mont_mul.
+*/
+size_t exp_mod_scratch_size(size_t n, size_t bits) {
+    size_t table_size = (size_t)1 << (exp_window_size(bits) - 1);
+    return (table_size + 2) * n + mont_scratch_size(n);
+}
+
+/*
+Left-to-right sliding window exponentiation in Montgomery form,
+{rp, n} = {ap, n}^ep mod N for ap < N and an exponent of bits bits. The
+table holds the odd powers A, A^3, ..., A^(2^w - 1). Every window starts
+and ends on a one bit, so runs of zeros cost only squarings and each window
+costs a single multiplication. The exponent is not hidden, this is not meant
+for secret exponents that an attacker can time. rp may alias ap, and work
+must hold exp_mod_scratch_size(n, bits) limbs.
+*/
+void limb_exp_mod(big_uint *rp, const big_uint *ap, const big_uint *ep, size_t bits, const big_mont_ctx *ctx,
+                  big_uint *work) {
+    size_t n = ctx->n;
+    size_t w = exp_window_size(bits);
+    size_t table_size = (size_t)1 << (w - 1);
+    big_uint *table = work;
+    big_uint *acc = table + table_size * n;
+    big_uint *base = acc + n;
+    big_uint *tp = base + n;
+
+    // table[k] = A^(2k + 1) in Montgomery form, base becomes A^2
+    limb_mont_mul(table, ap, ctx->RR, ctx, tp);
+    limb_mont_mul(base, table, table, ctx, tp);
+    for (size_t k = 1; k < table_size; k++) {
+        limb_mont_mul(table + k * n, table + (k - 1) * n, base, ctx, tp);
+    }
+
+    // acc starts out as R mod N, the Montgomery form of 1, which only
+    // survives if E is 0. Otherwise the first window simply loads its power.
+    memset(base, 0, n * sizeof(big_uint));
+    base[0] = 1;
+    limb_mont_mul(acc, base, ctx->RR, ctx, tp);
+
+    bool first = true;
+    size_t i = bits;
+    while (i > 0) {
+        if (!limb_bit(ep, i - 1)) {
+            limb_mont_mul(acc, acc, acc, ctx, tp);
+            i--;
+            continue;
+        }
+        // The window covers bits [low, i) and ends on a one bit
+        size_t low = (i > w) ? i - w : 0;
+        while (!limb_bit(ep, low)) {
+            low++;
+        }
+        size_t value = 0;
+        for (size_t j = i; j > low; j--) {
+            value = (value << 1) | limb_bit(ep, j - 1);
+        }
+        if (first) {
+            memcpy(acc, table + (value >> 1) * n, n * sizeof(big_uint));
+            first = false;
+        }
+        else {
+            for (size_t j = i; j > low; j--) {
+                limb_mont_mul(acc, acc, acc, ctx, tp);
+            }
+            limb_mont_mul(acc, acc, table + (value >> 1) * n, ctx, tp);
+        }
+        i = low;
+    }
+
+    // Leave Montgomery form: acc * R^-1 mod N
+    memset(base, 0, n * sizeof(big_uint));
+    base[0] = 1;
+    limb_mont_mul(rp, acc, base, ctx, tp);
+}
+
+int big_exp_mod_ctx(bigint *X, const bigint *A, const bigint *E, const big_mont_ctx *ctx) {
+    if (X == NULL || A == NULL || E == NULL || ctx == NULL || ctx->N == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (E->signum < 0 && !big_is_zero(E)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t n = ctx->n;
+    // Everything is 0 modulo 1, and 1 itself is not a valid Montgomery input
+    if (n == 1 && ctx->N[0] == 1) {
+        int ret = big_reserve(X, 1);
+        if (ret == 0) {
+            big_normalize(X, 0, 1);
+        }
+        return ret;
+    }
+    size_t en = limb_trimmed_len(E->data, E->num_limbs);
+    size_t bits = (en == 0) ? 0 : 64 * en - __builtin_clzll(E->data[en - 1]);
+
+    // A single buffer: the base, then the work of limb_exp_mod
+    big_uint *base = (big_uint *)malloc((n + exp_mod_scratch_size(n, bits)) * sizeof(big_uint));
+    if (base == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    bigint modulus = {.signum = 1, .num_limbs = n, .alloc = n, .data = ctx->N};
+
+    // Reduce A into [0, N) up front, the loop itself never divides
+    bigint reduced;
+    big_init(&reduced);
+    int ret = big_div(NULL, &reduced, A, &modulus);
+    if (ret == 0 && reduced.signum < 0 && !big_is_zero(&reduced)) {
+        ret = big_add(&reduced, &reduced, &modulus);
+    }
+    if (ret != 0) {
+        big_free(&reduced);
+        free(base);
+        return ret;
+    }
+    size_t rn = limb_trimmed_len(reduced.data, reduced.num_limbs);
+    memset(base, 0, n * sizeof(big_uint));
+    memcpy(base, reduced.data, rn * sizeof(big_uint));
+    big_free(&reduced);
+
+    limb_exp_mod(base, base, E->data, bits, ctx, base + n);
+
+    ret = big_reserve(X, n);
+    if (ret == 0) {
+        memcpy(X->data, base, n * sizeof(big_uint));
+        big_normalize(X, n, 1);
+    }
+    free(base);
+    return ret;
+}
+
+int big_exp_mod(bigint *X, const bigint *A, const bigint *E, const bigint *N) {
+    big_mont_ctx ctx;
+    int ret = big_mont_init(&ctx, N);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = big_exp_mod_ctx(X, A, E, &ctx);
+    big_mont_free(&ctx);
+    return ret;
+}
+
+// CONSTANT TIME ARITHMETIC STARTS HERE
+
+/*
+The functions below are for secret operands. They work on fixed-width limb
+arrays the caller sizes and never allocate, and which instructions and
+memory addresses they touch depends only on the lengths, never on the limb
+values. So they never trim leading zero limbs, compare with an early exit or
+pick a method by the size of a value. limb_add_n, limb_sub_n, limb_addmul_1,
+limb_mul_basecase and limb_sqr_basecase already run that way, the early exit carry loops
+limb_add_1 and limb_sub_1 and the subquadratic products (which branch on the
+sign of their differences) do not, and are left out.
+*/
+
+// All ones if the low bit of cond is set, otherwise 0
+big_uint ct_mask(big_uint cond) {
+    return (big_uint)0 - (cond & 1);
+}
+
+big_uint big_ct_add(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    return limb_add_n(rp, ap, bp, n);
+}
+
+big_uint big_ct_sub(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    return limb_sub_n(rp, ap, bp, n);
+}
+
+void big_ct_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n) {
+    limb_mul_basecase(rp, ap, n, bp, n);
+}
+
+/*
+Both differences are formed in full and only their borrows are kept: a < b
+borrows from a - b, a > b from b - a.
+*/
+int big_ct_cmp(const big_uint *ap, const big_uint *bp, size_t n) {
+    big_uint lt = 0;
+    big_uint gt = 0;
+    for (size_t i = 0; i < n; i++) {
+        big_udbl d = (big_udbl)ap[i] - bp[i] - lt;
+        lt = (big_uint)(d >> 64) & 1;
+        d = (big_udbl)bp[i] - ap[i] - gt;
+        gt = (big_uint)(d >> 64) & 1;
+    }
+    return (int)gt - (int)lt;
+}
+
+void big_ct_cswap(big_uint *ap, big_uint *bp, size_t n, big_uint swap) {
+    big_uint mask = ct_mask(swap);
+    for (size_t i = 0; i < n; i++) {
+        big_uint t = (ap[i] ^ bp[i]) & mask;
+        ap[i] ^= t;
+        bp[i] ^= t;
+    }
+}
+
+void big_ct_select(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint cond) {
+    big_uint mask = ct_mask(cond);
+    for (size_t i = 0; i < n; i++) {
+        rp[i] = bp[i] ^ ((ap[i] ^ bp[i]) & mask);
+    }
+}
+
+/*
+limb_mont_mul for secret operands. The product comes from the schoolbook
+kernels, limb_sqr_basecase when ap == bp, which only branch on n, and the
+reduction keeps its carries in the low half like limb_mont_redc. The final
+subtraction is always done and its result picked by select: the reduced
+value is below 2N, and at least N exactly when the sum carries out or N can
+be subtracted without a borrow. tp holds 2n limbs, rp may alias ap or bp.
+*/
+void limb_ct_mont_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, const big_mont_ctx *ctx,
+                      big_uint *tp) {
+    size_t n = ctx->n;
+    const big_uint *np = ctx->N;
+    if (ap == bp) {
+        limb_sqr_basecase(tp, ap, n);
+    }
+    else {
+        limb_mul_basecase(tp, ap, n, bp, n);
+    }
+    for (size_t i = 0; i < n; i++) {
+        big_uint q = tp[i] * ctx->ninv;
+        tp[i] = limb_addmul_1(tp + i, np, n, q);
+    }
+    big_uint carry = limb_add_n(tp + n, tp + n, tp, n);
+    big_uint borrow = limb_sub_n(tp, tp + n, np, n);
+    big_ct_select(rp, tp, tp + n, n, carry | (borrow ^ 1));
+}
+
+size_t big_ct_exp_mod_scratch_size(size_t n) {
+    return 5 * n + 2;
+}
+
+/*
+Montgomery ladder: R0 = A^k and R1 = A^(k + 1) for the exponent bits k seen
+so far. A 0 bit takes them to A^2k and A^(2k + 1), a 1 bit to A^(2k + 1) and
+A^(2k + 2). Both cases are one multiplication R0 * R1 and one squaring, with
+the registers swapped before and after when the bit is set, so every bit
+costs the same whatever its value, and all 64 * en bits are processed.
+*/
+int big_ct_exp_mod(big_uint *rp, const big_uint *ap, const big_uint *ep, size_t en, const big_mont_ctx *ctx,
+                   big_uint *tp) {
+    if (rp == NULL || ap == NULL || (ep == NULL && en > 0) || ctx == NULL || ctx->N == NULL || tp == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t n = ctx->n;
+    big_uint *r0 = tp;
+    big_uint *r1 = tp + n;
+    big_uint *one = tp + 2 * n;
+    big_uint *mp = tp + 3 * n;
+    memset(one, 0, n * sizeof(big_uint));
+    one[0] = 1;
+
+    // R0 = R mod N, the Montgomery form of 1, and R1 = A in Montgomery form
+    limb_ct_mont_mul(r0, one, ctx->RR, ctx, mp);
+    limb_ct_mont_mul(r1, ap, ctx->RR, ctx, mp);
+    for (size_t i = 64 * en; i > 0; i--) {
+        big_uint bit = ep[(i - 1) / 64] >> ((i - 1) % 64);
+        big_ct_cswap(r0, r1, n, bit);
+        limb_ct_mont_mul(r1, r0, r1, ctx, mp);
+        limb_ct_mont_mul(r0, r0, r0, ctx, mp);
+        big_ct_cswap(r0, r1, n, bit);
+    }
+    limb_ct_mont_mul(rp, r0, one, ctx, mp);
+    return 0;
+}
+
+/*
+Fixed window exponentiation for secret exponents, {rp, n} = {ap, n}^{ep, en}
+mod N with ap < N. Each CT_EXP_WINDOW bits of the exponent, leading zeros
+included, cost that many squarings and one multiplication by the table entry
+A^bits, which is read by scanning the whole table through select so the
+memory accesses do not give the bits away either. With 4-bit windows that
+is 1.25 Montgomery multiplications per bit against the ladder's 2, and most
+of them squarings. rp may alias ap, tp holds ct_exp_window_scratch_size(n)
+limbs.
+*/
+#define CT_EXP_WINDOW 4
+
+size_t ct_exp_window_scratch_size(size_t n) {
+    return (((size_t)1 << CT_EXP_WINDOW) + 4) * n;
+}
+
+void limb_ct_exp_mod_window(big_uint *rp, const big_uint *ap, const big_uint *ep, size_t en,
+                            const big_mont_ctx *ctx, big_uint *tp) {
+    size_t n = ctx->n;
+    size_t size = (size_t)1 << CT_EXP_WINDOW;
+    big_uint *table = tp;
+    big_uint *acc = table + size * n;
+    big_uint *entry = acc + n;
+    big_uint *mp = entry + n;
+
+    // table[i] = A^i in Montgomery form, table[0] = R mod N
+    memset(entry, 0, n * sizeof(big_uint));
+    entry[0] = 1;
+    limb_ct_mont_mul(table, entry, ctx->RR, ctx, mp);
+    limb_ct_mont_mul(table + n, ap, ctx->RR, ctx, mp);
+    for (size_t i = 2; i < size; i++) {
+        limb_ct_mont_mul(table + i * n, table + (i - 1) * n, table + n, ctx, mp);
+    }
+    memcpy(acc, table, n * sizeof(big_uint));
+    for (size_t i = 64 * en; i > 0; i -= CT_EXP_WINDOW) {
+        for (int j = 0; j < CT_EXP_WINDOW; j++) {
+            limb_ct_mont_mul(acc, acc, acc, ctx, mp);
+        }
+        big_uint bits = (ep[(i - CT_EXP_WINDOW) / 64] >> ((i - CT_EXP_WINDOW) % 64)) & (size - 1);
+        for (size_t k = 0; k < size; k++) {
+            // diff | -diff has its top bit set for every k but bits
+            big_uint diff = k ^ bits;
+            big_ct_select(entry, table + k * n, entry, n, ((diff | (0 - diff)) >> 63) ^ 1);
+        }
+        limb_ct_mont_mul(acc, acc, entry, ctx, mp);
+    }
+    memset(entry, 0, n * sizeof(big_uint));
+    entry[0] = 1;
+    limb_ct_mont_mul(rp, acc, entry, ctx, mp);
+}
+
+// PRIMALITY TESTING STARTS HERE
+
+/*
+Odd primes below GEN_PRIME_SIEVE_LIMIT sieve the candidates of big_gen_prime,
+which are tested GEN_PRIME_WINDOW at a time, every second integer from the
+current starting point.
+*/
+#define GEN_PRIME_SIEVE_LIMIT 2048
+#define GEN_PRIME_WINDOW 4096
+
+/*
+Writes {ap, n} mod primes[i] to res[i] for count primes. The primes are
+grouped so that each group's product still fits in a limb, then the whole
+group costs a single pass over ap.
+*/
+void limb_mod_primes(big_uint *res, const big_uint *ap, size_t n, const int *primes, size_t count) {
+    size_t i = 0;
+    while (i < count) {
+        size_t j = i;
+        big_uint product = 1;
+        while (j < count && product <= UINT64_MAX / (big_uint)primes[j]) {
+            product *= (big_uint)primes[j];
+            j++;
+        }
+        big_uint r = limb_mod_1(ap, n, product);
+        for (; i < j; i++) {
+            res[i] = r % (big_uint)primes[i];
+        }
+    }
+}
+
+/*
+Batch trial division. The primes are grouped into limb sized products as in
+limb_mod_primes, but instead of one pass over X per group, a remainder tree
+over the group products takes X down to single limbs: X is divided once by
+the product of all primes and each level below halves the remainders. That
+only pays off once X has trial_tree_threshold limbs and there are at
+least TRIAL_TREE_GROUPS groups, below either the passes are faster.
+*/
+#ifndef TRIAL_TREE_THRESHOLD
+#define TRIAL_TREE_THRESHOLD 80
+#endif
+size_t trial_tree_threshold = TRIAL_TREE_THRESHOLD;
+#define TRIAL_TREE_GROUPS 4
+
+int big_mod_primes(big_uint *res, const bigint *X, const int *primes, size_t count) {
+    if (res == NULL || X == NULL || (primes == NULL && count > 0)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (primes[i] < 2) {
+            return ERR_BIGINT_BAD_INPUT_DATA;
+        }
+    }
+    if (count == 0) {
+        return 0;
+    }
+    big_uint *products = (big_uint *)malloc(count * sizeof(big_uint));
+    bigint *groups = (bigint *)malloc(count * sizeof(bigint));
+    if (products == NULL || groups == NULL) {
+        free(products);
+        free(groups);
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    size_t g = 0;
+    for (size_t i = 0; i < count; g++) {
+        products[g] = 1;
+        while (i < count && products[g] <= UINT64_MAX / (big_uint)primes[i]) {
+            products[g] *= (big_uint)primes[i++];
+        }
+        groups[g] = tree_node(&products[g], 1, 1);
+    }
+    size_t n = limb_trimmed_len(X->data, X->num_limbs);
+    if (n < trial_tree_threshold || g < TRIAL_TREE_GROUPS) {
+        limb_mod_primes(res, X->data, n, primes, count);
+        free(products);
+        free(groups);
+        return 0;
+    }
+
+    big_tree T, R;
+    bigint value = tree_node(X->data, n, X->num_limbs);
+    int ret = big_product_tree(&T, groups, g);
+    if (ret == 0) {
+        ret = big_remainder_tree(&R, &T, &value);
+        if (ret == 0) {
+            // The same grouping again, now splitting each remainder up
+            size_t i = 0;
+            for (size_t k = 0; k < g; k++) {
+                big_uint r = (R.nodes[k].num_limbs > 0) ? R.nodes[k].data[0] : 0;
+                big_uint product = 1;
+                while (i < count && product <= UINT64_MAX / (big_uint)primes[i]) {
+                    product *= (big_uint)primes[i];
+                    res[i] = r % (big_uint)primes[i];
+                    i++;
+                }
+            }
+            big_tree_free(&R);
+        }
+        big_tree_free(&T);
+    }
+    free(products);
+    free(groups);
+    return ret;
+}
+
+// Jacobi symbol (a / m) for odd m
+int jacobi_small(big_uint a, big_uint m) {
+    int j = 1;
+    a %= m;
+    while (a != 0) {
+        while ((a & 1) == 0) {
+            a >>= 1;
+            if ((m & 7) == 3 || (m & 7) == 5) {
+                j = -j;
+            }
+        }
+        big_uint t = a;
+        a = m;
+        m = t;
+        if ((a & 3) == 3 && (m & 3) == 3) {
+            j = -j;
+        }
+        a %= m;
+    }
+    return (m == 1) ? j : 0;
+}
+
+// {rp, n} = a + b mod N for a, b < N
+void limb_add_mod(big_uint *rp, const big_uint *ap, const big_uint *bp, const big_uint *np, size_t n) {
+    big_uint cy = limb_add_n(rp, ap, bp, n);
+    if (cy != 0 || limb_cmp(rp, np, n) >= 0) {
+        limb_sub_n(rp, rp, np, n);
+    }
+}
+
+// {rp, n} = a - b mod N for a, b < N
+void limb_sub_mod(big_uint *rp, const big_uint *ap, const big_uint *bp, const big_uint *np, size_t n) {
+    if (limb_sub_n(rp, ap, bp, n) != 0) {
+        limb_add_n(rp, rp, np, n);
+    }
+}
+
+// {rp, n} = a / 2 mod N for a < N and odd N, adding N first if a is odd
+void limb_half_mod(big_uint *rp, const big_uint *ap, const big_uint *np, size_t n) {
+    big_uint cy = 0;
+    if (ap[0] & 1) {
+        cy = limb_add_n(rp, ap, np, n);
+    }
+    else if (rp != ap) {
+        memcpy(rp, ap, n * sizeof(big_uint));
+    }
+    limb_rshift(rp, rp, n, 1);
+    rp[n - 1] |= cy << 63;
+}
+
+// Montgomery form of the small signed constant c, c R mod N
+void limb_mont_set_small(big_uint *rp, big_sint c, const big_mont_ctx *ctx, big_uint *tp) {
+    size_t n = ctx->n;
+    big_uint mag = (c < 0) ? -(big_uint)c : (big_uint)c;
+    memset(rp, 0, n * sizeof(big_uint));
+    rp[0] = (n == 1) ? mag % ctx->N[0] : mag;
+    limb_mont_mul(rp, rp, ctx->RR, ctx, tp);
+    if (c < 0 && limb_trimmed_len(rp, n) != 0) {
+        limb_sub_n(rp, ctx->N, rp, n);
+    }
+}
+
+/*
+Sets *square to whether X >= 0 is a perfect square. Newton's iteration
+x = (x + X / x) / 2 falls steadily from any start above the square root until
+it reaches floor(sqrt(X)).
+*/
+int perfect_square(const bigint *X, bool *square) {
+    bigint x, y;
+    big_init(&x);
+    big_init(&y);
+    int ret = big_set_nonzero(&x, 1);
+    if (ret == 0) {
+        ret = big_bit_shift_left(&x, &x, (big_bitlen(X) + 1) / 2);
+    }
+    while (ret == 0) {
+        ret = big_div(&y, NULL, X, &x);
+        if (ret == 0) {
+            ret = big_add(&y, &y, &x);
+        }
+        if (ret == 0) {
+            ret = big_bit_shift_right(&y, &y, 1);
+        }
+        if (ret != 0 || big_cmp(&y, &x) >= 0) {
+            break;
+        }
+        ret = big_copy(&x, &y);
+    }
+    if (ret == 0) {
+        ret = big_mul_auto(&y, &x, &x);
+    }
+    if (ret == 0) {
+        *square = (big_cmp(&y, X) == 0);
+    }
+    big_free(&x);
+    big_free(&y);
+    return ret;
+}
+
+/*
+Miller-Rabin over the fixed bases. With N - 1 = d * 2^s and d odd, a prime N
+has base^d = 1, or reaches N - 1 within s - 1 squarings of it. N is the
+odd modulus of ctx and must be larger than every base.
+*/
+int miller_rabin(const big_mont_ctx *ctx) {
+    size_t n = ctx->n;
+    bigint nm1, d, base, y;
+    big_init(&nm1);
+    big_init(&d);
+    big_init(&base);
+    big_init(&y);
+    big_uint *work = (big_uint *)malloc((2 * n + mont_scratch_size(n)) * sizeof(big_uint));
+    big_uint *ym = work;
+    big_uint *minus_one = ym + n;
+    big_uint *tp = minus_one + n;
+    int ret = (work == NULL) ? ERR_BIGINT_ALLOC_FAILED : big_reserve(&nm1, n);
+    if (ret == 0) {
+        // N is odd, so N - 1 only clears the lowest bit
+        memcpy(nm1.data, ctx->N, n * sizeof(big_uint));
+        nm1.data[0] -= 1;
+        big_normalize(&nm1, n, 1);
+        size_t s = 1;
+        while (!limb_bit(nm1.data, s)) {
+            s++;
+        }
+        ret = big_bit_shift_right(&d, &nm1, s);
+        limb_mont_set_small(minus_one, -1, ctx, tp);
+
+        size_t num_bases = sizeof(bases) / sizeof(bases[0]);
+        for (size_t k = 0; k < num_bases && ret == 0; k++) {
+            ret = big_set_nonzero(&base, bases[k]);
+            if (ret == 0) {
+                ret = big_exp_mod_ctx(&y, &base, &d, ctx);
+            }
+            if (ret != 0) {
+                break;
+            }
+            size_t yn = limb_trimmed_len(y.data, y.num_limbs);
+            if ((yn == 1 && y.data[0] == 1) || big_cmp(&y, &nm1) == 0) {
+                continue;
+            }
+            // Keep squaring in Montgomery form, compared against N - 1 there
+            memset(ym, 0, n * sizeof(big_uint));
+            memcpy(ym, y.data, yn * sizeof(big_uint));
+            limb_mont_mul(ym, ym, ctx->RR, ctx, tp);
+            ret = ERR_BIGINT_NOT_ACCEPTABLE;
+            for (size_t r = 1; r < s; r++) {
+                limb_mont_mul(ym, ym, ym, ctx, tp);
+                if (limb_cmp(ym, minus_one, n) == 0) {
+                    ret = 0;
+                    break;
+                }
+            }
+        }
+    }
+    free(work);
+    big_free(&nm1);
+    big_free(&d);
+    big_free(&base);
+    big_free(&y);
+    return ret;
+}
+
+/*
+Strong Lucas probable prime test with Selfridge's parameters: D is the first
+of 5, -7, 9, -11, ... with Jacobi symbol (D / N) = -1, P = 1 and
+Q = (1 - D) / 4. With N + 1 = d * 2^s and d odd, a prime N has U_d = 0 or
+V_(d 2^r) = 0 for some r < s. U, V and Q^k step through the bits of d with
+the doubling formulas, all in Montgomery form, so no step needs a division.
+*/
+int strong_lucas(const big_mont_ctx *ctx) {
+    size_t n = ctx->n;
+    const big_uint *np = ctx->N;
+    bigint modulus = {.signum = 1, .num_limbs = n, .alloc = n, .data = ctx->N};
+
+    // Perfect squares never reach (D / N) = -1, so rule them out once the
+    // first few D fail
+    big_sint D = 5;
+    for (int tries = 0; ; tries++) {
+        big_uint a = (D < 0) ? -(big_uint)D : (big_uint)D;
+        int j = jacobi_small(limb_mod_1(np, n, a), a);
+        if ((a & 3) == 3 && (np[0] & 3) == 3) {
+            j = -j;
+        }
+        if (D < 0 && (np[0] & 3) == 3) {
+            j = -j;
+        }
+        if (j == -1) {
+            break;
+        }
+        if (j == 0 && !(n == 1 && np[0] == a)) {
+            return ERR_BIGINT_NOT_ACCEPTABLE;
+        }
+        if (tries == 8) {
+            bool square = false;
+            int ret = perfect_square(&modulus, &square);
+            if (ret != 0) {
+                return ret;
+            }
+            if (square) {
+                return ERR_BIGINT_NOT_ACCEPTABLE;
+            }
+        }
+        D = (D > 0) ? -(D + 2) : -D + 2;
+    }
+
+    bigint d;
+    big_init(&d);
+    big_uint *work = (big_uint *)malloc((6 * n + mont_scratch_size(n)) * sizeof(big_uint));
+    int ret = (work == NULL) ? ERR_BIGINT_ALLOC_FAILED : big_reserve(&d, n + 1);
+    if (ret != 0) {
+        free(work);
+        big_free(&d);
+        return ret;
+    }
+    big_uint *U = work;
+    big_uint *V = U + n;
+    big_uint *Qk = V + n;
+    big_uint *Dm = Qk + n;
+    big_uint *Qm = Dm + n;
+    big_uint *t = Qm + n;
+    big_uint *tp = t + n;
+
+    // d = (N + 1) / 2^s
+    d.data[n] = limb_add_1(d.data, np, n, 1);
+    big_normalize(&d, n + 1, 1);
+    size_t s = 0;
+    while (!limb_bit(d.data, s)) {
+        s++;
+    }
+    ret = big_bit_shift_right(&d, &d, s);
+
+    // U_1 = 1, V_1 = P = 1, Q^1 = Q
+    limb_mont_set_small(U, 1, ctx, tp);
+    memcpy(V, U, n * sizeof(big_uint));
+    limb_mont_set_small(Dm, D, ctx, tp);
+    limb_mont_set_small(Qm, (1 - D) / 4, ctx, tp);
+    memcpy(Qk, Qm, n * sizeof(big_uint));
+    for (size_t i = big_bitlen(&d) - 1; i > 0 && ret == 0; i--) {
+        // U_2k = U_k V_k, V_2k = V_k^2 - 2 Q^k
+        limb_mont_mul(U, U, V, ctx, tp);
+        limb_mont_mul(V, V, V, ctx, tp);
+        limb_sub_mod(V, V, Qk, np, n);
+        limb_sub_mod(V, V, Qk, np, n);
+        limb_mont_mul(Qk, Qk, Qk, ctx, tp);
+        if (limb_bit(d.data, i - 1)) {
+            // U_k+1 = (P U_k + V_k) / 2, V_k+1 = (D U_k + P V_k) / 2
+            limb_mont_mul(t, Dm, U, ctx, tp);
+            limb_add_mod(U, U, V, np, n);
+            limb_half_mod(U, U, np, n);
+            limb_add_mod(V, t, V, np, n);
+            limb_half_mod(V, V, np, n);
+            limb_mont_mul(Qk, Qk, Qm, ctx, tp);
+        }
+    }
+    if (ret == 0 && limb_trimmed_len(U, n) != 0 && limb_trimmed_len(V, n) != 0) {
+        ret = ERR_BIGINT_NOT_ACCEPTABLE;
+        for (size_t r = 1; r < s; r++) {
+            limb_mont_mul(V, V, V, ctx, tp);
+            limb_sub_mod(V, V, Qk, np, n);
+            limb_sub_mod(V, V, Qk, np, n);
+            if (limb_trimmed_len(V, n) == 0) {
+                ret = 0;
+                break;
+            }
+            limb_mont_mul(Qk, Qk, Qk, ctx, tp);
+        }
+    }
+    free(work);
+    big_free(&d);
+    return ret;
+}
+
+/*
+Trial division by small_primes settles small and most composite inputs, the
+remaining odd X run Miller-Rabin over bases and, if asked for, the strong
+Lucas test as well, which makes it the Baillie-PSW test. All of them share
+one Montgomery context for X.
+*/
+int big_is_probable_prime(const bigint *X, int lucas) {
+    if (X == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t n = limb_trimmed_len(X->data, X->num_limbs);
+    if (n == 0 || X->signum < 0 || (n == 1 && X->data[0] == 1)) {
+        return ERR_BIGINT_NOT_ACCEPTABLE;
+    }
+    size_t count = sizeof(small_primes) / sizeof(small_primes[0]);
+    big_uint res[sizeof(small_primes) / sizeof(small_primes[0])];
+    limb_mod_primes(res, X->data, n, small_primes, count);
+    for (size_t i = 0; i < count; i++) {
+        if (res[i] == 0) {
+            return (n == 1 && X->data[0] == (big_uint)small_primes[i]) ? 0 : ERR_BIGINT_NOT_ACCEPTABLE;
+        }
+    }
+    // A composite below the square of the next prime has a factor in the table
+    big_uint bound = (big_uint)small_primes[count - 1] + 1;
+    if (n == 1 && X->data[0] < bound * bound) {
+        return 0;
+    }
+
+    big_mont_ctx ctx;
+    bigint odd = {.signum = 1, .num_limbs = n, .alloc = n, .data = X->data};
+    int ret = big_mont_init(&ctx, &odd);
+    if (ret != 0) {
+        return ret;
+    }
+    ret = miller_rabin(&ctx);
+    if (ret == 0 && lucas) {
+        ret = strong_lucas(&ctx);
+    }
+    big_mont_free(&ctx);
+    return ret;
+}
+
+/*
+Draws a random odd starting point with the top bit set, then sieves windows
+of GEN_PRIME_WINDOW odd candidates above it by the odd primes below
+GEN_PRIME_SIEVE_LIMIT. The residues of the start are computed once and just
+advance with every window, only the survivors of the sieve get the full
+big_is_probable_prime test. A fresh start is drawn if the candidates outgrow
+bits bits.
+*/
+int big_gen_prime(bigint *X, size_t bits, int (*f_rng)(void *, unsigned char *, size_t), void *p_rng) {
+    if (X == NULL || f_rng == NULL || bits < 2) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t n = (bits + 63) / 64;
+    big_uint top_mask = (bits % 64 == 0) ? ~(big_uint)0 : ((big_uint)1 << (bits % 64)) - 1;
+    big_uint top_bit = (big_uint)1 << ((bits - 1) % 64);
+
+    // The sieving primes themselves come from a sieve of Eratosthenes
+    unsigned char sieve[GEN_PRIME_WINDOW];
+    int primes[GEN_PRIME_SIEVE_LIMIT / 2];
+    big_uint residues[GEN_PRIME_SIEVE_LIMIT / 2];
+    size_t count = 0;
+    memset(sieve, 0, GEN_PRIME_SIEVE_LIMIT);
+    for (int p = 3; p < GEN_PRIME_SIEVE_LIMIT; p += 2) {
+        if (!sieve[p]) {
+            primes[count++] = p;
+            for (int q = p * p; q < GEN_PRIME_SIEVE_LIMIT; q += 2 * p) {
+                sieve[q] = 1;
+            }
+        }
+    }
+
+    bigint cand;
+    big_init(&cand);
+    int ret = big_reserve(X, n);
+    if (ret == 0) {
+        ret = big_reserve(&cand, n);
+    }
+    bool found = false;
+    while (ret == 0 && !found) {
+        ret = f_rng(p_rng, (unsigned char *)X->data, n * sizeof(big_uint));
+        if (ret != 0) {
+            break;
+        }
+        X->data[n - 1] = (X->data[n - 1] & top_mask) | top_bit;
+        X->data[0] |= 1;
+        limb_mod_primes(residues, X->data, n, primes, count);
+
+        bool overflow = false;
+        while (ret == 0 && !found && !overflow) {
+            // X + 2j is divisible by p for j = -r / 2 mod p, and 1 / 2 is (p + 1) / 2
+            memset(sieve, 0, GEN_PRIME_WINDOW);
+            for (size_t i = 0; i < count; i++) {
+                big_uint p = (big_uint)primes[i];
+                big_uint j = ((p - residues[i]) % p) * ((p + 1) / 2) % p;
+                if (n == 1 && X->data[0] + 2 * j == p) {
+                    j += p;
+                }
+                for (; j < GEN_PRIME_WINDOW; j += p) {
+                    sieve[j] = 1;
+                }
+            }
+            for (size_t j = 0; j < GEN_PRIME_WINDOW; j++) {
+                if (sieve[j]) {
+                    continue;
+                }
+                big_uint cy = limb_add_1(cand.data, X->data, n, 2 * j);
+                if (cy != 0 || (cand.data[n - 1] & ~top_mask) != 0) {
+                    overflow = true;
+                    break;
+                }
+                big_normalize(&cand, n, 1);
+                ret = big_is_probable_prime(&cand, 1);
+                if (ret == 0) {
+                    found = true;
+                    break;
+                }
+                if (ret != ERR_BIGINT_NOT_ACCEPTABLE) {
+                    break;
+                }
+                ret = 0;
+            }
+            // Slide to the next window, the residues follow without dividing
+            if (ret == 0 && !found && !overflow) {
+                big_uint cy = limb_add_1(X->data, X->data, n, 2 * GEN_PRIME_WINDOW);
+                overflow = (cy != 0 || (X->data[n - 1] & ~top_mask) != 0);
+                for (size_t i = 0; i < count; i++) {
+                    residues[i] = (residues[i] + 2 * GEN_PRIME_WINDOW) % (big_uint)primes[i];
+                }
+            }
+        }
+    }
+    if (found) {
+        ret = big_copy(X, &cand);
+    }
+    big_free(&cand);
+    return ret;
+}
+
+// RSA STARTS HERE
+
+/*
+Private operations split into the two primes: A^D mod N is recombined from
+A^DP mod P and A^DQ mod Q, each an exponentiation of half the size with an
+exponent of half the length, so about a quarter of the work each. The
+primes are kept ordered P > Q, so the second residue is already below P
+when Garner's formula takes their difference.
+*/
+int big_rsa_init(big_rsa_ctx *ctx, const bigint *P, const bigint *Q, const bigint *E) {
+    if (ctx == NULL || P == NULL || Q == NULL || E == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (E->signum < 0 || big_is_zero(E) || big_bitlen(P) < 2 || big_bitlen(Q) < 2) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    int cmp = big_cmp(P, Q);
+    if (cmp == 0) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    if (cmp < 0) {
+        const bigint *t = P;
+        P = Q;
+        Q = t;
+    }
+    big_init(&ctx->N);
+    big_init(&ctx->E);
+    big_init(&ctx->P);
+    big_init(&ctx->Q);
+    big_init(&ctx->DP);
+    big_init(&ctx->DQ);
+    big_init(&ctx->QP);
+    memset(&ctx->mont_n, 0, sizeof(big_mont_ctx));
+    memset(&ctx->mont_p, 0, sizeof(big_mont_ctx));
+    memset(&ctx->mont_q, 0, sizeof(big_mont_ctx));
+    ctx->QPR = NULL;
+
+    // The Montgomery contexts also reject even primes
+    int ret = big_mont_init(&ctx->mont_p, P);
+    if (ret == 0) {
+        ret = big_mont_init(&ctx->mont_q, Q);
+    }
+    if (ret == 0) {
+        ret = big_mul(&ctx->N, P, Q);
+    }
+    if (ret == 0) {
+        ret = big_mont_init(&ctx->mont_n, &ctx->N);
+    }
+    if (ret == 0) {
+        ret = big_copy(&ctx->P, P);
+    }
+    if (ret == 0) {
+        ret = big_copy(&ctx->Q, Q);
+    }
+    if (ret == 0) {
+        ret = big_copy(&ctx->E, E);
+    }
+
+    // DP = E^-1 mod (P - 1) and DQ = E^-1 mod (Q - 1), so D itself is never needed
+    bigint T;
+    big_init(&T);
+    if (ret == 0) {
+        ret = big_sub_ui(&T, P, 1);
+    }
+    if (ret == 0) {
+        ret = big_invmod(&ctx->DP, E, &T);
+    }
+    if (ret == 0) {
+        ret = big_sub_ui(&T, Q, 1);
+    }
+    if (ret == 0) {
+        ret = big_invmod(&ctx->DQ, E, &T);
+    }
+    if (ret == 0) {
+        ret = big_invmod(&ctx->QP, Q, P);
+    }
+
+    // QPR = QP * R mod P, so one Montgomery multiplication applies QP
+    size_t np = ctx->mont_p.n;
+    if (ret == 0) {
+        ret = big_reserve(&T, ctx->QP.num_limbs + np + 1);
+    }
+    if (ret == 0) {
+        big_shift_left(&T, &ctx->QP, np);
+        ret = big_div(NULL, &T, &T, P);
+    }
+    if (ret == 0) {
+        ctx->QPR = (big_uint *)calloc(np, sizeof(big_uint));
+        if (ctx->QPR == NULL) {
+            ret = ERR_BIGINT_ALLOC_FAILED;
+        }
+    }
+    if (ret == 0) {
+        memcpy(ctx->QPR, T.data, limb_trimmed_len(T.data, T.num_limbs) * sizeof(big_uint));
+    }
+    big_free(&T);
+    if (ret != 0) {
+        big_rsa_free(ctx);
+    }
+    return ret;
+}
+
+void big_rsa_free(big_rsa_ctx *ctx) {
+    if (ctx == NULL) {
+        return;
+    }
+    big_free(&ctx->N);
+    big_free(&ctx->E);
+    big_free(&ctx->P);
+    big_free(&ctx->Q);
+    big_free(&ctx->DP);
+    big_free(&ctx->DQ);
+    big_free(&ctx->QP);
+    big_mont_free(&ctx->mont_n);
+    big_mont_free(&ctx->mont_p);
+    big_mont_free(&ctx->mont_q);
+    free(ctx->QPR);
+    ctx->QPR = NULL;
+}
+
+// Whether A is a valid input, 0 <= A < N
+bool rsa_check_input(const bigint *A, const big_rsa_ctx *ctx) {
+    if (A->signum < 0 && !big_is_zero(A)) {
+        return false;
+    }
+    return big_is_zero(A) || big_cmp(A, &ctx->N) < 0;
+}
+
+int big_rsa_public(bigint *X, const bigint *A, const big_rsa_ctx *ctx) {
+    if (X == NULL || A == NULL || ctx == NULL || ctx->mont_n.N == NULL || !rsa_check_input(A, ctx)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    return big_exp_mod_ctx(X, A, &ctx->E, &ctx->mont_n);
+}
+
+/*
+Scratch limbs of one private operation: the two residues, the recombined
+result, the exponent padded to the width of its prime, and the scratch of
+the exponentiation, which also covers the reductions and Garner's formula.
+*/
+size_t rsa_scratch_size(const big_rsa_ctx *ctx) {
+    size_t np = ctx->mont_p.n;
+    size_t nq = ctx->mont_q.n;
+    return 2 * (np + nq) + np + ct_exp_window_scratch_size(np);
+}
+
+/*
+{rp, n} = {ap, an} mod N for the n-limb modulus of ctx, with branches and
+memory accesses that depend on an and n only. The limbs are taken n at a
+time from the top, Horner style: x = x * R + chunk, where a Montgomery
+multiplication by R^2 mod N gives x * R, two more reduce the chunk, and
+the sum is brought below N by select. tp holds 4n limbs.
+*/
+void limb_ct_mod(big_uint *rp, const big_uint *ap, size_t an, const big_mont_ctx *ctx, big_uint *tp) {
+    size_t n = ctx->n;
+    big_uint *chunk = tp;
+    big_uint *one = tp + n;
+    big_uint *mp = tp + 2 * n;
+    memset(one, 0, n * sizeof(big_uint));
+    one[0] = 1;
+    memset(rp, 0, n * sizeof(big_uint));
+    size_t len = (an % n != 0) ? an % n : n;
+    for (size_t i = an; i > 0; i -= len, len = n) {
+        memset(chunk, 0, n * sizeof(big_uint));
+        memcpy(chunk, ap + i - len, len * sizeof(big_uint));
+        // chunk < R, so chunk * R^2 / R stays below 2N like an input below N
+        limb_ct_mont_mul(rp, rp, ctx->RR, ctx, mp);
+        limb_ct_mont_mul(chunk, chunk, ctx->RR, ctx, mp);
+        limb_ct_mont_mul(chunk, chunk, one, ctx, mp);
+        big_uint carry = limb_add_n(rp, rp, chunk, n);
+        big_uint borrow = limb_sub_n(mp, rp, ctx->N, n);
+        big_ct_select(rp, mp, rp, n, carry | (borrow ^ 1));
+    }
+}
+
+/*
+X = A^D mod N for 0 <= A < N, by the Chinese remainder theorem and Garner's
+formula: with mp = A^DP mod P and mq = A^DQ mod Q,
+X = mq + Q * ((mp - mq) * QP mod P). Everything after reading A runs on
+limb arrays of the primes' widths with the big_ct_* building blocks: A is
+reduced by limb_ct_mod, the exponents go through limb_ct_exp_mod_window at
+their full width, and the correction in Garner's formula is a select, so
+the timing depends on the key sizes and not on P, Q, DP or DQ. R holds A
+and tp rsa_scratch_size(ctx) limbs, so a batch can keep both between calls.
+*/
+int rsa_private(bigint *X, const bigint *A, const big_rsa_ctx *ctx, bigint *R, big_uint *tp) {
+    if (!rsa_check_input(A, ctx)) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    size_t np = ctx->mont_p.n;
+    size_t nq = ctx->mont_q.n;
+    big_uint *mp = tp;
+    big_uint *mq = mp + np;
+    big_uint *xp = mq + nq;
+    big_uint *ep = xp + np + nq;
+    big_uint *work = ep + np;
+
+    // A padded to the width of N, so the reductions run the same for every A
+    int ret = big_reserve(R, np + nq);
+    if (ret != 0) {
+        return ret;
+    }
+    size_t an = limb_trimmed_len(A->data, A->num_limbs);
+    memset(R->data, 0, (np + nq) * sizeof(big_uint));
+    if (an > 0) {
+        memcpy(R->data, A->data, an * sizeof(big_uint));
+    }
+    limb_ct_mod(mp, R->data, np + nq, &ctx->mont_p, work);
+    limb_ct_mod(mq, R->data, np + nq, &ctx->mont_q, work);
+
+    memset(ep, 0, np * sizeof(big_uint));
+    memcpy(ep, ctx->DP.data, limb_trimmed_len(ctx->DP.data, ctx->DP.num_limbs) * sizeof(big_uint));
+    limb_ct_exp_mod_window(mp, mp, ep, np, &ctx->mont_p, work);
+    memset(ep, 0, nq * sizeof(big_uint));
+    memcpy(ep, ctx->DQ.data, limb_trimmed_len(ctx->DQ.data, ctx->DQ.num_limbs) * sizeof(big_uint));
+    limb_ct_exp_mod_window(mq, mq, ep, nq, &ctx->mont_q, work);
+
+    // h = (mp - mq) * QP mod P, where mq < Q < P needs at most one correction
+    big_uint *mq_p = work;
+    big_uint *sum = work + np;
+    memset(mq_p, 0, np * sizeof(big_uint));
+    memcpy(mq_p, mq, nq * sizeof(big_uint));
+    big_uint borrow = limb_sub_n(mp, mp, mq_p, np);
+    limb_add_n(sum, mp, ctx->mont_p.N, np);
+    big_ct_select(mp, sum, mp, np, borrow);
+    limb_ct_mont_mul(mp, mp, ctx->QPR, &ctx->mont_p, work);
+
+    // X = mq + h * Q < P * Q, so the addition carries out of nothing
+    limb_mul_basecase(xp, mp, np, ctx->mont_q.N, nq);
+    memset(work, 0, (np + nq) * sizeof(big_uint));
+    memcpy(work, mq, nq * sizeof(big_uint));
+    limb_add_n(xp, xp, work, np + nq);
+    ret = big_reserve(X, np + nq);
+    if (ret == 0) {
+        memcpy(X->data, xp, (np + nq) * sizeof(big_uint));
+        big_normalize(X, np + nq, 1);
+    }
+    return ret;
+}
+
+int big_rsa_private(bigint *X, const bigint *A, const big_rsa_ctx *ctx) {
+    return big_rsa_private_batch(X, A, 1, ctx);
+}
+
+/*
+Every operation of the batch runs through the same scratch buffer and
+residue, allocated once up front, so the batch allocates nothing per item
+beyond the growth of X[i].
+*/
+int big_rsa_private_batch(bigint *X, const bigint *A, size_t count, const big_rsa_ctx *ctx) {
+    if (X == NULL || A == NULL || ctx == NULL || ctx->QPR == NULL) {
+        return ERR_BIGINT_BAD_INPUT_DATA;
+    }
+    big_uint *tp = (big_uint *)malloc(rsa_scratch_size(ctx) * sizeof(big_uint));
+    if (tp == NULL) {
+        return ERR_BIGINT_ALLOC_FAILED;
+    }
+    bigint R;
+    big_init(&R);
+    int ret = 0;
+    for (size_t i = 0; i < count && ret == 0; i++) {
+        ret = rsa_private(&X[i], &A[i], ctx, &R, tp);
+    }
+    big_free(&R);
+    free(tp);
+    return ret;
+}
+
+// One_Limb Multiplication Tests, used largely for edge cases
+bool one_limb_tests() {
+    bigint first;
+    bigint second;
+    bigint toom_result;
+    bigint karatsuba_result;
+    bigint actual;
+
+    char a_buf[4000];
+    size_t temp;
+    char k_buf[4000];
+    char t_buf[4000];
+
+    big_init(&first);
+    big_init(&second);
+    big_init(&toom_result);
+    big_init(&karatsuba_result);
+    big_init(&actual);
+
+    // Tests 1 x 1
+    big_set_nonzero(&first, 1);
+    big_set_nonzero(&second, 1);
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    // Tests 0 x 0 
+    big_set_nonzero(&first, 0);
+    big_set_nonzero(&second, 0);
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    // Tests operands that were only big_init'd and hold no limbs at all
+    bigint zero;
+    big_init(&zero);
+    assert(big_add(&actual, &zero, &zero) == 0 && big_is_zero(&actual));
+    assert(big_sub(&actual, &zero, &zero) == 0 && big_is_zero(&actual));
+    assert(big_sub(&actual, &zero, &first) == 0 && big_is_zero(&actual));
+    big_set_nonzero(&second, 9);
+    assert(big_sub(&actual, &zero, &second) == 0 && actual.signum == -1 && actual.data[0] == 9);
+    assert(big_add(&actual, &second, &zero) == 0 && actual.signum == 1 && actual.data[0] == 9);
+    assert(big_mul(&actual, &zero, &second) == 0 && big_is_zero(&actual));
+    assert(big_karatsuba(&actual, &zero, &zero) == 0 && big_is_zero(&actual));
+    assert(big_toom_cook(&actual, &second, &zero) == 0 && big_is_zero(&actual));
+
+    // Tests UINTMAX x UINTMAX (1 of them is negative)
+    big_set_nonzero(&first, UINT64_MAX);
+    big_set_nonzero(&second, UINT64_MAX);
+
+    first.signum = -1;
     big_mul(&actual, &first, &second);
     big_karatsuba(&karatsuba_result, &first, &second);
     big_toom_cook(&toom_result, &first, &second);
@@ -1215,6 +7538,8 @@ bool multiple_diff_limb_tests() {
     char k_buf[4000];
     char t_buf[4000];
 
+    big_init(&first);
+    big_init(&second);
     big_init(&toom_result);
     big_init(&karatsuba_result);
     big_init(&actual);
@@ -1362,9 +7687,255 @@ bool multiple_diff_limb_tests() {
     assert(strcmp(a_buf, k_buf) == 0);
     assert(strcmp(a_buf, t_buf) == 0);
 
-    // Large stress test, between 62-63 limbs each
-    big_read_string(&first, "051c22bceb632398a58eb1b8f0f89f92199525b091729be7df289dd8827d52b63748752ec257569cc026daba1f207679c77a8001a1dd36123a3576f03b16a40d598f665ba7f7d226dac7da6668a777ad25587abcf5412dc45940a3af5fbd620074b5bb9f8ab34e514e4b1953bc3c32b381c96cc8a4c6ade44393d6d3ea16e73fb1a816f5482d49258c8cf2931090a801424f3acb0e6b375e35c07920480e930d92bbabb73dfb2fb1a9637ecafc7a18332289cec199a13596a34589a02961b8d73c0ffab3c0e11e78347195d07ea8154703a9fead511052493cf9a646228f7b19ae542720b8db1242aa71f6d5ceb40419ca44844b196b4f30d8e1d62b28fe4688e2e2933334cea2c3211d406593661a531565096c209256233f9a5ec0bd71337e2b13d1bc980bae1526fd20299de1d5626a2f917a2fa9e7d3814f3d2e66547b95dbb9bebab7106bc7b6f01ba3293e4dc02f75b6a18846116d11b57135b4a73b323a551512cf5a92a1e11f04e20d9973aa2423bbabae7c5b08ac8a80f616230b77e54ef87e7f1eb020f3cfe45bd6d9419f8a4b0940bc3f0253ad24f8c808275a3db55bf906b5f6e384f6ff0e47b8f4dedab6e123de96ac4dafb2d665b2af4a7cc3a005607be9aecaa53b7b20117f772ee1e25709d052a4304fdd7d6fb4c0f3ce56578352ed3c3fca6597b5ee47fe90cb124be36541");
-    big_read_string(&second, "799a19bd8212cdc3822e37dbc474358b310e3e5d896e6136debef22b4d06e98ec102f45c3012158f071a37bb898e04422dfc83d4e3193d2a749798f4797c2a1ab0bc41ad7b752b438eb25f185f7e8f2fb11b17382bd93a8c7dab68b55c524523bc5e16158f755f795ff50b45ae6c9e7298c279ace1a4dd38dc646646183204816df568dda3057f1dd3120a42f3568382111cedc3545323f114b2f4d180f9f1b6599a0ae67c82d3db3018c3d15f990ebc750fab0cb82c722be6f2ec3871496e177bb6aa4cd28cfa93bb2e527a4fd81d8dd18e11babe9efd48d63fa79b323e35ab3f9658eab75f5e40509f11c6b63c729385db886e987697938ef9727ce510b8dc84a67d41dc61c7e872f8fee8bd74dcd0d0774ab86d9b6669ffddf3817a39aacc74d93c131e9757fb6c188d05d6aa0df43f1eef7535d434969291721a48e4e79297edc20361b777c2e10a97cbf06bef9fbd84133a3e942e2eb171b13a217a190faa9c1718813881643b5c4df90346f3eb057908e43aa530c9906cc1bf4bfed5b2ae9ba21612d07cd3e454f007608900008ce46377afdbc953c012735f7a5e2c75ff939c3fad759539f8801361e5330aa2fcb0e2956ec5086b095f411936d4db86780aa4d7f5a13fed073d54cb7c148e99d10bddb061f7080b2af7d7fe1b38e03aa63c56ae830f78bc5ec7009276a5a5847ffc7bce");
+    // Large stress test, between 62-63 limbs each
+    big_read_string(&first, "051c22bceb632398a58eb1b8f0f89f92199525b091729be7df289dd8827d52b63748752ec257569cc026daba1f207679c77a8001a1dd36123a3576f03b16a40d598f665ba7f7d226dac7da6668a777ad25587abcf5412dc45940a3af5fbd620074b5bb9f8ab34e514e4b1953bc3c32b381c96cc8a4c6ade44393d6d3ea16e73fb1a816f5482d49258c8cf2931090a801424f3acb0e6b375e35c07920480e930d92bbabb73dfb2fb1a9637ecafc7a18332289cec199a13596a34589a02961b8d73c0ffab3c0e11e78347195d07ea8154703a9fead511052493cf9a646228f7b19ae542720b8db1242aa71f6d5ceb40419ca44844b196b4f30d8e1d62b28fe4688e2e2933334cea2c3211d406593661a531565096c209256233f9a5ec0bd71337e2b13d1bc980bae1526fd20299de1d5626a2f917a2fa9e7d3814f3d2e66547b95dbb9bebab7106bc7b6f01ba3293e4dc02f75b6a18846116d11b57135b4a73b323a551512cf5a92a1e11f04e20d9973aa2423bbabae7c5b08ac8a80f616230b77e54ef87e7f1eb020f3cfe45bd6d9419f8a4b0940bc3f0253ad24f8c808275a3db55bf906b5f6e384f6ff0e47b8f4dedab6e123de96ac4dafb2d665b2af4a7cc3a005607be9aecaa53b7b20117f772ee1e25709d052a4304fdd7d6fb4c0f3ce56578352ed3c3fca6597b5ee47fe90cb124be36541");
+    big_read_string(&second, "799a19bd8212cdc3822e37dbc474358b310e3e5d896e6136debef22b4d06e98ec102f45c3012158f071a37bb898e04422dfc83d4e3193d2a749798f4797c2a1ab0bc41ad7b752b438eb25f185f7e8f2fb11b17382bd93a8c7dab68b55c524523bc5e16158f755f795ff50b45ae6c9e7298c279ace1a4dd38dc646646183204816df568dda3057f1dd3120a42f3568382111cedc3545323f114b2f4d180f9f1b6599a0ae67c82d3db3018c3d15f990ebc750fab0cb82c722be6f2ec3871496e177bb6aa4cd28cfa93bb2e527a4fd81d8dd18e11babe9efd48d63fa79b323e35ab3f9658eab75f5e40509f11c6b63c729385db886e987697938ef9727ce510b8dc84a67d41dc61c7e872f8fee8bd74dcd0d0774ab86d9b6669ffddf3817a39aacc74d93c131e9757fb6c188d05d6aa0df43f1eef7535d434969291721a48e4e79297edc20361b777c2e10a97cbf06bef9fbd84133a3e942e2eb171b13a217a190faa9c1718813881643b5c4df90346f3eb057908e43aa530c9906cc1bf4bfed5b2ae9ba21612d07cd3e454f007608900008ce46377afdbc953c012735f7a5e2c75ff939c3fad759539f8801361e5330aa2fcb0e2956ec5086b095f411936d4db86780aa4d7f5a13fed073d54cb7c148e99d10bddb061f7080b2af7d7fe1b38e03aa63c56ae830f78bc5ec7009276a5a5847ffc7bce");
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    // Large stress test, between 62-63 limbs each
+    big_read_string(&first, "02c8829f01eb3ed605fabfa8a995d2a387bee957048d31b8734e7f9d9f1cdffb620362b4fdf3ef93f499f836ff81485fd049c0c56b05131554c3f0933f61b5039b42395f85970feccba0da1deda3f992e3dc7b47f6cf538f901ac621d46be1bb52c0980d5251afc5f75b08fec2f61f9a3d27a02f385205a4acf3b629d0eba49d202449d138735b8e25ca8b720649df3e1258a76deb309259be7faaf2948b4b50762dd11d248e0c3c8fc5bdf2fe2590cb91878b46de47714b4e09c1490cc9449996484925c62a1156b849c1301d8c498ed94ec1cf4929e1681a05bcf70dfd4651bc2f6b1f48a37f257671e4ca0604017c7ce58e138d80632e0bb923eda9e2c655b3218035127d8128ba9625d59ce2285fa6581e6bf777eba521b27cfa666c166198459752e2969b45f98948530b2472b2199ad62792686a840ace0a5c9b123dc60bc0e89f47458cbb2f59a84036d8439d12526a50c6b4ae38801a6e64e6ae360370806a6974346ba90f0301049329ae4adacda945b550bb8ad9b8567c57211705ffd728402ebbf8b16f96cfb2df9a361e0779af80011a4adfcf0634bd4f7ab84a27ba92b4377abf199b3aec690d73b145f7c74ce65cd64690e9dc7acc8ef9d7c302f24b9b99c06d375c17c21d338ebf83173121dd2187f7e0d1f3be719323bad8a0e5137e792baa9ecad188abbeaae49f4a149070");
+    big_read_string(&second, "3fdd56856497118617ebb06eebedcc91be32b0b1679ee797003e19d638cc5ea94257c5ba7162d2c5d0d67d7982933a4e963c44b643e8be08fa32e3a53698f7c96a94fbb9f286446f81ab2f834c94c790a88000b7566019cde9b6a0ca30760f07a880eb26362b00b7190f110be199c55c9de3d363835f0e82293e8959ce67ab819f53db3f7258ee7c13f3a6ac432a8c666c432afad0404e40131447ebe78cabce5e704ea554a362f8b96119f77350f99588a40c57a4d4c5bbf79758c2095a990e475a0ae9ea92244424dad32bc933fee96947b849eedea00a517ed29337ae5e99a552305b63b3adf9a26d49c79a51ba31f24ff7946a990393815539d425e81e0c5667b3d341da5e7c69d6350b684adb7d7f00394772e32289282baa6a3b9f5ced2118daef8e9d353aedf931722005ab0164e9c89e05f67f45cd411bd5a7241fcd9a92f1a1897b0b9e6ee87f31dc4ae9502fd874911335b903104cd2746dd6ac917342d2d2ca62c2874247be229653767447cf8dd3cfa9d491ae4f39decf6bec70d981a76c4f7fd488dacff1ad65d6fe29db44930173282cb15efe2d4402c870c88a20f9b223263baabff4492d9e64688cbdecb6dee0e086abbb23d0da044476879606b2c985e1c56fdfce167199e5730eb77c6715134956dfea69333711d7d5e5b3aab48a807362041d564fe29237b81c9d64b698");
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    // Large stress test, between 62-63 limbs each
+    big_read_string(&first, "defeda60ca0cea1deae4b3f6efbca62e7a5b85d4319d13a4f4d03ea033fc5684e6437725b470700bfe65852c84b3ac4219c1e53d7681203dd4a460c7c495ed62af5b2b992e684a95cfac9e24b6998b36e7cfbe5fa26bdcb75fb6a558764feec774654835de6b5cf5084f6d6c01e4e6316bfbd3e5be499ecdd02f37c4179209d6a1ecd08da973d54626a9545cce32f9140a0a5d87b5e204c1b2878c795fb88c40fb2079e359ec7922c0c2c0f979c5e362c03f3226e08ac73dd621fb881d641a2baa3e22554a6c018722353b04b4963bde0e3755f27494b1d4363f14005750802c9a021f19f6e65fccc82802227f2140423ca2631c4d9b58985609c38c372975a8c989418497de909e9afa6e5ff947369e3e956693bce2d870d4aba73b7630c8fb9bf9043785235b45dc780008950ada03089753e911858163a69fb4ffab2ab00f269b406e0dc42a7633679248290ba1cb9ac24287bb8d355b4432db1e31c31565668f52da9f0c2e7e4bcafcbce8abd7b275353fc92ed558c3c788b6780570d065b741cf62bba356590f9ace84a4b4d3e1df387cb0b5f04b8746659b9e7046757d6675de311279abea94a7d5a29f4b9c1f69c6d5015cb217bd5546b4c266b91905c2e63a4b7d2d5ef64270cf997d1c8be2ca84d382814ba593052bc582a770c3fb0ad3d6dda9237e2519cf61202261746218b52390");
+    big_read_string(&second, "f91e615533153dace94a3ac541e0deccbed3435c61eac4bf1571fbafbe2c4e3c5f9e1af757d2bdb1c6e987bd80879dfef564f9c3a993940658f84e85872b1aedf702b55bbc52ab5cf779f716262c4ce62fa16a83d0f1726e8ac1793c2fcbe24582536927e21c4c4ee67c66cd958432a29c08a2ddd852089e8816a28b4551629926fa50589921d7736e8b3f56506100eb8bf727672c3d10e19e33f269c428f5ef12606e6e4493929400c839e5966ce6972ae853b34918b0d66436a4c2b8ca9468d00407fc18497f4437490f1dfb4f0dc4eb76652459481ac695c8975990a919906daec6e24b06648731d8d5224479680f038914f9466cf92b8481013e67678990842c1662a81221fce574c83a7bbff8190b1e3f9c78053d32d245d17e8ff1bf0fae80183f6973321766db3dfaeff5aef90474b2dc099fa7c2961b4b51ee3ec5c71c8632bffc7c80929bf87680ca28d32a5d600a895f2d23c1a9ef364052a07a11c497a31e4263074fd517f78c8126cce17a7bebe7de9eb87455240ba8ccca8809c2c7e1fabe69ee5ea8024b7aba0a9e4bb06da0b85a6ffe6944bb08a2c2b2396028600b36ed91240e2ceec9232ccb0dd13b9bbb4fa970b7aa0599d0f5eab71b585f3718a501ee4674930c09045f022f647bb79b74446167ebf1767551374e0f62a0fb16c8b077999d32c70cdc037e011ffe893fa2");
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    // Large stress test, between 50-60 limbs each
+    big_read_string(&first, "687a5e9afce310334d2b9a243e3e2b0fda499e46c17b6cd3922da1c6a4d919f6fbfab8345654db500eaf364d47e714a3e6983a8f6d967c1e1f1847f481029325a52e35c527accbb1be9eeb946d7feb2710e119faff0cbb71ad3def09b2c041f98a7b6c281cc619d8ee35b100b997d254566111974cf404e3892e13e2d39f612a862c71c4a3c1671e395527a183a4748e47b57040a823dda71b2190d63425cbfb5b8dba3bbfce8222bc4763e6aed086f808dcc5fba0ecca0f93061340cf8545edd9db0ed866fd102ab1675ae0166957023c46c74a3f2b83844738a97380127180e4c00f5aec5ce94253a763c8a0aa0a6977087311416abd12039e4fe9f08e2b6d4d85c3b29ae64d5e70e0ee19f5ceb96c89893d83b886be46343e0f23a3402e9990af141837ae6d8e47db2abd202f59ecc31ec21d74a4d5dc150a1af77ec26d87d5a6d0c20bfb983ff94a58999d25da54c65480d8e9a2541dd4f7e93bbd8a6860bed6c48fb28bfe2bae3d10560e6a46f3571ec4767104e420f1817fadde9d5850f3caceb8902765f1355b7d4f8a0cc0824f968bb5e77cb127d1862f1b792ba84e398db5501333b8aacd583f6fd9000e9a8e80a4bd112feed761ea9e9583423cedf5929237f3e1a6f8a58e5580a5c1946dfbfa1c65c4d368e07eccbcbedf53430b80fbab3ebc92c49c8ade80e66dae431ff189f0ae");
+    big_read_string(&second, "c29ca4d4af402f5c04491194e0f0d42f2c863355fd72b91df3f94da582c236353fa2cff727ab8dab039621c53400bb08ef04fbd4ff31fefa039a3fc3aa012107941e4b346032b994d08c838e11d8a94abd5b61492cfaae54e84e185c84e4b3aa3a1bc1ae73868c422bd15abd0d1a5bf0ef2b48a966310cf68087303cde8d5aaff64aeac7610ca8d76bbdac960be7c2f985bffdd3256d54ef6214a68f1447fd714d91947ae66ca51a4f24e5c82bd12347aee80f39ce516d2ba8eaef3fdba7aa39796130c7c0f9fcc6f78db3e7af15c696e64829bb1d096b4d69862e67feb252986aa931017afba6c071783f86696a9bba78b815967cee1ee6eff7a493afa6b20b23ab8142afcf2b9cb7aa6c61eab8337e78b84798be089755223bfc6879faaadb620e1960046ee7a008e62a5ad173601c840e67c2cdd61055498ca33f51b48cf0a0bb65b13a01331017e3baacbb4c22203aec2826cfcb825f4702e33d79df474ee6589519da0a11b0013a3211ac471832ddc7297423015f520beb6d6d05b885fdf733890dd11c2fa9e6d6170e05a91c61f2cb93f16a1c12a9d4d78f90f3815fd1db3d89f639a8d95ddd160e599e1f7b53a3d04e4393fe65bee7f5cbb1a9cce6e8a4c0c2b2e3064cf7e916f0a70e4669f895470602575110c954ea946f8560b771aab36f134f");
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    big_free(&first);
+    big_free(&second);
+    big_free(&toom_result);
+    big_free(&karatsuba_result);
+    big_free(&actual);
+
+    printf("Multiple_diff_limbs_tests passed!\n");
+}
+
+/*
+Tests multiplication of two numbers with same number of limbs
+*/
+bool multiple_same_limb_tests() {
+    bigint first;
+    bigint second;
+    bigint toom_result;
+    bigint karatsuba_result;
+    bigint actual;
+
+    char a_buf[4000];
+    size_t temp;
+    char k_buf[4000];
+    char t_buf[4000];
+
+    big_init(&first);
+    big_init(&second);
+    big_init(&toom_result);
+    big_init(&karatsuba_result);
+    big_init(&actual);
+
+    // Easy 3x3 limb multiplication
+    first.num_limbs = 3;
+    first.data = malloc(first.num_limbs*sizeof(big_uint));
+    first.signum = 1;
+    first.data[0] = 1;
+    first.data[1] = 1;
+    first.data[2] = 1;
+
+    second.num_limbs = 3;
+    second.data = malloc(second.num_limbs*sizeof(big_uint));
+    second.signum = 1;
+    second.data[0] = 1;
+    second.data[1] = 1;
+    second.data[2] = 1;
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    big_free(&first);
+    big_free(&second);
+    big_free(&toom_result);
+    big_free(&karatsuba_result);
+    big_free(&actual);
+
+    big_init(&first);
+    big_init(&second);
+    big_init(&toom_result);
+    big_init(&karatsuba_result);
+    big_init(&actual);
+
+    // Harder 5x5 limb multiplication
+    first.num_limbs = 5;
+    first.data = malloc(first.num_limbs*sizeof(big_uint));
+    first.signum = 1;
+    first.data[0] = 1123123123123;
+    first.data[1] = 11241312;
+    first.data[2] = 1324234234;
+    first.data[3] = 1234234;
+    first.data[4] = 12342342;
+
+    second.num_limbs = 5;
+    second.data = malloc(second.num_limbs*sizeof(big_uint));
+    second.signum = 1;
+    second.data[0] = 1234234;
+    second.data[1] = 1234234;
+    second.data[2] = 1234234;
+    second.data[3] = 1234234;
+    second.data[4] = 1234234;
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    big_free(&first);
+    big_free(&second);
+    big_free(&toom_result);
+    big_free(&karatsuba_result);
+    big_free(&actual);
+
+    big_init(&first);
+    big_init(&second);
+    big_init(&toom_result);
+    big_init(&karatsuba_result);
+    big_init(&actual);
+
+    // Ensure this works with all 0s
+    first.num_limbs = 5;
+    first.data = malloc(first.num_limbs*sizeof(big_uint));
+    first.signum = 1;
+    first.data[0] = 0;
+    first.data[1] = 0;
+    first.data[2] = 0;
+    first.data[3] = 0;
+    first.data[4] = 0;
+
+    second.num_limbs = 5;
+    second.data = malloc(second.num_limbs*sizeof(big_uint));
+    second.signum = 1;
+    second.data[0] = 1;
+    second.data[1] = 1;
+    second.data[2] = 1;
+    second.data[3] = 1;
+    second.data[4] = 1;
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    big_free(&first);
+    big_free(&second);
+    big_free(&toom_result);
+    big_free(&karatsuba_result);
+    big_free(&actual);
+
+    big_init(&first);
+    big_init(&second);
+    big_init(&toom_result);
+    big_init(&karatsuba_result);
+    big_init(&actual);
+    // Ensure it works to handle UINTMAX Borrows, along with multiple limbs of
+    // just 0s 8x8 limb multiplication
+    // 1 number is negative
+    first.num_limbs = 8;
+    first.data = malloc(first.num_limbs*sizeof(big_uint));
+    first.signum = 1;
+    first.data[0] = UINT64_MAX;
+    first.data[1] = 0;
+    first.data[2] = 0;
+    first.data[3] = UINT64_MAX;
+    first.data[4] = UINT64_MAX;
+    first.data[5] = UINT64_MAX;
+    first.data[6] = UINT64_MAX;
+    first.data[7] = UINT64_MAX;
+
+    second.num_limbs = 8;
+    second.data = malloc(second.num_limbs*sizeof(big_uint));
+    second.signum = -1;
+    second.data[0] = UINT64_MAX;
+    second.data[1] = UINT64_MAX;
+    second.data[2] = UINT64_MAX;
+    second.data[3] = 0;
+    second.data[4] = 0;
+    second.data[5] = 0;
+    second.data[6] = UINT64_MAX;
+    second.data[7] = UINT64_MAX;
+
+    big_mul(&actual, &first, &second);
+    big_karatsuba(&karatsuba_result, &first, &second);
+    big_toom_cook(&toom_result, &first, &second);
+
+    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
+    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
+    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+
+    assert(strcmp(a_buf, k_buf) == 0);
+    assert(strcmp(a_buf, t_buf) == 0);
+
+    // Stress test of the same number multiplied together
+    // Number is negative
+    big_read_string(&first, "-1234567890ABCDEF1234DEF1234567890ABCD7890ABCDEF1234567890ABCDEFEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF12345678EF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890AB90ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF");
+    big_read_string(&second, "-1234567890ABCDEF1234DEF1234567890ABCD7890ABCDEF1234567890ABCDEFEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF12345678EF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890AB90ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF");
 
     big_mul(&actual, &first, &second);
     big_karatsuba(&karatsuba_result, &first, &second);
@@ -1373,402 +7944,2083 @@ bool multiple_diff_limb_tests() {
     big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
     big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
     big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
-
-    // Large stress test, between 62-63 limbs each
-    big_read_string(&first, "02c8829f01eb3ed605fabfa8a995d2a387bee957048d31b8734e7f9d9f1cdffb620362b4fdf3ef93f499f836ff81485fd049c0c56b05131554c3f0933f61b5039b42395f85970feccba0da1deda3f992e3dc7b47f6cf538f901ac621d46be1bb52c0980d5251afc5f75b08fec2f61f9a3d27a02f385205a4acf3b629d0eba49d202449d138735b8e25ca8b720649df3e1258a76deb309259be7faaf2948b4b50762dd11d248e0c3c8fc5bdf2fe2590cb91878b46de47714b4e09c1490cc9449996484925c62a1156b849c1301d8c498ed94ec1cf4929e1681a05bcf70dfd4651bc2f6b1f48a37f257671e4ca0604017c7ce58e138d80632e0bb923eda9e2c655b3218035127d8128ba9625d59ce2285fa6581e6bf777eba521b27cfa666c166198459752e2969b45f98948530b2472b2199ad62792686a840ace0a5c9b123dc60bc0e89f47458cbb2f59a84036d8439d12526a50c6b4ae38801a6e64e6ae360370806a6974346ba90f0301049329ae4adacda945b550bb8ad9b8567c57211705ffd728402ebbf8b16f96cfb2df9a361e0779af80011a4adfcf0634bd4f7ab84a27ba92b4377abf199b3aec690d73b145f7c74ce65cd64690e9dc7acc8ef9d7c302f24b9b99c06d375c17c21d338ebf83173121dd2187f7e0d1f3be719323bad8a0e5137e792baa9ecad188abbeaae49f4a149070");
-    big_read_string(&second, "3fdd56856497118617ebb06eebedcc91be32b0b1679ee797003e19d638cc5ea94257c5ba7162d2c5d0d67d7982933a4e963c44b643e8be08fa32e3a53698f7c96a94fbb9f286446f81ab2f834c94c790a88000b7566019cde9b6a0ca30760f07a880eb26362b00b7190f110be199c55c9de3d363835f0e82293e8959ce67ab819f53db3f7258ee7c13f3a6ac432a8c666c432afad0404e40131447ebe78cabce5e704ea554a362f8b96119f77350f99588a40c57a4d4c5bbf79758c2095a990e475a0ae9ea92244424dad32bc933fee96947b849eedea00a517ed29337ae5e99a552305b63b3adf9a26d49c79a51ba31f24ff7946a990393815539d425e81e0c5667b3d341da5e7c69d6350b684adb7d7f00394772e32289282baa6a3b9f5ced2118daef8e9d353aedf931722005ab0164e9c89e05f67f45cd411bd5a7241fcd9a92f1a1897b0b9e6ee87f31dc4ae9502fd874911335b903104cd2746dd6ac917342d2d2ca62c2874247be229653767447cf8dd3cfa9d491ae4f39decf6bec70d981a76c4f7fd488dacff1ad65d6fe29db44930173282cb15efe2d4402c870c88a20f9b223263baabff4492d9e64688cbdecb6dee0e086abbb23d0da044476879606b2c985e1c56fdfce167199e5730eb77c6715134956dfea69333711d7d5e5b3aab48a807362041d564fe29237b81c9d64b698");
-
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
     assert(strcmp(a_buf, k_buf) == 0);
     assert(strcmp(a_buf, t_buf) == 0);
 
-    // Large stress test, between 62-63 limbs each
-    big_read_string(&first, "defeda60ca0cea1deae4b3f6efbca62e7a5b85d4319d13a4f4d03ea033fc5684e6437725b470700bfe65852c84b3ac4219c1e53d7681203dd4a460c7c495ed62af5b2b992e684a95cfac9e24b6998b36e7cfbe5fa26bdcb75fb6a558764feec774654835de6b5cf5084f6d6c01e4e6316bfbd3e5be499ecdd02f37c4179209d6a1ecd08da973d54626a9545cce32f9140a0a5d87b5e204c1b2878c795fb88c40fb2079e359ec7922c0c2c0f979c5e362c03f3226e08ac73dd621fb881d641a2baa3e22554a6c018722353b04b4963bde0e3755f27494b1d4363f14005750802c9a021f19f6e65fccc82802227f2140423ca2631c4d9b58985609c38c372975a8c989418497de909e9afa6e5ff947369e3e956693bce2d870d4aba73b7630c8fb9bf9043785235b45dc780008950ada03089753e911858163a69fb4ffab2ab00f269b406e0dc42a7633679248290ba1cb9ac24287bb8d355b4432db1e31c31565668f52da9f0c2e7e4bcafcbce8abd7b275353fc92ed558c3c788b6780570d065b741cf62bba356590f9ace84a4b4d3e1df387cb0b5f04b8746659b9e7046757d6675de311279abea94a7d5a29f4b9c1f69c6d5015cb217bd5546b4c266b91905c2e63a4b7d2d5ef64270cf997d1c8be2ca84d382814ba593052bc582a770c3fb0ad3d6dda9237e2519cf61202261746218b52390");
-    big_read_string(&second, "f91e615533153dace94a3ac541e0deccbed3435c61eac4bf1571fbafbe2c4e3c5f9e1af757d2bdb1c6e987bd80879dfef564f9c3a993940658f84e85872b1aedf702b55bbc52ab5cf779f716262c4ce62fa16a83d0f1726e8ac1793c2fcbe24582536927e21c4c4ee67c66cd958432a29c08a2ddd852089e8816a28b4551629926fa50589921d7736e8b3f56506100eb8bf727672c3d10e19e33f269c428f5ef12606e6e4493929400c839e5966ce6972ae853b34918b0d66436a4c2b8ca9468d00407fc18497f4437490f1dfb4f0dc4eb76652459481ac695c8975990a919906daec6e24b06648731d8d5224479680f038914f9466cf92b8481013e67678990842c1662a81221fce574c83a7bbff8190b1e3f9c78053d32d245d17e8ff1bf0fae80183f6973321766db3dfaeff5aef90474b2dc099fa7c2961b4b51ee3ec5c71c8632bffc7c80929bf87680ca28d32a5d600a895f2d23c1a9ef364052a07a11c497a31e4263074fd517f78c8126cce17a7bebe7de9eb87455240ba8ccca8809c2c7e1fabe69ee5ea8024b7aba0a9e4bb06da0b85a6ffe6944bb08a2c2b2396028600b36ed91240e2ceec9232ccb0dd13b9bbb4fa970b7aa0599d0f5eab71b585f3718a501ee4674930c09045f022f647bb79b74446167ebf1767551374e0f62a0fb16c8b077999d32c70cdc037e011ffe893fa2");
+    big_free(&first);
+    big_free(&second);
+    big_free(&toom_result);
+    big_free(&karatsuba_result);
+    big_free(&actual);
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+    printf("Multiple_same_limb_tests passed!\n");
+}
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+// Generates a ramdom hexadecimal string of length length
+void gen_rand_hex(char *output, size_t length) {
+    const char hex_dict[] = "0123456789abcdef";
+    for (size_t i = 0; i < length; i++) {
+        output[i] = hex_dict[rand() % 16];
+    }
+    output[length] = '\0'; 
+}
 
-    // Large stress test, between 50-60 limbs each
-    big_read_string(&first, "687a5e9afce310334d2b9a243e3e2b0fda499e46c17b6cd3922da1c6a4d919f6fbfab8345654db500eaf364d47e714a3e6983a8f6d967c1e1f1847f481029325a52e35c527accbb1be9eeb946d7feb2710e119faff0cbb71ad3def09b2c041f98a7b6c281cc619d8ee35b100b997d254566111974cf404e3892e13e2d39f612a862c71c4a3c1671e395527a183a4748e47b57040a823dda71b2190d63425cbfb5b8dba3bbfce8222bc4763e6aed086f808dcc5fba0ecca0f93061340cf8545edd9db0ed866fd102ab1675ae0166957023c46c74a3f2b83844738a97380127180e4c00f5aec5ce94253a763c8a0aa0a6977087311416abd12039e4fe9f08e2b6d4d85c3b29ae64d5e70e0ee19f5ceb96c89893d83b886be46343e0f23a3402e9990af141837ae6d8e47db2abd202f59ecc31ec21d74a4d5dc150a1af77ec26d87d5a6d0c20bfb983ff94a58999d25da54c65480d8e9a2541dd4f7e93bbd8a6860bed6c48fb28bfe2bae3d10560e6a46f3571ec4767104e420f1817fadde9d5850f3caceb8902765f1355b7d4f8a0cc0824f968bb5e77cb127d1862f1b792ba84e398db5501333b8aacd583f6fd9000e9a8e80a4bd112feed761ea9e9583423cedf5929237f3e1a6f8a58e5580a5c1946dfbfa1c65c4d368e07eccbcbedf53430b80fbab3ebc92c49c8ade80e66dae431ff189f0ae");
-    big_read_string(&second, "c29ca4d4af402f5c04491194e0f0d42f2c863355fd72b91df3f94da582c236353fa2cff727ab8dab039621c53400bb08ef04fbd4ff31fefa039a3fc3aa012107941e4b346032b994d08c838e11d8a94abd5b61492cfaae54e84e185c84e4b3aa3a1bc1ae73868c422bd15abd0d1a5bf0ef2b48a966310cf68087303cde8d5aaff64aeac7610ca8d76bbdac960be7c2f985bffdd3256d54ef6214a68f1447fd714d91947ae66ca51a4f24e5c82bd12347aee80f39ce516d2ba8eaef3fdba7aa39796130c7c0f9fcc6f78db3e7af15c696e64829bb1d096b4d69862e67feb252986aa931017afba6c071783f86696a9bba78b815967cee1ee6eff7a493afa6b20b23ab8142afcf2b9cb7aa6c61eab8337e78b84798be089755223bfc6879faaadb620e1960046ee7a008e62a5ad173601c840e67c2cdd61055498ca33f51b48cf0a0bb65b13a01331017e3baacbb4c22203aec2826cfcb825f4702e33d79df474ee6589519da0a11b0013a3211ac471832ddc7297423015f520beb6d6d05b885fdf733890dd11c2fa9e6d6170e05a91c61f2cb93f16a1c12a9d4d78f90f3815fd1db3d89f639a8d95ddd160e599e1f7b53a3d04e4393fe65bee7f5cbb1a9cce6e8a4c0c2b2e3064cf7e916f0a70e4669f895470602575110c954ea946f8560b771aab36f134f");
+// Generates a random number between low-high
+int gen_rand(int low, int high) {
+    if (low > high) {
+        int temp = low;
+        low = high;
+        high = temp;
+    }
+    return low + (rand() % (high - low + 1));
+}
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+/*
+Tests big_mul_fft and big_mul_auto against big_mul, including all-ones limbs
+which push every convolution coefficient close to the CRT bound.
+*/
+bool fft_tests() {
+    bigint first, second, actual, fft_result, auto_result;
+    big_init(&first);
+    big_init(&second);
+    big_init(&actual);
+    big_init(&fft_result);
+    big_init(&auto_result);
+
+    size_t max_len = 6000;
+    char *a_hex = malloc(max_len + 2);
+    char *b_hex = malloc(max_len + 2);
+    char *a_buf = malloc(2 * max_len + 2);
+    char *f_buf = malloc(2 * max_len + 2);
+    char *m_buf = malloc(2 * max_len + 2);
+    size_t temp;
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+    srand(4321);
+    for (int i = 0; i < 20; i++) {
+        size_t a_len = 1 + rand() % max_len;
+        size_t b_len = 1 + rand() % max_len;
+        a_hex[0] = (i % 2) ? '-' : 'f';
+        b_hex[0] = (i % 3) ? 'f' : '-';
+        if (i < 4) {
+            // Every limb UINT64_MAX
+            memset(a_hex + 1, 'f', a_len);
+            memset(b_hex + 1, 'f', b_len);
+            a_hex[a_len + 1] = '\0';
+            b_hex[b_len + 1] = '\0';
+        }
+        else {
+            gen_rand_hex(a_hex + 1, a_len);
+            gen_rand_hex(b_hex + 1, b_len);
+        }
+        big_read_string(&first, a_hex);
+        big_read_string(&second, b_hex);
+
+        big_mul(&actual, &first, &second);
+        big_mul_fft(&fft_result, &first, &second);
+        big_mul_auto(&auto_result, &first, &second);
+
+        big_write_string(&actual, a_buf, 2 * max_len + 2, &temp);
+        big_write_string(&fft_result, f_buf, 2 * max_len + 2, &temp);
+        big_write_string(&auto_result, m_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, f_buf) == 0);
+        assert(strcmp(a_buf, m_buf) == 0);
+    }
 
+    free(a_hex);
+    free(b_hex);
+    free(a_buf);
+    free(f_buf);
+    free(m_buf);
     big_free(&first);
     big_free(&second);
-    big_free(&toom_result);
-    big_free(&karatsuba_result);
     big_free(&actual);
+    big_free(&fft_result);
+    big_free(&auto_result);
 
-    printf("Multiple_diff_limbs_tests passed!\n");
+    printf("FFT_tests passed!\n");
+    return true;
 }
 
 /*
-Tests multiplication of two numbers with same number of limbs
+Multiplies and squares through Toom-4 and Toom-6.5 at every level of the
+recursion they can reach, with their cutoffs lowered so that short operands
+take them too, and compares against big_mul. Operands of all ones push every
+evaluation and interpolation value to its largest size.
 */
-bool multiple_same_limb_tests() {
-    bigint first;
-    bigint second;
-    bigint toom_result;
-    bigint karatsuba_result;
-    bigint actual;
-
-    char a_buf[4000];
+bool toom_tests() {
+    bigint A, B, actual, result;
+    big_init(&A);
+    big_init(&B);
+    big_init(&actual);
+    big_init(&result);
+    size_t saved[6] = {toom3_threshold, toom4_threshold, toom6h_threshold,
+                       sqr_toom3_threshold, sqr_toom4_threshold, sqr_toom6h_threshold};
+
+    size_t max_len = 16 * 2500;
+    char *a_hex = malloc(max_len + 2);
+    char *b_hex = malloc(max_len + 2);
+    char *a_buf = malloc(2 * max_len + 2);
+    char *r_buf = malloc(2 * max_len + 2);
     size_t temp;
-    char k_buf[4000];
-    char t_buf[4000];
 
-    big_init(&toom_result);
-    big_init(&karatsuba_result);
+    srand(1357);
+    for (int i = 0; i < 24; i++) {
+        // Toom-6.5 right above Toom-3, then a Toom-4 tier between them
+        toom3_threshold = sqr_toom3_threshold = 32;
+        toom4_threshold = sqr_toom4_threshold = (i < 12) ? 33 : 100;
+        toom6h_threshold = sqr_toom6h_threshold = (i < 12) ? 33 : 400;
+        size_t len = 16 * (34 + rand() % 2466);
+        a_hex[0] = (i % 2) ? '-' : 'f';
+        b_hex[0] = (i % 3) ? 'f' : '-';
+        gen_rand_hex(a_hex + 1, len - 1);
+        gen_rand_hex(b_hex + 1, len - 1);
+        if (i % 6 == 0) {
+            memset(a_hex + 1, 'f', len - 1);
+            memset(b_hex + 1, 'f', len - 1);
+        }
+        big_read_string(&A, a_hex);
+        big_read_string(&B, b_hex);
+
+        big_mul(&actual, &A, &B);
+        big_write_string(&actual, a_buf, 2 * max_len + 2, &temp);
+        assert(big_mul_auto(&result, &A, &B) == 0);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        assert(big_toom4(&result, &A, &B) == 0);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        assert(big_toom6h(&result, &A, &B) == 0);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+
+        big_mul(&actual, &A, &A);
+        big_write_string(&actual, a_buf, 2 * max_len + 2, &temp);
+        assert(big_toom4(&result, &A, &A) == 0);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        assert(big_sqr(&A, &A) == 0);
+        big_write_string(&A, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+    }
+
+    toom3_threshold = saved[0];
+    toom4_threshold = saved[1];
+    toom6h_threshold = saved[2];
+    sqr_toom3_threshold = saved[3];
+    sqr_toom4_threshold = saved[4];
+    sqr_toom6h_threshold = saved[5];
+    free(a_hex);
+    free(b_hex);
+    free(a_buf);
+    free(r_buf);
+    big_free(&A);
+    big_free(&B);
+    big_free(&actual);
+    big_free(&result);
+
+    printf("Toom_tests passed!\n");
+    return true;
+}
+
+/*
+Squares through every entry point, big_sqr in place as well, and compares
+against big_mul on a separate copy of the operand, which takes the general
+product. The sizes cover each squaring method up to the FFT.
+*/
+bool sqr_tests() {
+    bigint A, copy, actual, result;
+    big_init(&A);
+    big_init(&copy);
     big_init(&actual);
+    big_init(&result);
 
-    // Easy 3x3 limb multiplication
-    first.num_limbs = 3;
-    first.data = malloc(first.num_limbs*sizeof(big_uint));
-    first.signum = 1;
-    first.data[0] = 1;
-    first.data[1] = 1;
-    first.data[2] = 1;
+    size_t max_len = 50000;
+    char *a_hex = malloc(max_len + 2);
+    char *a_buf = malloc(2 * max_len + 2);
+    char *r_buf = malloc(2 * max_len + 2);
+    size_t temp;
 
-    second.num_limbs = 3;
-    second.data = malloc(second.num_limbs*sizeof(big_uint));
-    second.signum = 1;
-    second.data[0] = 1;
-    second.data[1] = 1;
-    second.data[2] = 1;
+    srand(2468);
+    for (int i = 0; i < 16; i++) {
+        size_t a_len = (i == 15) ? max_len : 1 + (size_t)rand() % 13000;
+        a_hex[0] = (i % 2) ? '-' : 'f';
+        gen_rand_hex(a_hex + 1, a_len);
+        big_read_string(&A, a_hex);
+        big_copy(&copy, &A);
+        big_mul(&actual, &A, &copy);
+        big_write_string(&actual, a_buf, 2 * max_len + 2, &temp);
+
+        big_sqr(&result, &A);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        big_mul(&result, &A, &A);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        big_karatsuba(&result, &A, &A);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        big_toom_cook(&result, &A, &A);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        big_sqr(&A, &A);
+        big_write_string(&A, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+    }
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+    free(a_hex);
+    free(a_buf);
+    free(r_buf);
+    big_free(&A);
+    big_free(&copy);
+    big_free(&actual);
+    big_free(&result);
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    printf("Sqr_tests passed!\n");
+    return true;
+}
 
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+/*
+Checks big_addmul and big_submul against big_mul_auto and big_add for
+operands of random signs on both sides of karatsuba_threshold and of the
+stack buffer, with X chosen both at random and as plus or minus the
+product, where the result crosses zero. Then aliasing, and the single limb
+operations against their full size counterparts, including carries and
+borrows through every limb.
+*/
+bool scalar_tests() {
+    bigint A, B, X, expect, check, U;
+    big_init(&A);
+    big_init(&B);
+    big_init(&X);
+    big_init(&expect);
+    big_init(&check);
+    big_init(&U);
+    char *hex = malloc(16 * 700 + 2);
+
+    srand(1357);
+    // 700 limbs by a short operand runs past the stack buffer, into the rows
+    size_t sizes[] = {0, 1, 2, 5, karatsuba_threshold - 1, karatsuba_threshold, 150, 700};
+    size_t count = sizeof(sizes) / sizeof(sizes[0]);
+    for (int round = 0; round < 300; round++) {
+        size_t lens[3];
+        for (int k = 0; k < 3; k++) {
+            lens[k] = sizes[rand() % count];
+        }
+        bigint *ops[3] = {&A, &B, &X};
+        for (int k = 0; k < 3; k++) {
+            if (lens[k] == 0) {
+                big_set_nonzero(ops[k], 0);
+                continue;
+            }
+            gen_rand_hex(hex, 16 * lens[k]);
+            big_read_string(ops[k], hex);
+            ops[k]->signum = (rand() % 2) ? -1 : 1;
+        }
+        bool subtract = rand() % 2;
+        if (round % 3 == 0) {
+            // X = -+A * B give or take a little, so the result is small
+            big_mul_auto(&X, &A, &B);
+            X.signum = subtract ? X.signum : -X.signum;
+            big_add_ui(&X, &X, rand() % 3);
+        }
+        big_mul_auto(&check, &A, &B);
+        if (subtract) {
+            big_sub(&expect, &X, &check);
+            assert(big_submul(&X, &A, &B) == 0);
+        }
+        else {
+            big_add(&expect, &X, &check);
+            assert(big_addmul(&X, &A, &B) == 0);
+        }
+        assert(big_cmp(&X, &expect) == 0);
+    }
 
-    big_free(&first);
-    big_free(&second);
-    big_free(&toom_result);
-    big_free(&karatsuba_result);
+    gen_rand_hex(hex, 16 * 40);
+    big_read_string(&A, hex);
+    gen_rand_hex(hex, 16 * 30);
+    big_read_string(&B, hex);
+    big_mul_auto(&check, &A, &B);
+    big_add(&expect, &A, &check);
+    big_copy(&X, &A);
+    assert(big_addmul(&X, &X, &B) == 0 && big_cmp(&X, &expect) == 0);
+    big_add(&expect, &B, &check);
+    big_copy(&X, &B);
+    assert(big_addmul(&X, &A, &X) == 0 && big_cmp(&X, &expect) == 0);
+    big_sqr(&check, &A);
+    big_sub(&expect, &A, &check);
+    big_copy(&X, &A);
+    assert(big_submul(&X, &X, &X) == 0 && big_cmp(&X, &expect) == 0);
+
+    big_uint us[] = {0, 1, 2, 977, UINT64_MAX - 1, UINT64_MAX};
+    for (int round = 0; round < 40; round++) {
+        switch (round % 4) {
+        case 0:
+            big_set_nonzero(&A, 0);
+            break;
+        case 1:
+            big_set_nonzero(&A, rand() % 4);
+            break;
+        case 2:
+            // 2^(64n) or 2^(64n) - 1, where a carry or borrow runs through
+            big_set_nonzero(&A, 1);
+            big_bit_shift_left(&A, &A, 64 * (1 + rand() % 4));
+            big_sub_ui(&A, &A, rand() % 2);
+            break;
+        default:
+            gen_rand_hex(hex, 16 * (1 + rand() % 20));
+            big_read_string(&A, hex);
+        }
+        A.signum = (round % 8 < 4 || big_is_zero(&A)) ? 1 : -1;
+        for (size_t k = 0; k < sizeof(us) / sizeof(us[0]); k++) {
+            big_set_nonzero(&U, us[k]);
+            big_add(&expect, &A, &U);
+            assert(big_add_ui(&X, &A, us[k]) == 0 && big_cmp(&X, &expect) == 0);
+            big_sub(&expect, &A, &U);
+            assert(big_sub_ui(&X, &A, us[k]) == 0 && big_cmp(&X, &expect) == 0);
+            big_mul(&expect, &A, &U);
+            assert(big_mul_ui(&X, &A, us[k]) == 0 && big_cmp(&X, &expect) == 0);
+            big_copy(&X, &A);
+            assert(big_mul_ui(&X, &X, us[k]) == 0 && big_cmp(&X, &expect) == 0);
+            big_copy(&X, &A);
+            big_add(&expect, &A, &U);
+            assert(big_add_ui(&X, &X, us[k]) == 0 && big_cmp(&X, &expect) == 0);
+        }
+    }
+    assert(big_addmul(NULL, &A, &B) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_submul(&X, NULL, &B) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_mul_ui(&X, NULL, 3) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_add_ui(NULL, &A, 3) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_sub_ui(&X, NULL, 3) == ERR_BIGINT_BAD_INPUT_DATA);
+
+    free(hex);
+    big_free(&A);
+    big_free(&B);
+    big_free(&X);
+    big_free(&expect);
+    big_free(&check);
+    big_free(&U);
+
+    printf("Scalar_tests passed!\n");
+    return true;
+}
+
+/*
+Multiplies operands of different lengths with big_mul_auto, big_karatsuba
+and big_toom_cook and compares against big_mul. The limb counts hit the
+nearly balanced chunks, Toom-2.5, Toom-4x2 and the long chunked products,
+and both operand orders.
+*/
+bool unbalanced_tests() {
+    bigint A, B, actual, result;
+    big_init(&A);
+    big_init(&B);
+    big_init(&actual);
+    big_init(&result);
+
+    size_t shapes[][2] = {{131, 130}, {1601, 1600}, {300, 250}, {1200, 1000}, {700, 400},
+                          {1900, 1000}, {2500, 900}, {2999, 150}, {2999, 65}, {2000, 2999}};
+    size_t max_len = 16 * 2999;
+    char *a_hex = malloc(max_len + 2);
+    char *b_hex = malloc(max_len + 2);
+    char *a_buf = malloc(2 * max_len + 2);
+    char *r_buf = malloc(2 * max_len + 2);
+    size_t temp;
+
+    srand(1357);
+    for (int i = 0; i < 20; i++) {
+        size_t a_len = 16 * shapes[i / 2][i % 2];
+        size_t b_len = 16 * shapes[i / 2][1 - i % 2];
+        a_hex[0] = (i % 3) ? 'f' : '-';
+        b_hex[0] = 'f';
+        gen_rand_hex(a_hex + 1, a_len - 1);
+        gen_rand_hex(b_hex + 1, b_len - 1);
+        big_read_string(&A, a_hex);
+        big_read_string(&B, b_hex);
+        big_mul(&actual, &A, &B);
+        big_write_string(&actual, a_buf, 2 * max_len + 2, &temp);
+
+        big_mul_auto(&result, &A, &B);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        big_karatsuba(&result, &A, &B);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+        big_toom_cook(&result, &A, &B);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+    }
+
+    free(a_hex);
+    free(b_hex);
+    free(a_buf);
+    free(r_buf);
+    big_free(&A);
+    big_free(&B);
     big_free(&actual);
+    big_free(&result);
 
-    big_init(&first);
-    big_init(&second);
-    big_init(&toom_result);
-    big_init(&karatsuba_result);
+    printf("Unbalanced_tests passed!\n");
+    return true;
+}
+
+/*
+Compares big_mul_parallel on a pool of 4 threads against big_mul. The cutoff
+is lowered for the duration so these moderate lengths already go through
+the Toom-3, Karatsuba and unbalanced nodes, squares and aliased X included.
+*/
+bool parallel_tests() {
+    bigint A, B, actual, result;
+    big_init(&A);
+    big_init(&B);
     big_init(&actual);
+    big_init(&result);
+    big_thread_pool *pool;
+    assert(big_pool_init(&pool, 4) == 0);
+    size_t saved_threshold = parallel_mul_threshold;
+    parallel_mul_threshold = 100;
+
+    size_t shapes[][2] = {{50, 40}, {200, 200}, {1000, 1000}, {2999, 2999}, {3000, 700},
+                          {150, 2999}, {101, 300}, {2000, 1999}};
+    size_t max_len = 16 * 3000;
+    char *a_hex = malloc(max_len + 2);
+    char *b_hex = malloc(max_len + 2);
+    char *a_buf = malloc(2 * max_len + 2);
+    char *r_buf = malloc(2 * max_len + 2);
+    size_t temp;
 
-    // Harder 5x5 limb multiplication
-    first.num_limbs = 5;
-    first.data = malloc(first.num_limbs*sizeof(big_uint));
-    first.signum = 1;
-    first.data[0] = 1123123123123;
-    first.data[1] = 11241312;
-    first.data[2] = 1324234234;
-    first.data[3] = 1234234;
-    first.data[4] = 12342342;
+    srand(8642);
+    for (int i = 0; i < 8; i++) {
+        a_hex[0] = (i % 2) ? '-' : 'f';
+        b_hex[0] = 'f';
+        gen_rand_hex(a_hex + 1, 16 * shapes[i][0] - 1);
+        gen_rand_hex(b_hex + 1, 16 * shapes[i][1] - 1);
+        big_read_string(&A, a_hex);
+        big_read_string(&B, b_hex);
+        big_mul(&actual, &A, &B);
+        big_write_string(&actual, a_buf, 2 * max_len + 2, &temp);
+        assert(big_mul_parallel(&result, &A, &B, pool) == 0);
+        big_write_string(&result, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+
+        big_mul(&actual, &A, &A);
+        big_write_string(&actual, a_buf, 2 * max_len + 2, &temp);
+        assert(big_mul_parallel(&A, &A, &A, pool) == 0);
+        big_write_string(&A, r_buf, 2 * max_len + 2, &temp);
+        assert(strcmp(a_buf, r_buf) == 0);
+    }
 
-    second.num_limbs = 5;
-    second.data = malloc(second.num_limbs*sizeof(big_uint));
-    second.signum = 1;
-    second.data[0] = 1234234;
-    second.data[1] = 1234234;
-    second.data[2] = 1234234;
-    second.data[3] = 1234234;
-    second.data[4] = 1234234;
+    parallel_mul_threshold = saved_threshold;
+    big_pool_free(pool);
+    free(a_hex);
+    free(b_hex);
+    free(a_buf);
+    free(r_buf);
+    big_free(&A);
+    big_free(&B);
+    big_free(&actual);
+    big_free(&result);
+
+    printf("Parallel_tests passed!\n");
+    return true;
+}
+
+/*
+Tests big_div, checking A == Q * B + R with |R| < |B| on small hand picked
+cases, every sign combination, and random operands long enough to go
+through the recursive (Burnikel-Ziegler) path.
+*/
+bool division_tests() {
+    bigint A, B, Q, R, check;
+    big_init(&A);
+    big_init(&B);
+    big_init(&Q);
+    big_init(&R);
+    big_init(&check);
+
+    char q_buf[100];
+    char r_buf[100];
+    size_t temp;
+
+    // Division by zero must be rejected
+    big_set_nonzero(&A, 5);
+    big_set_nonzero(&B, 0);
+    assert(big_div(&Q, &R, &A, &B) == ERR_BIGINT_DIVISION_BY_ZERO);
+
+    // -7 / 2 = -3 rest -1, quotient rounds towards zero
+    big_set_nonzero(&A, 7);
+    big_set_nonzero(&B, 2);
+    A.signum = -1;
+    big_div(&Q, &R, &A, &B);
+    big_write_string(&Q, q_buf, sizeof(q_buf), &temp);
+    big_write_string(&R, r_buf, sizeof(r_buf), &temp);
+    assert(strcmp(q_buf, "-3") == 0);
+    assert(strcmp(r_buf, "-1") == 0);
+
+    // Dividend smaller than divisor, only asking for the rest
+    big_read_string(&A, "1234");
+    big_read_string(&B, "-ffffffffffffffffffff");
+    big_div(NULL, &R, &A, &B);
+    big_write_string(&R, r_buf, sizeof(r_buf), &temp);
+    assert(strcmp(r_buf, "1234") == 0);
+
+    // A zero dividend that has never held any limbs
+    bigint zero;
+    big_init(&zero);
+    big_set_nonzero(&B, 7);
+    assert(big_div(NULL, &R, &zero, &B) == 0 && big_is_zero(&R));
+    assert(big_div(&Q, &R, &zero, &B) == 0 && big_is_zero(&Q) && big_is_zero(&R));
+
+    // 2^128 / (2^64 + 1), only asking for the quotient
+    big_read_string(&A, "100000000000000000000000000000000");
+    big_read_string(&B, "10000000000000001");
+    big_div(&Q, NULL, &A, &B);
+    big_write_string(&Q, q_buf, sizeof(q_buf), &temp);
+    assert(strcmp(q_buf, "ffffffffffffffff") == 0);
+
+    // Q or R aliasing A or B, with a divisor whose top bit is already set,
+    // which is used in place, and with one that has to be shifted
+    const char *aliased[] = {"f000000000000000123456789abcdef1", "123456789abcdef0fedcba987"};
+    bigint Q2, R2;
+    big_init(&Q2);
+    big_init(&R2);
+    for (int i = 0; i < 2; i++) {
+        big_read_string(&A, "5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5a5");
+        big_read_string(&B, aliased[i]);
+        big_div(&Q2, &R2, &A, &B);
+        big_copy(&check, &B);
+        assert(big_div(&check, NULL, &A, &check) == 0 && big_cmp(&check, &Q2) == 0);
+        big_copy(&check, &B);
+        assert(big_div(NULL, &check, &A, &check) == 0 && big_cmp(&check, &R2) == 0);
+        big_copy(&check, &B);
+        assert(big_div(&Q, &check, &A, &check) == 0 && big_cmp(&Q, &Q2) == 0 && big_cmp(&check, &R2) == 0);
+        big_copy(&check, &B);
+        assert(big_div(&check, &R, &A, &check) == 0 && big_cmp(&check, &Q2) == 0 && big_cmp(&R, &R2) == 0);
+        big_copy(&check, &A);
+        assert(big_div(&check, &R, &check, &B) == 0 && big_cmp(&check, &Q2) == 0 && big_cmp(&R, &R2) == 0);
+        big_copy(&check, &A);
+        assert(big_div(&Q, &check, &check, &B) == 0 && big_cmp(&Q, &Q2) == 0 && big_cmp(&check, &R2) == 0);
+    }
+    big_free(&Q2);
+    big_free(&R2);
+
+    // Random stress tests, up to 250 limbs by 125 limbs, all sign combinations
+    size_t max_len = 4000;
+    char *a_hex = malloc(max_len + 2);
+    char *b_hex = malloc(max_len + 2);
+    char *a_buf = malloc(max_len + 2);
+    char *c_buf = malloc(max_len + 2);
+    srand(12345);
+    for (int i = 0; i < 40; i++) {
+        size_t b_len = 1 + rand() % (max_len / 2);
+        size_t a_len = b_len + rand() % (max_len - b_len);
+        a_hex[0] = (i % 2) ? '-' : '1';
+        b_hex[0] = (i % 4 >= 2) ? '-' : '1';
+        gen_rand_hex(a_hex + 1, a_len);
+        gen_rand_hex(b_hex + 1, b_len);
+        big_read_string(&A, a_hex);
+        big_read_string(&B, b_hex);
+
+        assert(big_div(&Q, &R, &A, &B) == 0);
+        assert(cmp_abs(&R, &B) < 0 || big_is_zero(&R));
+        big_karatsuba(&check, &Q, &B);
+        big_add(&check, &check, &R);
+
+        big_write_string(&A, a_buf, max_len + 2, &temp);
+        big_write_string(&check, c_buf, max_len + 2, &temp);
+        assert(strcmp(a_buf, c_buf) == 0);
+    }
+
+    // Single limb divisors, against big_div. 2^63 and 10^19 are normalized,
+    // the others need shifting, and 12 and 2^63 are even
+    big_uint divisors[] = {1, 2, 3, 7, 12, 0x8000000000000000ULL, 10000000000000000000ULL,
+                           0x123456789abcdefULL, 0xfffffffffffffffbULL};
+    size_t num_divisors = sizeof(divisors) / sizeof(divisors[0]);
+    big_uint rest;
+    big_set_nonzero(&A, 9);
+    assert(big_div_ui(&Q, &rest, &A, 0) == ERR_BIGINT_DIVISION_BY_ZERO);
+    assert(big_divexact_ui(&Q, &A, 0) == ERR_BIGINT_DIVISION_BY_ZERO);
+    for (int i = 0; i < 40; i++) {
+        size_t a_len = 1 + rand() % (max_len / 4);
+        a_hex[0] = (i % 2) ? '-' : '1';
+        gen_rand_hex(a_hex + 1, a_len);
+        big_read_string(&A, a_hex);
+        big_uint d = divisors[i % num_divisors];
+        big_set_nonzero(&B, d);
+
+        // Q = A / d rest r, then r alone, then in place
+        assert(big_div_ui(&Q, &rest, &A, d) == 0);
+        big_div(&check, &R, &A, &B);
+        assert(big_cmp(&Q, &check) == 0);
+        assert(rest == (big_is_zero(&R) ? 0 : R.data[0]));
+        rest = 0;
+        assert(big_div_ui(NULL, &rest, &A, d) == 0);
+        assert(rest == (big_is_zero(&R) ? 0 : R.data[0]));
+        big_copy(&R, &A);
+        assert(big_div_ui(&R, NULL, &R, d) == 0);
+        assert(big_cmp(&R, &check) == 0);
+
+        // (A * d) / d = A exactly, also in place
+        big_karatsuba(&check, &A, &B);
+        assert(big_divexact_ui(&Q, &check, d) == 0);
+        assert(big_cmp(&Q, &A) == 0);
+        assert(big_divexact_ui(&check, &check, d) == 0);
+        assert(big_cmp(&check, &A) == 0);
+    }
+    big_set_nonzero(&A, 0);
+    assert(big_divexact_ui(&Q, &A, 3) == 0 && big_is_zero(&Q));
+
+    free(a_hex);
+    free(b_hex);
+    free(a_buf);
+    free(c_buf);
+
+    big_free(&A);
+    big_free(&B);
+    big_free(&Q);
+    big_free(&R);
+    big_free(&check);
+
+    printf("Division_tests passed!\n");
+    return true;
+}
+
+/*
+Tests big_mullo and big_mulhi against the full product, with the short
+product threshold lowered for part of the run so moderate lengths already
+recurse, and limb_mulhi_n against its error bound. Then big_barrett_reduce
+against big_div for odd, even and power of 2 moduli, M = 2^64 whose mu is
+capped, and values of both signs up to five times the length of M.
+*/
+bool barrett_tests() {
+    bigint A, B, M, X, check, R;
+    big_init(&A);
+    big_init(&B);
+    big_init(&M);
+    big_init(&X);
+    big_init(&check);
+    big_init(&R);
+    big_barrett_ctx ctx;
+
+    // The modulus must be positive
+    big_set_nonzero(&M, 0);
+    assert(big_barrett_init(&ctx, &M) == ERR_BIGINT_BAD_INPUT_DATA);
+    big_set_nonzero(&M, 10);
+    M.signum = -1;
+    assert(big_barrett_init(&ctx, &M) == ERR_BIGINT_BAD_INPUT_DATA);
+
+    // All ones times 1 puts limb n - 1 of the product at UINT64_MAX, which
+    // only the full product can tell apart from a carry into limb n
+    size_t max_limbs = 300;
+    char *a_hex = malloc(16 * 5 * max_limbs + 2);
+    char *b_hex = malloc(16 * max_limbs + 2);
+    memset(a_hex, 'f', 16 * 40);
+    a_hex[16 * 40] = '\0';
+    big_read_string(&A, a_hex);
+    big_set_nonzero(&B, 1);
+    assert(big_mulhi(&X, &A, &B, 40) == 0 && big_is_zero(&X));
+
+    size_t saved_threshold = mullo_threshold;
+    big_uint *tp = malloc((4 * max_limbs + short_mul_scratch_size(max_limbs)) * sizeof(big_uint));
+    srand(1357);
+    for (int i = 0; i < 40; i++) {
+        mullo_threshold = (i < 20) ? 8 : saved_threshold;
+        size_t n = 1 + rand() % max_limbs;
+        size_t an = (i % 5 == 0) ? n + 1 + rand() % 20 : 1 + rand() % n;
+        size_t bn = 1 + rand() % n;
+        a_hex[0] = (i % 2) ? '-' : 'f';
+        b_hex[0] = (i % 3) ? 'f' : '-';
+        if (i % 4 == 1) {
+            memset(a_hex + 1, 'f', 16 * an - 1);
+            memset(b_hex + 1, 'f', 16 * bn - 1);
+            a_hex[16 * an] = '\0';
+            b_hex[16 * bn] = '\0';
+        }
+        else {
+            gen_rand_hex(a_hex + 1, 16 * an - 1);
+            gen_rand_hex(b_hex + 1, 16 * bn - 1);
+        }
+        big_read_string(&A, a_hex);
+        big_read_string(&B, b_hex);
+
+        // Low and high n limbs of the full product
+        big_mul(&R, &A, &B);
+        big_copy(&check, &R);
+        big_normalize(&check, (check.num_limbs < n) ? check.num_limbs : n, check.signum);
+        assert(big_mullo(&X, &A, &B, n) == 0);
+        assert(big_cmp(&X, &check) == 0);
+        big_bit_shift_right(&check, &R, 64 * n);
+        assert(big_mulhi(&X, &A, &B, n) == 0);
+        assert(big_cmp(&X, &check) == 0);
+        big_copy(&X, &A);
+        assert(big_mulhi(&X, &X, &B, n) == 0);
+        assert(big_cmp(&X, &check) == 0);
+
+        // The approximation stays within 2n below
+        if (an <= n) {
+            big_uint *ap = tp;
+            big_uint *bp = tp + n;
+            big_uint *hp = tp + 2 * n;
+            memset(tp, 0, 2 * n * sizeof(big_uint));
+            memcpy(ap, A.data, an * sizeof(big_uint));
+            memcpy(bp, B.data, bn * sizeof(big_uint));
+            limb_mulhi_n(hp, ap, bp, n, tp + 4 * n);
+            memset(tp + 3 * n, 0, n * sizeof(big_uint));
+            memcpy(tp + 3 * n, check.data, limb_trimmed_len(check.data, check.num_limbs) * sizeof(big_uint));
+            assert(limb_sub_n(tp + 3 * n, tp + 3 * n, hp, n) == 0);
+            assert(limb_trimmed_len(tp + 3 * n, n) <= 1 && tp[3 * n] <= 2 * n);
+        }
+    }
+    mullo_threshold = saved_threshold;
+    free(tp);
+
+    // Reduction against big_div, the power of 2 and M = 2^64 moduli first
+    const char *moduli[] = {"1", "2", "10000000000000000", "100000000000000000000000000000000", "3"};
+    for (int i = 0; i < 40; i++) {
+        if (i < 5) {
+            big_read_string(&M, moduli[i]);
+        }
+        else {
+            size_t m_len = 1 + rand() % (16 * max_limbs / 2);
+            b_hex[0] = '1' + rand() % 9;
+            gen_rand_hex(b_hex + 1, m_len);
+            big_read_string(&M, b_hex);
+            if (i % 2) {
+                M.data[0] &= ~(big_uint)1;
+            }
+        }
+        assert(big_barrett_init(&ctx, &M) == 0);
+        size_t n = ctx.n;
+        for (int j = 0; j < 4; j++) {
+            size_t a_len = 1 + rand() % (16 * (j + 1) * n + 16);
+            a_hex[0] = (j % 2) ? '-' : '1';
+            gen_rand_hex(a_hex + 1, a_len);
+            big_read_string(&A, a_hex);
+            big_div(NULL, &R, &A, &M);
+            if (R.signum < 0 && !big_is_zero(&R)) {
+                big_add(&R, &R, &M);
+            }
+            assert(big_barrett_reduce(&X, &A, &ctx) == 0);
+            assert(big_cmp(&X, &R) == 0);
+            assert(big_barrett_reduce(&A, &A, &ctx) == 0);
+            assert(big_cmp(&A, &R) == 0);
+        }
+        // M - 1 squared, the largest product of two residues
+        big_set_nonzero(&B, 1);
+        big_sub(&A, &M, &B);
+        big_mul(&A, &A, &A);
+        big_div(NULL, &R, &A, &M);
+        assert(big_barrett_reduce(&X, &A, &ctx) == 0);
+        assert(big_cmp(&X, &R) == 0);
+        big_barrett_free(&ctx);
+    }
+
+    free(a_hex);
+    free(b_hex);
+    big_free(&A);
+    big_free(&B);
+    big_free(&M);
+    big_free(&X);
+    big_free(&check);
+    big_free(&R);
+
+    printf("Barrett_tests passed!\n");
+    return true;
+}
+
+/*
+Tests big_gcd, big_gcdext and big_invmod on hand picked values, including
+zero operands, signs and a small RSA key, then random operands with a
+common factor against Euclid's algorithm built from big_div, with the
+half-GCD threshold lowered for half of the run so short operands recurse.
+Consecutive Fibonacci numbers make every quotient 1, the longest run of
+steps there is. Finally big_invmod_batch against single inversions, in
+place and with an element that has no inverse.
+*/
+bool gcd_tests() {
+    bigint A, B, G, S, T, X, R, check;
+    big_init(&A);
+    big_init(&B);
+    big_init(&G);
+    big_init(&S);
+    big_init(&T);
+    big_init(&X);
+    big_init(&R);
+    big_init(&check);
+
+    const char *hand[][3] = {
+        {"0", "0", "0"}, {"c", "12", "6"}, {"-c", "12", "6"}, {"0", "-5", "5"},
+        {"-7", "0", "7"}, {"10000000000000000", "30000000000000000", "10000000000000000"},
+        {"ffffffffffffffffffffffffffffffff", "ffffffffffffffff", "ffffffffffffffff"},
+        {"100000000000000000000000000000000", "800000000000000000000000", "800000000000000000000000"},
+    };
+    for (size_t i = 0; i < sizeof(hand) / sizeof(hand[0]); i++) {
+        big_read_string(&A, hand[i][0]);
+        big_read_string(&B, hand[i][1]);
+        big_read_string(&check, hand[i][2]);
+        assert(big_gcd(&G, &A, &B) == 0);
+        assert(big_cmp(&G, &check) == 0);
+        assert(big_gcdext(&G, &S, &T, &A, &B) == 0);
+        assert(big_cmp(&G, &check) == 0);
+        big_mul(&X, &S, &A);
+        big_mul(&R, &T, &B);
+        big_add(&X, &X, &R);
+        assert(big_cmp(&X, &G) == 0);
+    }
+    assert(big_gcdext(&G, &G, NULL, &A, &B) == ERR_BIGINT_BAD_INPUT_DATA);
+
+    // e = 17 and phi = 60 * 52 give d = 2753
+    big_set_nonzero(&A, 17);
+    big_set_nonzero(&B, 3120);
+    assert(big_gcd(&G, &A, &B) == 0 && G.num_limbs == 1 && G.data[0] == 1);
+    assert(big_invmod(&X, &A, &B) == 0 && X.num_limbs == 1 && X.data[0] == 2753);
+    A.signum = -1;
+    assert(big_invmod(&X, &A, &B) == 0 && X.num_limbs == 1 && X.data[0] == 3120 - 2753);
+    big_set_nonzero(&A, 6);
+    big_set_nonzero(&B, 9);
+    assert(big_invmod(&X, &A, &B) == ERR_BIGINT_NOT_ACCEPTABLE);
+    big_set_nonzero(&B, 0);
+    assert(big_invmod(&X, &A, &B) == ERR_BIGINT_BAD_INPUT_DATA);
+    big_set_nonzero(&B, 1);
+    assert(big_invmod(&X, &A, &B) == 0 && big_is_zero(&X));
+
+    size_t max_limbs = 200;
+    char *a_hex = malloc(16 * max_limbs + 2);
+    char *b_hex = malloc(16 * max_limbs + 2);
+    char *g_hex = malloc(16 * 20 + 2);
+    size_t saved_threshold = hgcd_threshold;
+    srand(2468);
+    for (int i = 0; i < 60; i++) {
+        hgcd_threshold = (i < 30) ? 8 : saved_threshold;
+        size_t an = 1 + rand() % max_limbs;
+        size_t bn = (i % 4 == 3) ? 1 + (size_t)rand() % 4 : 1 + rand() % max_limbs;
+        size_t gn = (i % 3 == 0) ? 0 : 1 + rand() % 20;
+        a_hex[0] = (i % 2) ? '-' : '1';
+        b_hex[0] = (i % 5 == 1) ? '-' : '1';
+        g_hex[0] = '1';
+        gen_rand_hex(a_hex + 1, 16 * an - 1);
+        gen_rand_hex(b_hex + 1, 16 * bn - 1);
+        gen_rand_hex(g_hex + 1, (gn > 0) ? 16 * gn - 1 : 0);
+        big_read_string(&A, a_hex);
+        big_read_string(&B, b_hex);
+        big_read_string(&G, g_hex);
+        big_mul(&A, &A, &G);
+        big_mul(&B, &B, &G);
+        if (i % 10 == 7) {
+            big_bit_shift_left(&A, &A, 100);
+            big_bit_shift_left(&B, &B, 37);
+        }
+
+        // Euclid's algorithm
+        bigint *u = &X;
+        bigint *v = &R;
+        big_copy(u, &A);
+        big_copy(v, &B);
+        u->signum = 1;
+        v->signum = 1;
+        while (!big_is_zero(v)) {
+            big_div(NULL, &T, u, v);
+            big_copy(u, v);
+            big_copy(v, &T);
+        }
+        big_copy(&check, u);
+
+        assert(big_gcd(&G, &A, &B) == 0);
+        assert(big_cmp(&G, &check) == 0);
+        assert(big_gcdext(&G, &S, &T, &A, &B) == 0);
+        assert(big_cmp(&G, &check) == 0);
+        big_mul(&X, &S, &A);
+        big_mul(&R, &T, &B);
+        big_add(&X, &X, &R);
+        assert(big_cmp(&X, &G) == 0);
+        big_mul(&X, &S, &G);
+        assert(cmp_abs(&X, &B) <= 0);
+        big_mul(&X, &T, &G);
+        assert(cmp_abs(&X, &A) <= 0);
+
+        // In place, and without T
+        big_copy(&X, &A);
+        assert(big_gcdext(&X, &R, NULL, &X, &B) == 0);
+        assert(big_cmp(&X, &G) == 0 && big_cmp(&R, &S) == 0);
+        big_copy(&X, &B);
+        assert(big_gcd(&X, &A, &X) == 0);
+        assert(big_cmp(&X, &G) == 0);
+
+        // A inverse modulo B when there is one
+        B.signum = 1;
+        int ret = big_invmod(&X, &A, &B);
+        if (G.num_limbs == 1 && G.data[0] == 1) {
+            assert(ret == 0 && X.signum > 0 && big_cmp(&X, &B) < 0);
+            big_mul(&T, &X, &A);
+            big_div(NULL, &R, &T, &B);
+            if (R.signum < 0) {
+                big_add(&R, &R, &B);
+            }
+            assert((R.num_limbs == 1 && R.data[0] == 1) || (B.num_limbs == 1 && B.data[0] == 1));
+        }
+        else {
+            assert(ret == ERR_BIGINT_NOT_ACCEPTABLE);
+        }
+    }
+
+    // Consecutive Fibonacci numbers
+    for (int i = 0; i < 2; i++) {
+        hgcd_threshold = (i == 0) ? 8 : saved_threshold;
+        big_set_nonzero(&A, 0);
+        big_set_nonzero(&B, 1);
+        for (int k = 0; k < 20000; k++) {
+            big_add(&A, &A, &B);
+            big_swap(&A, &B);
+        }
+        assert(big_gcdext(&G, &S, &T, &A, &B) == 0);
+        assert(G.num_limbs == 1 && G.data[0] == 1);
+        big_mul(&X, &S, &A);
+        big_mul(&R, &T, &B);
+        big_add(&X, &X, &R);
+        assert(big_cmp(&X, &G) == 0);
+    }
+    hgcd_threshold = saved_threshold;
+
+    // Batch inversion against one inversion per element
+    size_t count = 20;
+    bigint *elems = malloc(count * sizeof(bigint));
+    bigint *invs = malloc(count * sizeof(bigint));
+    for (size_t i = 0; i < count; i++) {
+        big_init(&elems[i]);
+        big_init(&invs[i]);
+    }
+    for (int round = 0; round < 4; round++) {
+        size_t nn = 1 + rand() % 40;
+        b_hex[0] = '1' + rand() % 9;
+        gen_rand_hex(b_hex + 1, 16 * nn - 1);
+        big_read_string(&B, b_hex);
+        for (size_t i = 0; i < count; i++) {
+            do {
+                size_t en = 1 + rand() % (2 * nn);
+                a_hex[0] = (rand() % 2) ? '-' : '1';
+                gen_rand_hex(a_hex + 1, 16 * en - 1);
+                big_read_string(&elems[i], a_hex);
+                big_gcd(&G, &elems[i], &B);
+            } while (G.num_limbs != 1 || G.data[0] != 1);
+        }
+        assert(big_invmod_batch(invs, elems, count, &B) == 0);
+        for (size_t i = 0; i < count; i++) {
+            assert(big_invmod(&X, &elems[i], &B) == 0);
+            assert(big_cmp(&X, &invs[i]) == 0);
+        }
+        assert(big_invmod_batch(elems, elems, count, &B) == 0);
+        for (size_t i = 0; i < count; i++) {
+            assert(big_cmp(&elems[i], &invs[i]) == 0);
+        }
+        big_mul(&elems[count / 2], &elems[count / 2], &B);
+        assert(big_invmod_batch(invs, elems, count, &B) == ERR_BIGINT_NOT_ACCEPTABLE);
+    }
+    for (size_t i = 0; i < count; i++) {
+        big_free(&elems[i]);
+        big_free(&invs[i]);
+    }
+    free(elems);
+    free(invs);
+
+    free(a_hex);
+    free(b_hex);
+    free(g_hex);
+    big_free(&A);
+    big_free(&B);
+    big_free(&G);
+    big_free(&S);
+    big_free(&T);
+    big_free(&X);
+    big_free(&R);
+    big_free(&check);
+
+    printf("GCD_tests passed!\n");
+    return true;
+}
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+/*
+Checks every inner node of product trees against the product of its
+children and the remainder trees against big_div, then big_batch_gcd
+against the GCD with the product of all other moduli, formed one by one,
+and big_mod_primes against big_div_ui on both sides of its cutoff.
+*/
+bool tree_tests() {
+    bigint A, X, P, check;
+    big_init(&A);
+    big_init(&X);
+    big_init(&P);
+    big_init(&check);
+    big_tree T, R;
+    char *hex = malloc(16 * 400 + 1);
+    size_t max_count = 60;
+    bigint *leaves = malloc(max_count * sizeof(bigint));
+    bigint *G = malloc(max_count * sizeof(bigint));
+    for (size_t i = 0; i < max_count; i++) {
+        big_init(&leaves[i]);
+        big_init(&G[i]);
+    }
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    srand(7788);
+    size_t counts[] = {1, 2, 3, 7, 16, 33, 60};
+    for (size_t c = 0; c < sizeof(counts) / sizeof(counts[0]); c++) {
+        size_t count = counts[c];
+        for (size_t i = 0; i < count; i++) {
+            size_t n = 1 + rand() % 12;
+            gen_rand_hex(hex, 16 * n);
+            hex[0] = '1' + rand() % 9;
+            big_read_string(&leaves[i], hex);
+        }
+        assert(big_product_tree(&T, leaves, count) == 0);
+        assert(T.count == count && T.start[T.levels] - T.start[T.levels - 1] == 1);
+        for (size_t i = 0; i < count; i++) {
+            assert(big_cmp(&T.nodes[i], &leaves[i]) == 0);
+        }
+        for (size_t l = 1; l < T.levels; l++) {
+            size_t width = T.start[l] - T.start[l - 1];
+            for (size_t i = 0; i < width; i += 2) {
+                const bigint *a = &T.nodes[T.start[l - 1] + i];
+                if (i + 1 < width) {
+                    big_mul(&check, a, &T.nodes[T.start[l - 1] + i + 1]);
+                    a = &check;
+                }
+                assert(big_cmp(&T.nodes[T.start[l] + i / 2], a) == 0);
+            }
+        }
 
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+        gen_rand_hex(hex, 16 * (1 + rand() % 400));
+        big_read_string(&A, hex);
+        assert(big_remainder_tree(&R, &T, &A) == 0);
+        for (size_t k = 0; k < T.start[T.levels]; k++) {
+            big_div(NULL, &check, &A, &T.nodes[k]);
+            assert(big_cmp(&R.nodes[k], &check) == 0);
+        }
+        big_tree_free(&R);
+        big_tree_free(&T);
+    }
+    big_set_nonzero(&A, 1);
+    A.signum = -1;
+    assert(big_product_tree(&T, leaves, 0) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_product_tree(&T, &A, 1) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_product_tree(&T, leaves, 3) == 0);
+    assert(big_remainder_tree(&R, &T, &A) == ERR_BIGINT_BAD_INPUT_DATA);
+    big_tree_free(&T);
+
+    // Moduli of two factors each, drawn from a pool small enough to repeat
+    for (int round = 0; round < 3; round++) {
+        size_t count = (round == 0) ? 1 : 20 * round;
+        bigint pool[12];
+        for (int k = 0; k < 12; k++) {
+            big_init(&pool[k]);
+            gen_rand_hex(hex, 16 * (1 + rand() % 3));
+            hex[0] = '1' + rand() % 9;
+            big_read_string(&pool[k], hex);
+        }
+        for (size_t i = 0; i < count; i++) {
+            big_mul(&leaves[i], &pool[rand() % 12], &pool[rand() % 12]);
+        }
+        assert(big_batch_gcd(G, leaves, count) == 0);
+        for (size_t i = 0; i < count; i++) {
+            big_set_nonzero(&P, 1);
+            for (size_t j = 0; j < count; j++) {
+                if (j != i) {
+                    big_mul(&P, &P, &leaves[j]);
+                }
+            }
+            big_gcd(&check, &leaves[i], &P);
+            assert(big_cmp(&G[i], &check) == 0);
+        }
+        assert(big_batch_gcd(leaves, leaves, count) == 0);
+        for (size_t i = 0; i < count; i++) {
+            assert(big_cmp(&leaves[i], &G[i]) == 0);
+        }
+        for (int k = 0; k < 12; k++) {
+            big_free(&pool[k]);
+        }
+    }
 
-    big_free(&first);
-    big_free(&second);
-    big_free(&toom_result);
-    big_free(&karatsuba_result);
-    big_free(&actual);
+    // The sieve primes of big_gen_prime and small_primes, short and long X
+    int primes[320];
+    size_t count = 0;
+    for (int p = 3; p < 2048; p += 2) {
+        bool prime = true;
+        for (int d = 3; d * d <= p && prime; d += 2) {
+            prime = (p % d != 0);
+        }
+        if (prime) {
+            primes[count++] = p;
+        }
+    }
+    big_uint res[320];
+    size_t sizes[] = {1, 20, trial_tree_threshold, 300};
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        gen_rand_hex(hex, 16 * sizes[k]);
+        hex[0] = '1' + rand() % 9;
+        big_read_string(&X, hex);
+        X.signum = (k % 2) ? -1 : 1;
+        assert(big_mod_primes(res, &X, primes, count) == 0);
+        for (size_t i = 0; i < count; i++) {
+            big_uint r;
+            big_div_ui(NULL, &r, &X, (big_uint)primes[i]);
+            assert(res[i] == r);
+        }
+        size_t small_count = sizeof(small_primes) / sizeof(small_primes[0]);
+        assert(big_mod_primes(res, &X, small_primes, small_count) == 0);
+        for (size_t i = 0; i < small_count; i++) {
+            big_uint r;
+            big_div_ui(NULL, &r, &X, (big_uint)small_primes[i]);
+            assert(res[i] == r);
+        }
+    }
+    primes[5] = 1;
+    assert(big_mod_primes(res, &X, primes, count) == ERR_BIGINT_BAD_INPUT_DATA);
 
-    big_init(&first);
-    big_init(&second);
-    big_init(&toom_result);
-    big_init(&karatsuba_result);
-    big_init(&actual);
+    for (size_t i = 0; i < max_count; i++) {
+        big_free(&leaves[i]);
+        big_free(&G[i]);
+    }
+    free(leaves);
+    free(G);
+    free(hex);
+    big_free(&A);
+    big_free(&X);
+    big_free(&P);
+    big_free(&check);
+
+    printf("Tree_tests passed!\n");
+    return true;
+}
 
-    // Ensure this works with all 0s
-    first.num_limbs = 5;
-    first.data = malloc(first.num_limbs*sizeof(big_uint));
-    first.signum = 1;
-    first.data[0] = 0;
-    first.data[1] = 0;
-    first.data[2] = 0;
-    first.data[3] = 0;
-    first.data[4] = 0;
+/*
+Checks X^k <= A < (X + 1)^k and R = A - X^k for random A of up to 300 limbs
+and a spread of k, along with perfect powers and their neighbours, where an
+off by one root shows up first. Then negative A, aliasing and bad input.
+*/
+bool root_tests() {
+    bigint A, X, R, P, Q, one;
+    big_init(&A);
+    big_init(&X);
+    big_init(&R);
+    big_init(&P);
+    big_init(&Q);
+    big_init(&one);
+    big_set_nonzero(&one, 1);
+    char *hex = malloc(16 * 300 + 1);
+
+    srand(9911);
+    big_uint ks[] = {2, 3, 5, 7, 64, 200};
+    for (size_t c = 0; c < sizeof(ks) / sizeof(ks[0]); c++) {
+        big_uint k = ks[c];
+        for (int round = 0; round < 40; round++) {
+            size_t n = 1 + rand() % ((round < 30) ? 20 : 300);
+            gen_rand_hex(hex, 16 * n);
+            hex[0] = '1' + rand() % 9;
+            big_read_string(&A, hex);
+            assert(big_rootrem(&X, &R, &A, k) == 0);
+            big_pow_ui(&P, &X, k);
+            big_sub(&Q, &A, &P);
+            assert(P.signum > 0 && big_cmp(&P, &A) <= 0 && big_cmp(&Q, &R) == 0);
+            big_add(&Q, &X, &one);
+            big_pow_ui(&P, &Q, k);
+            assert(big_cmp(&P, &A) > 0);
+            assert(big_root(&Q, &A, k) == 0 && big_cmp(&Q, &X) == 0);
+
+            // X^k - 1, X^k and X^k + 1
+            big_pow_ui(&A, &X, k);
+            assert(big_rootrem(&Q, &R, &A, k) == 0);
+            assert(big_cmp(&Q, &X) == 0 && big_is_zero(&R));
+            big_add(&A, &A, &one);
+            assert(big_rootrem(&Q, &R, &A, k) == 0);
+            assert(big_cmp(&Q, &X) == 0 && big_cmp(&R, &one) == 0);
+            big_sub(&A, &A, &one);
+            big_sub(&A, &A, &one);
+            assert(big_root(&Q, &A, k) == 0);
+            big_add(&Q, &Q, &one);
+            assert(big_cmp(&Q, &X) == 0);
+        }
+    }
 
-    second.num_limbs = 5;
-    second.data = malloc(second.num_limbs*sizeof(big_uint));
-    second.signum = 1;
-    second.data[0] = 1;
-    second.data[1] = 1;
-    second.data[2] = 1;
-    second.data[3] = 1;
-    second.data[4] = 1;
+    // Every single limb value up to 2^16, where the roots are found bit by bit
+    for (big_uint a = 1; a < 65536; a++) {
+        big_set_nonzero(&A, a);
+        assert(big_sqrtrem(&X, &R, &A) == 0);
+        big_uint s = X.data[0];
+        assert(s * s <= a && (s + 1) * (s + 1) > a && R.data[0] == a - s * s);
+        assert(big_root(&X, &A, 3) == 0);
+        s = X.data[0];
+        assert(s * s * s <= a && (s + 1) * (s + 1) * (s + 1) > a);
+    }
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+    // Odd roots of negative values round towards zero, R keeps the sign of A
+    gen_rand_hex(hex, 16 * 50);
+    big_read_string(&A, hex);
+    A.signum = -1;
+    assert(big_rootrem(&X, &R, &A, 3) == 0);
+    assert(X.signum < 0 && R.signum <= 0);
+    big_pow_ui(&P, &X, 3);
+    big_add(&P, &P, &R);
+    assert(big_cmp(&P, &A) == 0);
+    assert(big_sqrt(&X, &A) == ERR_BIGINT_NEGATIVE_VALUE);
+    assert(big_root(&X, &A, 4) == ERR_BIGINT_NEGATIVE_VALUE);
+
+    // 2^64 - 1, where every power past it overflows a limb
+    big_uint limb_roots[][2] = {{3, 2642245}, {5, 7131}, {7, 565}};
+    for (int i = 0; i < 3; i++) {
+        for (int sign = 1; sign >= -1; sign -= 2) {
+            big_set_nonzero(&A, UINT64_MAX);
+            A.signum = sign;
+            assert(big_rootrem(&X, &R, &A, limb_roots[i][0]) == 0);
+            assert(X.num_limbs == 1 && X.data[0] == limb_roots[i][1] && X.signum == sign);
+            big_pow_ui(&P, &X, limb_roots[i][0]);
+            big_add(&P, &P, &R);
+            assert(big_cmp(&P, &A) == 0);
+        }
+    }
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    // Zero, k = 1, k beyond the bit length and aliasing
+    big_set_nonzero(&A, 0);
+    assert(big_sqrtrem(&X, &R, &A) == 0 && big_is_zero(&X) && big_is_zero(&R));
+    gen_rand_hex(hex, 16 * 10);
+    big_read_string(&A, hex);
+    assert(big_rootrem(&X, &R, &A, 1) == 0 && big_cmp(&X, &A) == 0 && big_is_zero(&R));
+    assert(big_root(&X, &A, 1000) == 0 && big_cmp(&X, &one) == 0);
+    assert(big_root(&X, &A, UINT64_MAX) == 0 && big_cmp(&X, &one) == 0);
+    big_copy(&P, &A);
+    big_sqrtrem(&X, &R, &A);
+    assert(big_sqrtrem(&P, NULL, &P) == 0 && big_cmp(&P, &X) == 0);
+    big_copy(&P, &A);
+    assert(big_sqrtrem(&Q, &P, &P) == 0 && big_cmp(&Q, &X) == 0 && big_cmp(&P, &R) == 0);
+    assert(big_sqrtrem(&X, &X, &A) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_root(&X, &A, 0) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_sqrt(NULL, &A) == ERR_BIGINT_BAD_INPUT_DATA);
+
+    free(hex);
+    big_free(&A);
+    big_free(&X);
+    big_free(&R);
+    big_free(&P);
+    big_free(&Q);
+    big_free(&one);
+
+    printf("Root_tests passed!\n");
+    return true;
+}
 
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+/*
+Checks factorials against the running product n * (n - 1)!, binomial
+coefficients against Pascal's rule and against factorials, and the
+hexadecimal digits of pi against the first 200 and against a longer run of
+itself.
+*/
+bool fac_tests() {
+    bigint X, Y, Z;
+    big_init(&X);
+    big_init(&Y);
+    big_init(&Z);
+
+    big_set_nonzero(&Y, 1);
+    for (big_uint n = 0; n <= 2000; n++) {
+        if (n > 0) {
+            big_comb_ui(&Z, n, &Y, 0, &Y, false);
+            big_swap(&Y, &Z);
+        }
+        assert(big_fac_ui(&X, n) == 0 && big_cmp(&X, &Y) == 0);
+    }
+    big_fac_ui(&X, 20);
+    assert(X.num_limbs == 1 && X.data[0] == 2432902008176640000);
+
+    // Row n of Pascal's triangle from row n - 1, kept in a ring of rows
+    bigint row[2][81];
+    for (int i = 0; i < 2; i++) {
+        for (int k = 0; k <= 80; k++) {
+            big_init(&row[i][k]);
+        }
+    }
+    big_set_nonzero(&row[0][0], 1);
+    for (big_uint n = 1; n <= 80; n++) {
+        bigint *prev = row[(n - 1) % 2];
+        bigint *cur = row[n % 2];
+        big_set_nonzero(&cur[0], 1);
+        big_set_nonzero(&cur[n], 1);
+        for (big_uint k = 1; k < n; k++) {
+            big_add(&cur[k], &prev[k - 1], &prev[k]);
+        }
+        for (big_uint k = 0; k <= n + 1; k++) {
+            assert(big_bin_uiui(&X, n, k) == 0);
+            if (k <= n) {
+                assert(big_cmp(&X, &cur[k]) == 0);
+            }
+            else {
+                assert(big_is_zero(&X));
+            }
+        }
+    }
+    for (int i = 0; i < 2; i++) {
+        for (int k = 0; k <= 80; k++) {
+            big_free(&row[i][k]);
+        }
+    }
+    big_uint ks[] = {1, 7, 333, 1000, 2500, 4999};
+    for (size_t c = 0; c < sizeof(ks) / sizeof(ks[0]); c++) {
+        assert(big_bin_uiui(&X, 5000, ks[c]) == 0);
+        big_fac_ui(&Y, ks[c]);
+        big_mul(&X, &X, &Y);
+        big_fac_ui(&Y, 5000 - ks[c]);
+        big_mul(&X, &X, &Y);
+        big_fac_ui(&Y, 5000);
+        assert(big_cmp(&X, &Y) == 0);
+    }
+    assert(big_bin_uiui(&X, UINT64_MAX, 1) == 0);
+    assert(X.num_limbs == 1 && X.data[0] == UINT64_MAX);
+
+    const char *pi = "3243f6a8885a308d313198a2e03707344a4093822299f31d0082efa98ec4e6c8"
+                     "9452821e638d01377be5466cf34e90c6cc0ac29b7c97c50dd3f84d5b5b547091"
+                     "79216d5d98979fb1bd1310ba698dfb5ac2ffd72dbd01adfb7b8e1afed6a267e9"
+                     "6ba7c9045";
+    char buf[300];
+    size_t olen;
+    for (size_t digits = 0; digits <= 200; digits++) {
+        assert(big_pi_hex(&X, digits) == 0);
+        assert(big_write_string_radix(&X, 16, buf, sizeof(buf), &olen) == 0);
+        assert(olen == digits + 2 && strncmp(buf, pi, digits + 1) == 0);
+    }
+    assert(big_pi_hex(&Y, 20000) == 0);
+    big_bit_shift_right(&Y, &Y, 4 * (20000 - 5000));
+    big_pi_hex(&X, 5000);
+    assert(big_cmp(&X, &Y) == 0);
+    assert(big_fac_ui(NULL, 5) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_bin_uiui(NULL, 5, 2) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_pi_hex(NULL, 5) == ERR_BIGINT_BAD_INPUT_DATA);
+
+    big_free(&X);
+    big_free(&Y);
+    big_free(&Z);
+
+    printf("Fac_tests passed!\n");
+    return true;
+}
 
-    big_free(&first);
-    big_free(&second);
-    big_free(&toom_result);
-    big_free(&karatsuba_result);
-    big_free(&actual);
+/*
+Tests big_read_string_radix and big_write_string_radix on hand picked values
+and invalid input, and the hexadecimal big_read_string against them at
+every length up to three limbs. Then round trips random values of up to
+3000 limbs through every radix. Long decimal strings are also converted once
+more with the quadratic basecase only, which both divide and conquer
+directions must agree with.
+*/
+bool radix_tests() {
+    bigint A, B;
+    big_init(&A);
+    big_init(&B);
+    char buf[100];
+    size_t temp;
 
-    big_init(&first);
-    big_init(&second);
-    big_init(&toom_result);
-    big_init(&karatsuba_result);
-    big_init(&actual);
-    // Ensure it works to handle UINTMAX Borrows, along with multiple limbs of
-    // just 0s 8x8 limb multiplication
-    // 1 number is negative
-    first.num_limbs = 8;
-    first.data = malloc(first.num_limbs*sizeof(big_uint));
-    first.signum = 1;
-    first.data[0] = UINT64_MAX;
-    first.data[1] = 0;
-    first.data[2] = 0;
-    first.data[3] = UINT64_MAX;
-    first.data[4] = UINT64_MAX;
-    first.data[5] = UINT64_MAX;
-    first.data[6] = UINT64_MAX;
-    first.data[7] = UINT64_MAX;
+    // 2^64 in decimal, and the size query with no buffer
+    big_read_string(&A, "10000000000000000");
+    assert(big_write_string_radix(&A, 10, NULL, 0, &temp) == ERR_BIGINT_BUFFER_TOO_SMALL);
+    assert(temp == 21);
+    assert(big_write_string_radix(&A, 10, buf, temp, &temp) == 0);
+    assert(strcmp(buf, "18446744073709551616") == 0);
+    assert(big_write_string_radix(&A, 10, buf, 20, &temp) == ERR_BIGINT_BUFFER_TOO_SMALL);
+
+    // Negative numbers, upper case letters and leading zeros
+    assert(big_read_string_radix(&A, "-00ZZ", 36) == 0);
+    big_write_string(&A, buf, sizeof(buf), &temp);
+    assert(strcmp(buf, "-50f") == 0);
+    big_write_string_radix(&A, 2, buf, sizeof(buf), &temp);
+    assert(strcmp(buf, "-10100001111") == 0);
+    big_write_string_radix(&A, 36, buf, sizeof(buf), &temp);
+    assert(strcmp(buf, "-zz") == 0);
+    assert(big_read_string_radix(&A, "-0", 10) == 0);
+    big_write_string_radix(&A, 7, buf, sizeof(buf), &temp);
+    assert(strcmp(buf, "0") == 0);
+
+    // big_read_string at every length around the limb boundaries, against
+    // the bit by bit parse of big_read_string_radix
+    char digits[] = "-f0E1d2C3b4A5968778695A4b3C2d1E0f0123456789aBcDeF";
+    for (size_t len = 1; len + 1 < sizeof(digits); len++) {
+        char saved = digits[len + 1];
+        digits[len + 1] = '\0';
+        assert(big_read_string(&A, digits) == 0);
+        assert(big_read_string_radix(&B, digits, 16) == 0);
+        assert(big_cmp(&A, &B) == 0);
+        big_write_string(&A, buf, sizeof(buf), &temp);
+        big_write_string_radix(&B, 16, buf + 50, sizeof(buf) - 50, &temp);
+        assert(strcmp(buf, buf + 50) == 0);
+        digits[len + 1] = saved;
+    }
+    assert(big_read_string(&A, "123456789abcdefg") == ERR_BIGINT_INVALID_CHARACTER);
+    assert(big_read_string(&A, "1x23456789abcdef0") == ERR_BIGINT_INVALID_CHARACTER);
+    assert(big_read_string(&A, "") == ERR_BIGINT_INVALID_CHARACTER);
+    assert(big_read_string(&A, "-") == ERR_BIGINT_INVALID_CHARACTER);
+
+    // A failed parse leaves the destination as it was, whichever limb the
+    // bad digit lands in
+    const char *bad[] = {"x", "123456789abcdefx", "x0123456789abcdef0123456789abcdef",
+                         "0123456789abcdef0123456789abcdefx"};
+    assert(big_read_string(&A, "-fedcba9876543210fedcba98765432100") == 0);
+    for (size_t i = 0; i < sizeof(bad) / sizeof(bad[0]); i++) {
+        assert(big_read_string(&A, bad[i]) == ERR_BIGINT_INVALID_CHARACTER);
+        assert(big_read_string_radix(&A, bad[i], 16) == ERR_BIGINT_INVALID_CHARACTER);
+        big_write_string(&A, buf, sizeof(buf), &temp);
+        assert(strcmp(buf, "-fedcba9876543210fedcba98765432100") == 0);
+    }
+    assert(big_read_string(&A, "-00000000000000000000") == 0);
+    big_write_string(&A, buf, sizeof(buf), &temp);
+    assert(strcmp(buf, "0") == 0 && temp == 2);
+
+    // Digits beyond the radix, empty strings and bad radices are rejected
+    assert(big_read_string_radix(&A, "1238", 8) == ERR_BIGINT_INVALID_CHARACTER);
+    assert(big_read_string_radix(&A, "12 3", 10) == ERR_BIGINT_INVALID_CHARACTER);
+    assert(big_read_string_radix(&A, "-", 10) == ERR_BIGINT_INVALID_CHARACTER);
+    assert(big_read_string_radix(&A, "1", 37) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_write_string_radix(&A, 1, buf, sizeof(buf), &temp) == ERR_BIGINT_BAD_INPUT_DATA);
+
+    size_t max_len = 16 * 3000;
+    char *hex = malloc(max_len + 2);
+    char *text = malloc(64 * 3000 + 3);
+    char *again = malloc(64 * 3000 + 3);
+    char *h_buf = malloc(max_len + 2);
+    srand(97531);
+    for (int i = 0; i < 70; i++) {
+        size_t len = (i % 35 == 34) ? max_len : 1 + (size_t)rand() % ((i < 35) ? 200 : 20000);
+        hex[0] = (i % 3) ? 'f' : '-';
+        gen_rand_hex(hex + 1, len);
+        big_read_string(&A, hex);
+        big_write_string(&A, hex, max_len + 2, &temp);
+        int radix = 2 + i % 35;
+        assert(big_write_string_radix(&A, radix, text, 64 * 3000 + 3, &temp) == 0);
+        assert(temp == strlen(text) + 1);
+        assert(big_read_string_radix(&B, text, radix) == 0);
+        big_write_string(&B, h_buf, max_len + 2, &temp);
+        assert(strcmp(hex, h_buf) == 0);
+    }
 
-    second.num_limbs = 8;
-    second.data = malloc(second.num_limbs*sizeof(big_uint));
-    second.signum = -1;
-    second.data[0] = UINT64_MAX;
-    second.data[1] = UINT64_MAX;
-    second.data[2] = UINT64_MAX;
-    second.data[3] = 0;
-    second.data[4] = 0;
-    second.data[5] = 0;
-    second.data[6] = UINT64_MAX;
-    second.data[7] = UINT64_MAX;
+    // Decimal with the quadratic basecase only, in both directions
+    size_t saved_read = radix_read_threshold;
+    size_t saved_write = radix_write_threshold;
+    for (int i = 0; i < 3; i++) {
+        gen_rand_hex(hex, 16 * (1000 + 1000 * i));
+        big_read_string(&A, hex);
+        big_write_string_radix(&A, 10, text, 64 * 3000 + 3, &temp);
+        radix_write_threshold = (size_t)-1;
+        big_write_string_radix(&A, 10, again, 64 * 3000 + 3, &temp);
+        radix_write_threshold = saved_write;
+        assert(strcmp(text, again) == 0);
+        radix_read_threshold = (size_t)-1;
+        big_read_string_radix(&B, text, 10);
+        radix_read_threshold = saved_read;
+        assert(big_cmp(&A, &B) == 0);
+    }
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+    free(hex);
+    free(text);
+    free(again);
+    free(h_buf);
+    big_free(&A);
+    big_free(&B);
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    printf("Radix_tests passed!\n");
+    return true;
+}
 
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+/*
+Tests the big and little endian binary import and export on byte strings
+that end in the middle of a limb, too small and oversized buffers, then
+big_write_file and big_map_file on a random number and on a file whose
+length is not a whole number of limbs.
+*/
+bool binary_tests() {
+    bigint A, B;
+    big_init(&A);
+    big_init(&B);
+    char buf[100];
+    size_t temp;
+    uint8_t bytes[11] = {0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b};
+    uint8_t out[16];
+
+    assert(big_read_binary(&A, bytes, 11) == 0);
+    big_write_string(&A, buf, sizeof(buf), &temp);
+    assert(strcmp(buf, "102030405060708090a0b") == 0);
+    assert(big_write_binary(&A, out, 10) == ERR_BIGINT_BUFFER_TOO_SMALL);
+    assert(big_write_binary(&A, out, 11) == 0);
+    assert(memcmp(out, bytes, 11) == 0);
+    memset(out, 0xff, sizeof(out));
+    assert(big_write_binary(&A, out, 16) == 0);
+    assert(memcmp(out, "\0\0\0\0\0", 5) == 0 && memcmp(out + 5, bytes, 11) == 0);
+
+    assert(big_read_binary_le(&A, bytes, 11) == 0);
+    big_write_string(&A, buf, sizeof(buf), &temp);
+    assert(strcmp(buf, "b0a090807060504030201") == 0);
+    assert(big_write_binary_le(&A, out, 10) == ERR_BIGINT_BUFFER_TOO_SMALL);
+    memset(out, 0xff, sizeof(out));
+    assert(big_write_binary_le(&A, out, 16) == 0);
+    assert(memcmp(out, bytes, 11) == 0 && memcmp(out + 11, "\0\0\0\0\0", 5) == 0);
+
+    // Zero takes no bytes at all, leading zero bytes are dropped
+    assert(big_read_binary(&A, NULL, 0) == 0);
+    assert(big_is_zero(&A) && big_write_binary(&A, NULL, 0) == 0);
+    assert(big_read_binary(&A, (const uint8_t *)"\0\0\0\0\0\0\0\0\0\x2a", 10) == 0);
+    assert(A.num_limbs == 1 && A.data[0] == 42 && big_write_binary(&A, out, 1) == 0 && out[0] == 42);
+
+    // A random number through a file, mapped back in place. The file is a
+    // fresh one in the temporary directory, removed again at the end
+    char path[256];
+    snprintf(path, sizeof(path), "%s/bigint_binary_XXXXXX", P_tmpdir);
+    int fd = mkstemp(path);
+    assert(fd >= 0);
+    close(fd);
+    size_t len = 16 * 5000;
+    char *hex = malloc(len + 1);
+    gen_rand_hex(hex, len);
+    big_read_string(&A, hex);
+    A.signum = -1;
+    assert(big_write_file(&A, path) == 0);
+    big_mapped_file map;
+    assert(big_map_file(&map, path) == 0);
+    A.signum = 1;
+    assert(big_cmp(&A, &map.value) == 0);
+    big_mul_auto(&B, &map.value, &map.value);
+    big_unmap_file(&map);
+    big_sqr(&A, &A);
+    assert(big_cmp(&A, &B) == 0);
+
+    // 11 bytes, so the mapping runs past the end of the file
+    FILE *f = fopen(path, "wb");
+    fwrite(bytes, 1, 11, f);
+    fclose(f);
+    assert(big_map_file(&map, path) == 0);
+    big_write_string(&map.value, buf, sizeof(buf), &temp);
+    assert(strcmp(buf, "b0a090807060504030201") == 0);
+    big_unmap_file(&map);
+    f = fopen(path, "wb");
+    fclose(f);
+    assert(big_map_file(&map, path) == 0);
+    assert(big_is_zero(&map.value));
+    big_unmap_file(&map);
+    remove(path);
+    assert(big_map_file(&map, path) == ERR_BIGINT_FILE_IO_ERROR);
+
+    free(hex);
+    big_free(&A);
+    big_free(&B);
+
+    printf("Binary_tests passed!\n");
+    return true;
+}
 
-    // Stress test of the same number multiplied together
-    // Number is negative
-    big_read_string(&first, "-1234567890ABCDEF1234DEF1234567890ABCD7890ABCDEF1234567890ABCDEFEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF12345678EF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890AB90ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF");
-    big_read_string(&second, "-1234567890ABCDEF1234DEF1234567890ABCD7890ABCDEF1234567890ABCDEFEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF12345678EF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890AB90ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF1234567890ABCDEF");
+bool modexp_tests() {
+    bigint A, E, N, X, check, Q;
+    big_init(&A);
+    big_init(&E);
+    big_init(&N);
+    big_init(&X);
+    big_init(&check);
+    big_init(&Q);
 
-    big_mul(&actual, &first, &second);
-    big_karatsuba(&karatsuba_result, &first, &second);
-    big_toom_cook(&toom_result, &first, &second);
+    char x_buf[100];
+    size_t temp;
 
-    big_write_string(&actual, a_buf, sizeof(a_buf), &temp);
-    big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-    big_write_string(&toom_result, t_buf, sizeof(t_buf), &temp);
+    // Even moduli have no Montgomery form and must be rejected
+    big_set_nonzero(&A, 3);
+    big_set_nonzero(&E, 5);
+    big_set_nonzero(&N, 10);
+    assert(big_exp_mod(&X, &A, &E, &N) == ERR_BIGINT_BAD_INPUT_DATA);
+
+    // 4^13 mod 497 = 445
+    big_set_nonzero(&A, 4);
+    big_set_nonzero(&E, 13);
+    big_set_nonzero(&N, 497);
+    assert(big_exp_mod(&X, &A, &E, &N) == 0);
+    big_write_string(&X, x_buf, sizeof(x_buf), &temp);
+    assert(strcmp(x_buf, "1bd") == 0);
+
+    // (-2)^3 mod 7 = 6, negative bases are reduced into [0, N) first
+    big_set_nonzero(&A, 2);
+    A.signum = -1;
+    big_set_nonzero(&E, 3);
+    big_set_nonzero(&N, 7);
+    assert(big_exp_mod(&X, &A, &E, &N) == 0);
+    big_write_string(&X, x_buf, sizeof(x_buf), &temp);
+    assert(strcmp(x_buf, "6") == 0);
+
+    // Random tests against plain square and multiply, the last moduli are
+    // long enough to take the multiply then reduce path
+    size_t max_len = 1300;
+    char *a_hex = malloc(max_len + 2);
+    char *n_hex = malloc(max_len + 2);
+    char *e_hex = malloc(40);
+    char *x_str = malloc(max_len + 2);
+    char *c_str = malloc(max_len + 2);
+    srand(4242);
+    for (int i = 0; i < 24; i++) {
+        size_t n_len = (i < 20) ? 1 + rand() % 400 : 1100 + rand() % 200;
+        size_t a_len = 1 + rand() % (n_len + 16);
+        a_hex[0] = (i % 3) ? '1' : '-';
+        n_hex[0] = '1';
+        e_hex[0] = '1';
+        gen_rand_hex(a_hex + 1, a_len);
+        gen_rand_hex(n_hex + 1, n_len);
+        gen_rand_hex(e_hex + 1, 1 + rand() % 30);
+        big_read_string(&A, a_hex);
+        big_read_string(&N, n_hex);
+        big_read_string(&E, e_hex);
+        N.data[0] |= 1;
+
+        assert(big_exp_mod(&X, &A, &E, &N) == 0);
+
+        big_div(NULL, &check, &A, &N);
+        if (check.signum < 0 && !big_is_zero(&check)) {
+            big_add(&check, &check, &N);
+        }
+        big_copy(&Q, &check);
+        big_set_nonzero(&check, 1);
+        for (size_t bit = big_bitlen(&E); bit > 0; bit--) {
+            big_mul_auto(&check, &check, &check);
+            big_div(NULL, &check, &check, &N);
+            if ((E.data[(bit - 1) / 64] >> ((bit - 1) % 64)) & 1) {
+                big_mul_auto(&check, &check, &Q);
+                big_div(NULL, &check, &check, &N);
+            }
+        }
 
-    assert(strcmp(a_buf, k_buf) == 0);
-    assert(strcmp(a_buf, t_buf) == 0);
+        big_write_string(&X, x_str, max_len + 2, &temp);
+        big_write_string(&check, c_str, max_len + 2, &temp);
+        assert(strcmp(x_str, c_str) == 0);
+    }
+    free(a_hex);
+    free(n_hex);
+    free(e_hex);
+    free(x_str);
+    free(c_str);
+
+    big_free(&A);
+    big_free(&E);
+    big_free(&N);
+    big_free(&X);
+    big_free(&check);
+    big_free(&Q);
+
+    printf("Modexp_tests passed!\n");
+    return true;
+}
 
-    big_free(&first);
-    big_free(&second);
-    big_free(&toom_result);
-    big_free(&karatsuba_result);
-    big_free(&actual);
+/*
+Tests the constant-time functions against their variable-time
+counterparts on random fixed-width operands, with leading zero limbs and
+equal operands among them, and big_ct_exp_mod against big_exp_mod for
+exponents passed wider than they are, zero included, and the moduli 1 and
+all ones.
+*/
+bool ct_tests() {
+    bigint A, E, N, X, check;
+    big_init(&A);
+    big_init(&E);
+    big_init(&N);
+    big_init(&X);
+    big_init(&check);
+    big_mont_ctx ctx;
+
+    size_t max_limbs = 40;
+    big_uint *ap = malloc(max_limbs * sizeof(big_uint));
+    big_uint *bp = malloc(max_limbs * sizeof(big_uint));
+    big_uint *rp = malloc(2 * max_limbs * sizeof(big_uint));
+    big_uint *sp = malloc(2 * max_limbs * sizeof(big_uint));
+    big_uint *tp = malloc(big_ct_exp_mod_scratch_size(max_limbs) * sizeof(big_uint));
+    big_uint *mtp = malloc(big_mul_scratch_size(max_limbs, max_limbs) * sizeof(big_uint));
+    char *hex = malloc(16 * max_limbs + 1);
+    srand(1122);
+    for (int i = 0; i < 200; i++) {
+        size_t n = 1 + rand() % max_limbs;
+        for (size_t j = 0; j < n; j++) {
+            ap[j] = ((big_uint)rand() << 40) ^ ((big_uint)rand() << 20) ^ (big_uint)rand();
+            bp[j] = (i % 3 == 0) ? ap[j] : ((big_uint)rand() << 40) ^ ((big_uint)rand() << 20) ^ (big_uint)rand();
+        }
+        if (i % 4 == 1) {
+            ap[n - 1] = 0;
+        }
+        if (i % 3 == 0 && n > 1) {
+            bp[rand() % n] ^= (big_uint)1 << (rand() % 64);
+        }
 
-    printf("Multiple_same_limb_tests passed!\n");
+        int cmp = big_ct_cmp(ap, bp, n);
+        assert(cmp == limb_cmp(ap, bp, n));
+        assert(big_ct_cmp(ap, ap, n) == 0);
+
+        big_uint cy = limb_add_n(sp, ap, bp, n);
+        assert(big_ct_add(rp, ap, bp, n) == cy && memcmp(rp, sp, n * sizeof(big_uint)) == 0);
+        big_uint borrow = limb_sub_n(sp, ap, bp, n);
+        assert(big_ct_sub(rp, ap, bp, n) == borrow && memcmp(rp, sp, n * sizeof(big_uint)) == 0);
+        assert(borrow == (cmp < 0));
+
+        limb_mul(sp, ap, n, bp, n, mtp);
+        big_ct_mul(rp, ap, bp, n);
+        assert(memcmp(rp, sp, 2 * n * sizeof(big_uint)) == 0);
+
+        big_ct_select(rp, ap, bp, n, 1);
+        assert(memcmp(rp, ap, n * sizeof(big_uint)) == 0);
+        big_ct_select(rp, ap, bp, n, 0);
+        assert(memcmp(rp, bp, n * sizeof(big_uint)) == 0);
+        memcpy(rp, ap, n * sizeof(big_uint));
+        memcpy(sp, bp, n * sizeof(big_uint));
+        big_ct_cswap(rp, sp, n, 0);
+        assert(memcmp(rp, ap, n * sizeof(big_uint)) == 0 && memcmp(sp, bp, n * sizeof(big_uint)) == 0);
+        big_ct_cswap(rp, sp, n, 1);
+        assert(memcmp(rp, bp, n * sizeof(big_uint)) == 0 && memcmp(sp, ap, n * sizeof(big_uint)) == 0);
+    }
+
+    // Modular exponentiation, the first two moduli are 1 and 2^(64 * 3) - 1
+    for (int i = 0; i < 40; i++) {
+        size_t n = (i == 0) ? 1 : (i == 1) ? 3 : 1 + rand() % 16;
+        if (i == 0) {
+            big_set_nonzero(&N, 1);
+        }
+        else if (i == 1) {
+            memset(hex, 'f', 16 * n);
+            hex[16 * n] = '\0';
+            big_read_string(&N, hex);
+        }
+        else {
+            hex[0] = '1' + rand() % 9;
+            gen_rand_hex(hex + 1, 16 * n - 1);
+            big_read_string(&N, hex);
+            N.data[0] |= 1;
+        }
+        assert(big_mont_init(&ctx, &N) == 0);
+        gen_rand_hex(hex, 16 * n);
+        big_read_string(&X, hex);
+        big_div(NULL, &A, &X, &N);
+        size_t en = 1 + rand() % 4;
+        gen_rand_hex(hex, (i % 5 == 2) ? 1 : 16 * en - 16 * (rand() % en));
+        if (i % 5 == 2) {
+            hex[0] = '0';
+        }
+        big_read_string(&E, hex);
+        assert(big_exp_mod(&check, &A, &E, &N) == 0);
+
+        memset(ap, 0, n * sizeof(big_uint));
+        memcpy(ap, A.data, limb_trimmed_len(A.data, A.num_limbs) * sizeof(big_uint));
+        memset(bp, 0, en * sizeof(big_uint));
+        memcpy(bp, E.data, limb_trimmed_len(E.data, E.num_limbs) * sizeof(big_uint));
+        assert(big_ct_exp_mod(rp, ap, bp, en, &ctx, tp) == 0);
+        assert(big_ct_exp_mod(ap, ap, bp, en, &ctx, tp) == 0);
+        assert(memcmp(ap, rp, n * sizeof(big_uint)) == 0);
+        big_reserve(&X, n);
+        memcpy(X.data, rp, n * sizeof(big_uint));
+        big_normalize(&X, n, 1);
+        assert(big_cmp(&X, &check) == 0);
+        big_mont_free(&ctx);
+    }
+    assert(big_ct_exp_mod(rp, ap, bp, 1, NULL, tp) == ERR_BIGINT_BAD_INPUT_DATA);
+
+    free(ap);
+    free(bp);
+    free(rp);
+    free(sp);
+    free(tp);
+    free(mtp);
+    free(hex);
+    big_free(&A);
+    big_free(&E);
+    big_free(&N);
+    big_free(&X);
+    big_free(&check);
+
+    printf("CT_tests passed!\n");
+    return true;
 }
 
-// Generates a ramdom hexadecimal string of length length
-void gen_rand_hex(char *output, size_t length) {
-    const char hex_dict[] = "0123456789abcdef";
-    for (size_t i = 0; i < length; i++) {
-        output[i] = hex_dict[rand() % 16];
+bool fixed_tests() {
+    bigint A, B, N, X, check;
+    big_init(&A);
+    big_init(&B);
+    big_init(&N);
+    big_init(&X);
+    big_init(&check);
+    big_mont_ctx ctx;
+
+    // The kernels live on the stack of their callers, so use the public types
+    big_u4096 a, b;
+    big_uint r[128], s[128];
+    char *hex = malloc(16 * 64 + 1);
+    srand(3344);
+    const size_t widths[] = {4, 8, 16, 32, 64, 5};
+    for (int i = 0; i < 120; i++) {
+        size_t n = widths[i % 6];
+        for (size_t j = 0; j < n; j++) {
+            a.limbs[j] = ((big_uint)rand() << 40) ^ ((big_uint)rand() << 20) ^ (big_uint)rand();
+            b.limbs[j] = ((big_uint)rand() << 40) ^ ((big_uint)rand() << 20) ^ (big_uint)rand();
+        }
+        // All ones runs every carry chain to the top
+        if (i % 10 < 2) {
+            memset(a.limbs, 0xff, n * sizeof(big_uint));
+        }
+        if (i % 10 == 1) {
+            memset(b.limbs, 0xff, n * sizeof(big_uint));
+        }
+
+        big_uint cy = limb_add_n(s, a.limbs, b.limbs, n);
+        assert(big_fixed_add(r, a.limbs, b.limbs, n) == cy && memcmp(r, s, n * sizeof(big_uint)) == 0);
+        big_uint borrow = limb_sub_n(s, a.limbs, b.limbs, n);
+        assert(big_fixed_sub(r, a.limbs, b.limbs, n) == borrow && memcmp(r, s, n * sizeof(big_uint)) == 0);
+
+        // Row by row products as the reference, which never reach the fixed kernels
+        s[n] = limb_mul_1(s, a.limbs, n, b.limbs[0]);
+        for (size_t j = 1; j < n; j++) {
+            s[n + j] = limb_addmul_1(s + j, a.limbs, n, b.limbs[j]);
+        }
+        big_fixed_mul(r, a.limbs, b.limbs, n);
+        assert(memcmp(r, s, 2 * n * sizeof(big_uint)) == 0);
+        s[n] = limb_mul_1(s, a.limbs, n, a.limbs[0]);
+        for (size_t j = 1; j < n; j++) {
+            s[n + j] = limb_addmul_1(s + j, a.limbs, n, a.limbs[j]);
+        }
+        big_fixed_sqr(r, a.limbs, n);
+        assert(memcmp(r, s, 2 * n * sizeof(big_uint)) == 0);
     }
-    output[length] = '\0'; 
+
+    // Montgomery products, checked through r * R = a * b mod N
+    for (int i = 0; i < 50; i++) {
+        size_t n = widths[i % 5];
+        hex[0] = (i % 10 < 5) ? 'f' : '1' + rand() % 9;
+        gen_rand_hex(hex + 1, 16 * n - 1);
+        if (i % 10 == 0) {
+            memset(hex, 'f', 16 * n);
+            hex[16 * n] = '\0';
+        }
+        big_read_string(&N, hex);
+        N.data[0] |= 1;
+        assert(big_mont_init(&ctx, &N) == 0);
+        gen_rand_hex(hex, 16 * n);
+        big_read_string(&X, hex);
+        big_div(NULL, &A, &X, &N);
+        gen_rand_hex(hex, 16 * n);
+        big_read_string(&X, hex);
+        big_div(NULL, &B, &X, &N);
+        if (i % 5 == 2) {
+            big_set_nonzero(&X, 1);
+            big_sub(&B, &N, &X);
+        }
+        memset(a.limbs, 0, n * sizeof(big_uint));
+        memcpy(a.limbs, A.data, limb_trimmed_len(A.data, A.num_limbs) * sizeof(big_uint));
+        memset(b.limbs, 0, n * sizeof(big_uint));
+        memcpy(b.limbs, B.data, limb_trimmed_len(B.data, B.num_limbs) * sizeof(big_uint));
+        big_mul(&X, &A, &B);
+        big_div(NULL, &check, &X, &N);
+
+        assert(big_fixed_mont_mul(r, a.limbs, (i % 3 == 0) ? a.limbs : b.limbs, &ctx) == 0);
+        if (i % 3 == 0) {
+            big_mul(&X, &A, &A);
+            big_div(NULL, &check, &X, &N);
+        }
+        assert(limb_cmp(r, ctx.N, n) < 0);
+        big_reserve(&X, 2 * n);
+        memset(X.data, 0, n * sizeof(big_uint));
+        memcpy(X.data + n, r, n * sizeof(big_uint));
+        big_normalize(&X, 2 * n, 1);
+        big_div(NULL, &X, &X, &N);
+        assert(big_cmp(&X, &check) == 0);
+
+        // In place, the way big_exp_mod calls it
+        big_uint *dst = (i % 3 == 0) ? a.limbs : b.limbs;
+        assert(big_fixed_mont_mul(dst, a.limbs, dst, &ctx) == 0);
+        assert(memcmp(dst, r, n * sizeof(big_uint)) == 0);
+        big_mont_free(&ctx);
+    }
+    big_set_nonzero(&N, 7);
+    assert(big_mont_init(&ctx, &N) == 0);
+    assert(big_fixed_mont_mul(r, a.limbs, b.limbs, &ctx) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_fixed_mont_mul(r, a.limbs, b.limbs, NULL) == ERR_BIGINT_BAD_INPUT_DATA);
+    big_mont_free(&ctx);
+
+    free(hex);
+    big_free(&A);
+    big_free(&B);
+    big_free(&N);
+    big_free(&X);
+    big_free(&check);
+
+    printf("Fixed_tests passed!\n");
+    return true;
 }
 
-// Generates a random number between low-high
-int gen_rand(int low, int high) {
-    if (low > high) {
-        int temp = low;
-        low = high;
-        high = temp;
+// RNG for big_gen_prime in the tests below, not meant for real keys
+int rand_bytes(void *p_rng, unsigned char *output, size_t len) {
+    (void)p_rng;
+    for (size_t i = 0; i < len; i++) {
+        output[i] = (unsigned char)rand();
     }
-    return low + (rand() % (high - low + 1));
+    return 0;
 }
 
-/* Performs experiment1 as described in the report. 
-By default, performs 10 multiplications of 2 numbers which have 
-a random number represented by some length between the range low, high!
-Times the multiplications and returns the total time taken up by each 
-strategy, and checks for correctness!
-*/
-void experiment1(int low, int high) {
-    srand(time(NULL)); 
-    int length_first = gen_rand(low, high);
-    int length_second = gen_rand(low, high);
+bool prime_tests() {
+    bigint X;
+    big_init(&X);
 
-    struct timeval start, end;
-    bigint first, second, result;
-    bigint karatsuba_result;
-    bigint toomcook_result;
-    big_init(&first);
-    big_init(&second);   
-    big_init(&result);
-    big_init(&karatsuba_result);
-    big_init(&toomcook_result);
-    char hex_string[length_first + 1]; 
-    char hex_string2[length_second + 1]; 
-    double regtime = 0;
-    double karattime = 0;
-    double toomcooktime = 0;
-    int counter = 0;
-    size_t temp;
-    // Note limit here, product limited to 100,000 hexadecimal characters
-    char a_buf[100000];
-    char k_buf[100000];
-    char t_buf[100000];
-    while (counter < 10) {
-        gen_rand_hex(hex_string, length_first);
-        gen_rand_hex(hex_string2, length_second);
-        big_read_string(&first, hex_string);
-        big_read_string(&second, hex_string);
-
-        gettimeofday(&start, NULL);
-        big_karatsuba(&karatsuba_result, &first, &second);
-        gettimeofday(&end, NULL);
-        karattime += (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
-
-        gettimeofday(&start, NULL);
-        big_mul(&result, &first, &second);
-        gettimeofday(&end, NULL);
-        regtime += (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
-        
-        gettimeofday(&start, NULL);
-        big_toom_cook(&toomcook_result, &first, &second);
-        gettimeofday(&end, NULL);
-        toomcooktime += (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
-        
-        counter+=1;
-        big_write_string(&result, a_buf, sizeof(a_buf), &temp);
-        big_write_string(&karatsuba_result, k_buf, sizeof(k_buf), &temp);
-        big_write_string(&toomcook_result, t_buf, sizeof(t_buf), &temp);
-        if (strcmp(a_buf, k_buf) != 0) {
-            print_bigint(&first);
-            print_bigint(&second);
-            print_bigint(&result);
-            print_bigint(&karatsuba_result);
-        }
-        assert(strcmp(a_buf, k_buf) == 0);
-        assert(strcmp(a_buf, t_buf) == 0);
-    }
-    printf("Experiment 1!\n");
-    printf("This is how long reg mul took: %f seconds\n", regtime);
-    printf("This is how long karat mul took: %f seconds\n", karattime);
-    printf("This is how long toom mul took: %f seconds\n", toomcooktime);
-    printf("\n");
-    big_free(&first);
-    big_free(&second);
-    big_free(&result);
-    big_free(&karatsuba_result);
-    big_free(&toomcook_result);
-    return;
-}
+    // Every number below 100 against the table
+    for (big_uint v = 0; v < 100; v++) {
+        bool prime = false;
+        for (size_t i = 0; i < sizeof(small_primes) / sizeof(small_primes[0]); i++) {
+            prime |= (v == (big_uint)small_primes[i]);
+        }
+        big_set_nonzero(&X, v);
+        assert((big_is_probable_prime(&X, 1) == 0) == prime);
+    }
+    big_set_nonzero(&X, 7);
+    X.signum = -1;
+    assert(big_is_probable_prime(&X, 1) == ERR_BIGINT_NOT_ACCEPTABLE);
+
+    // The smallest strong pseudoprime to all of bases, only Lucas catches it
+    big_read_string(&X, "1f51f3fee3b");
+    assert(big_is_probable_prime(&X, 0) == 0);
+    assert(big_is_probable_prime(&X, 1) == ERR_BIGINT_NOT_ACCEPTABLE);
+
+    // 2^127 - 1 is prime, 2^67 - 1 = 193707721 * 761838257287 is not
+    big_read_string(&X, "7fffffffffffffffffffffffffffffff");
+    assert(big_is_probable_prime(&X, 1) == 0);
+    big_read_string(&X, "7ffffffffffffffff");
+    assert(big_is_probable_prime(&X, 1) == ERR_BIGINT_NOT_ACCEPTABLE);
+
+    // Generated primes have exactly the requested size
+    srand(777);
+    size_t sizes[] = {2, 3, 17, 64, 65, 128, 521};
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        assert(big_gen_prime(&X, sizes[i], rand_bytes, NULL) == 0);
+        assert(big_bitlen(&X) == sizes[i]);
+        assert(big_is_probable_prime(&X, 1) == 0);
+    }
+    assert(big_gen_prime(&X, 1, rand_bytes, NULL) == ERR_BIGINT_BAD_INPUT_DATA);
 
-// Conducts an experiment of 2 random bigints multiplied together, 
-// by default using Karatsuba multiplication (can be switched out). 
-// Size is determined by number of hexadecimal characters passed in,
-// the numbers are randomly generated with those quantity of characters!
-void experiment2(int size) {
-    struct timeval start, end;
-    gettimeofday(&start, NULL);
-    srand(time(NULL)); 
+    big_free(&X);
 
-    bigint first, second, result;
-    big_init(&first);
-    big_init(&second);
-    big_init(&result);
+    printf("Prime_tests passed!\n");
+    return true;
+}
 
-    size_t length = size;
-    char hex_string[length + 1]; 
-    char hex_string2[length + 1]; 
+bool rsa_tests() {
+    bigint P, Q, E, D, T, one;
+    bigint A[5], X[5], check;
+    big_init(&P);
+    big_init(&Q);
+    big_init(&E);
+    big_init(&D);
+    big_init(&T);
+    big_init(&one);
+    big_init(&check);
+    for (int i = 0; i < 5; i++) {
+        big_init(&A[i]);
+        big_init(&X[i]);
+    }
+    big_rsa_ctx ctx;
+    big_set_nonzero(&one, 1);
+    char hex[600];
+
+    // The textbook key: N = 61 * 53 = 3233, E = 17, D = 2753, and 65 encrypts to 2790
+    big_set_nonzero(&P, 61);
+    big_set_nonzero(&Q, 53);
+    big_set_nonzero(&E, 17);
+    assert(big_rsa_init(&ctx, &P, &Q, &E) == 0);
+    big_set_nonzero(&A[0], 65);
+    assert(big_rsa_public(&X[0], &A[0], &ctx) == 0);
+    big_set_nonzero(&check, 2790);
+    assert(big_cmp(&X[0], &check) == 0);
+    assert(big_rsa_private(&X[0], &X[0], &ctx) == 0);
+    assert(big_cmp(&X[0], &A[0]) == 0);
+    big_set_nonzero(&A[0], 3233);
+    assert(big_rsa_private(&X[0], &A[0], &ctx) == ERR_BIGINT_BAD_INPUT_DATA);
+    big_set_nonzero(&A[0], 5);
+    A[0].signum = -1;
+    assert(big_rsa_private(&X[0], &A[0], &ctx) == ERR_BIGINT_BAD_INPUT_DATA);
+    assert(big_rsa_public(&X[0], &A[0], &ctx) == ERR_BIGINT_BAD_INPUT_DATA);
+    big_rsa_free(&ctx);
+
+    assert(big_rsa_init(&ctx, &P, &P, &E) == ERR_BIGINT_BAD_INPUT_DATA);
+    big_set_nonzero(&Q, 54);
+    assert(big_rsa_init(&ctx, &P, &Q, &E) == ERR_BIGINT_BAD_INPUT_DATA);
+    big_set_nonzero(&Q, 103);
+    assert(big_rsa_init(&ctx, &P, &Q, &E) == ERR_BIGINT_NOT_ACCEPTABLE);
+
+    // Generated keys against A^D mod N, balanced and not, in both orders
+    srand(5566);
+    size_t sizes[][2] = {{64, 64}, {130, 127}, {256, 256}, {90, 300}, {512, 512}, {1024, 1024}};
+    big_set_nonzero(&E, 65537);
+    for (size_t k = 0; k < sizeof(sizes) / sizeof(sizes[0]); k++) {
+        int ret;
+        do {
+            assert(big_gen_prime(&P, sizes[k][0], rand_bytes, NULL) == 0);
+            assert(big_gen_prime(&Q, sizes[k][1], rand_bytes, NULL) == 0);
+            ret = big_rsa_init(&ctx, &P, &Q, &E);
+        } while (ret == ERR_BIGINT_NOT_ACCEPTABLE);
+        assert(ret == 0);
+        big_sub(&D, &P, &one);
+        big_sub(&T, &Q, &one);
+        big_mul(&T, &T, &D);
+        assert(big_invmod(&D, &E, &T) == 0);
+
+        size_t bits = big_bitlen(&ctx.N);
+        for (int i = 0; i < 5; i++) {
+            gen_rand_hex(hex, (bits - 1) / 4);
+            big_read_string(&A[i], hex);
+        }
+        big_set_nonzero(&A[1], 1);
+        big_sub(&A[2], &ctx.N, &one);
+        big_copy(&A[3], &ctx.P);
+        assert(big_rsa_private_batch(X, A, 5, &ctx) == 0);
+        for (int i = 0; i < 5; i++) {
+            assert(big_exp_mod(&check, &A[i], &D, &ctx.N) == 0);
+            assert(big_cmp(&X[i], &check) == 0);
+            assert(big_rsa_public(&X[i], &X[i], &ctx) == 0);
+            assert(big_cmp(&X[i], &A[i]) == 0);
+        }
+        assert(big_rsa_private(&X[0], &A[0], &ctx) == 0);
+        assert(big_rsa_private(&A[0], &A[0], &ctx) == 0);
+        assert(big_cmp(&X[0], &A[0]) == 0);
+        big_rsa_free(&ctx);
+    }
 
-    int counter = 0;
-    while (counter < 10) {
-        gen_rand_hex(hex_string, length);
-        gen_rand_hex(hex_string2, length);
-        big_read_string(&first, hex_string);
-        big_read_string(&second, hex_string);
-        big_karatsuba(&result, &first, &second);
-        counter+=1;
+    big_free(&P);
+    big_free(&Q);
+    big_free(&E);
+    big_free(&D);
+    big_free(&T);
+    big_free(&one);
+    big_free(&check);
+    for (int i = 0; i < 5; i++) {
+        big_free(&A[i]);
+        big_free(&X[i]);
     }
-    big_free(&first);
-    big_free(&second);
-    big_free(&result);
-    gettimeofday(&end, NULL);
-    double timeElapsed = (end.tv_sec - start.tv_sec) + (end.tv_usec - start.tv_usec) / 1000000.0;
-    printf("Experiment 2!: This is how long it took: %f seconds\n", timeElapsed);
-    return;
+
+    printf("RSA_tests passed!\n");
+    return true;
 }
 
+/*
+Runs every test. Define BIGINT_NO_MAIN to link this file into another
+program, such as bigint_bench, which also runs the timing experiments.
+*/
+#ifndef BIGINT_NO_MAIN
 int main() {
-    // Note please wait a few seconds for the experiments, they will print out results!
     one_limb_tests();
     multiple_diff_limb_tests();
     multiple_same_limb_tests();
-    experiment1(50000, 100000);
-    experiment2(5000);
+    fft_tests();
+    sqr_tests();
+    scalar_tests();
+    toom_tests();
+    unbalanced_tests();
+    parallel_tests();
+    division_tests();
+    barrett_tests();
+    gcd_tests();
+    tree_tests();
+    root_tests();
+    fac_tests();
+    radix_tests();
+    binary_tests();
+    modexp_tests();
+    ct_tests();
+    fixed_tests();
+    prime_tests();
+    rsa_tests();
     return 0;
-}
\ No newline at end of file
+}
+#endif
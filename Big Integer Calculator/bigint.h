@@ -16,26 +16,28 @@
 #define ERR_BIGINT_DIVISION_BY_ZERO  -0x000C   /**< The input argument for division is zero, which is not allowed. */
 #define ERR_BIGINT_NOT_ACCEPTABLE    -0x000E   /**< The input arguments are not acceptable. */
 #define ERR_BIGINT_ALLOC_FAILED      -0x0010   /**< Memory allocation failed. */
+#define ERR_BIGINT_FILE_IO_ERROR     -0x0012   /**< Opening, reading or writing a file failed. */
 
 typedef int64_t big_sint;
 typedef uint64_t big_uint;
 typedef unsigned __int128 big_udbl;
-const int small_primes[] = {
+static const int small_primes[] = {
     2, 3, 5, 7, 11, 13, 17, 19, 23, 29,
     31, 37, 41, 43, 47, 53, 59, 61, 67,
     71, 73, 79, 83, 89, 97
 };
-const int bases[5] = {2, 3, 5, 7, 11};
+static const int bases[5] = {2, 3, 5, 7, 11};
 /**
  * \brief          bigint structure
  */
 typedef struct {
     int signum;       /*!<  integer sign      */
     size_t num_limbs; /*!<  total # of limbs  */
+    size_t alloc;     /*!<  # of limbs data has room for  */
     big_uint *data;   /*!<  pointer to limbs  */
 } bigint;
 
-#define BIG_ZERO ((bigint){.signum = 0, .num_limbs = 0, .data = NULL})
+#define BIG_ZERO ((bigint){.signum = 0, .num_limbs = 0, .alloc = 0, .data = NULL})
 
 /**
  * \brief           Initialize one bigint (make internal references valid)
@@ -53,6 +55,29 @@ void big_init(bigint *X);
  */
 void big_free(bigint *X);
 
+/**
+ * \brief          Make sure X has room for at least limbs limbs, keeping
+ *                 its value. Operations on X then reuse that room instead
+ *                 of reallocating.
+ *
+ * \param X        bigint to grow
+ * \param limbs    Number of limbs to reserve
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_reserve(bigint *X, size_t limbs);
+
+/**
+ * \brief          Release the room X has beyond its current value
+ *
+ * \param X        bigint to shrink
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_shrink_to_fit(bigint *X);
+
 /**
  * \brief          Copy the contents of Y into X
  *
@@ -97,9 +122,15 @@ int big_set_nonzero(bigint *X, big_uint limb);
  * \brief          Import from an ASCII hexadecimal string
  *
  * \param X        Destination bigint
- * \param s        Null-terminated string buffer
+ * \param s        Null-terminated string buffer, optionally starting
+ *                 with '-'
  *
- * \return         0 if successful, or a ERR_BIGINT_XXX error code
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_INVALID_CHARACTER if s has no digits or a
+ *                 character that is not a hex digit,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed.
+ *                 X is left unchanged on error.
  * 
  * \note           Must support lower hexadecimal. May also support
  *                 upper, or a mix.
@@ -124,6 +155,49 @@ int big_read_string(bigint *X, const char *s);
 int big_write_string(const bigint *X,
                      char *buf, size_t buflen, size_t *olen);
 
+/**
+ * \brief          Import from an ASCII string in any radix from 2 to 36
+ *
+ * \param X        Destination bigint
+ * \param s        Null-terminated string, optionally starting with '-'.
+ *                 Digits above 9 are letters, in either case.
+ * \param radix    Input radix, 2 to 36
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL or the
+ *                 radix is out of range,
+ *                 ERR_BIGINT_INVALID_CHARACTER if s has no digits or a
+ *                 character that is not a digit in this radix,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed.
+ *                 X is left unchanged on error.
+ *
+ * \note           Long decimal and other strings whose radix is not a power
+ *                 of 2 are converted by divide and conquer, which costs
+ *                 about as much as a few multiplications of the result.
+ */
+int big_read_string_radix(bigint *X, const char *s, int radix);
+
+/**
+ * \brief          Export into an ASCII string in any radix from 2 to 36,
+ *                 with lowercase letters for digits above 9
+ *
+ * \param X        Source bigint
+ * \param radix    Output radix, 2 to 36
+ * \param buf      Buffer to write the string to, may be NULL if buflen is 0
+ * \param buflen   Length of buf
+ * \param olen     Length of the string written, including final NUL byte
+ *
+ * \return         0 if successful, or a ERR_BIGINT_XXX error code.
+ *                 *olen is always updated to reflect the amount
+ *                 of data that has (or would have) been written.
+ *
+ * \note           Like big_write_string, call with buflen = 0 to obtain the
+ *                 exact size in *olen. Unless the radix is a power of 2, that
+ *                 takes a full conversion, so rather pass a buffer of
+ *                 big_bitlen(X) / log2(radix) + 3 bytes, which always fits.
+ */
+int big_write_string_radix(const bigint *X, int radix, char *buf, size_t buflen, size_t *olen);
+
 /**
  * \brief          Import X from unsigned binary data, big endian
  *
@@ -132,6 +206,8 @@ int big_write_string(const bigint *X,
  * \param buflen   Input buffer size
  *
  * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if X is NULL, or buf is NULL
+ *                 with buflen > 0,
  *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
  */
 int big_read_binary(bigint *X, const uint8_t *buf, size_t buflen);
@@ -147,13 +223,98 @@ int big_read_binary(bigint *X, const uint8_t *buf, size_t buflen);
  *
  * \return         0 if successful,
  *                 ERR_BIGINT_BUFFER_TOO_SMALL if buf isn't large enough
+ *
+ * \note           Only the magnitude is written, the sign is dropped.
  */
 int big_write_binary(const bigint *X, uint8_t *buf, size_t buflen);
 
 /**
- * \brief          Signed addition: X = A + B
+ * \brief          Import X from unsigned binary data, little endian
  *
  * \param X        Destination bigint
+ * \param buf      Input buffer, least significant byte first
+ * \param buflen   Input buffer size
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if X is NULL, or buf is NULL
+ *                 with buflen > 0,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           On little endian hosts this is a single copy.
+ */
+int big_read_binary_le(bigint *X, const uint8_t *buf, size_t buflen);
+
+/**
+ * \brief          Export the magnitude of X into unsigned binary data,
+ *                 little endian. Always fills the whole buffer, which ends
+ *                 in zeros if the number is smaller.
+ *
+ * \param X        Source bigint
+ * \param buf      Output buffer
+ * \param buflen   Output buffer size
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BUFFER_TOO_SMALL if buf isn't large enough
+ */
+int big_write_binary_le(const bigint *X, uint8_t *buf, size_t buflen);
+
+/**
+ * \brief          A number file opened with big_map_file
+ */
+typedef struct {
+    bigint value;     /*!<  the number, read-only               */
+    void *addr;       /*!<  start of the mapping or the copy    */
+    size_t length;    /*!<  bytes mapped, 0 if value is a copy  */
+} big_mapped_file;
+
+/**
+ * \brief          Write the magnitude of X to a number file: its limbs in
+ *                 little endian order, least significant first, which is
+ *                 the format big_map_file reads
+ *
+ * \param X        Source bigint
+ * \param path     File to create or overwrite
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_FILE_IO_ERROR if the file cannot be written
+ */
+int big_write_file(const bigint *X, const char *path);
+
+/**
+ * \brief          Open a number file as a bigint without copying it. On
+ *                 little endian POSIX hosts the file is mapped into memory
+ *                 and map->value points straight at its limbs, so only the
+ *                 pages an operation touches are ever read. Elsewhere the
+ *                 file is read into memory.
+ *
+ * \param map      Set to the opened file
+ * \param path     File written by big_write_file, or any file of
+ *                 little endian bytes
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_FILE_IO_ERROR if the file cannot be opened or
+ *                 mapped,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           map->value may only be passed as an operand, never as a
+ *                 destination or to big_free, and it must not be used after
+ *                 big_unmap_file. The file must not shrink while mapped.
+ */
+int big_map_file(big_mapped_file *map, const char *path);
+
+/**
+ * \brief          Close a file opened with big_map_file
+ *
+ * \param map      Opened file, or NULL
+ */
+void big_unmap_file(big_mapped_file *map);
+
+/**
+ * \brief          Signed addition: X = A + B
+ *
+ * \param X        Destination bigint, may alias A or B
  * \param A        Left-hand bigint
  * \param B        Right-hand bigint
  *
@@ -165,7 +326,7 @@ int big_add(bigint *X, const bigint *A, const bigint *B);
 /**
  * \brief          Signed subtraction: X = A - B
  *
- * \param X        Destination bigint
+ * \param X        Destination bigint, may alias A or B
  * \param A        Left-hand bigint
  * \param B        Right-hand bigint
  *
@@ -189,7 +350,7 @@ int big_cmp(const bigint *X, const bigint *Y);
 /**
  * \brief          Baseline multiplication: X = A * B
  *
- * \param X        Destination bigint
+ * \param X        Destination bigint, may alias A or B
  * \param A        Left-hand bigint
  * \param B        Right-hand bigint
  *
@@ -198,19 +359,1093 @@ int big_cmp(const bigint *X, const bigint *Y);
  */
 int big_mul(bigint *X, const bigint *A, const bigint *B);
 
+/**
+ * \brief          Karatsuba multiplication: X = A * B
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_karatsuba(bigint *X, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Toom-Cook 3-way multiplication: X = A * B
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_toom_cook(bigint *X, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Toom-Cook 4-way multiplication: X = A * B
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_toom4(bigint *X, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Toom-Cook 6.5-way multiplication: X = A * B
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_toom6h(bigint *X, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Number-theoretic transform multiplication: X = A * B
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_mul_fft(bigint *X, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Multiplication with the fastest method for the operand
+ *                 sizes: X = A * B
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_mul_auto(bigint *X, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Squaring with the fastest method for the size of A:
+ *                 X = A * A. Squaring methods skip about half the work of
+ *                 a general product, and big_mul_auto uses them on its own
+ *                 whenever both operands are the same bigint
+ *
+ * \param X        Destination bigint, may alias A
+ * \param A        bigint to square
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_sqr(bigint *X, const bigint *A);
+
+/**
+ * \brief          Fused multiply-add: X = X + A * B
+ *
+ * \param X        Accumulator bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Short products are added into X a row at a time without
+ *                 ever being stored, longer ones are formed in scratch space
+ *                 with big_mul_auto's algorithms and added in one pass.
+ */
+int big_addmul(bigint *X, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Fused multiply-subtract: X = X - A * B
+ *
+ * \param X        Accumulator bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_submul(bigint *X, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Multiplication by a single limb: X = A * u
+ *
+ * \param X        Destination bigint, may alias A
+ * \param A        Left-hand bigint
+ * \param u        Unsigned limb
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_mul_ui(bigint *X, const bigint *A, big_uint u);
+
+/**
+ * \brief          Addition of a single limb: X = A + u
+ *
+ * \param X        Destination bigint, may alias A
+ * \param A        Left-hand bigint
+ * \param u        Unsigned limb
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_add_ui(bigint *X, const bigint *A, big_uint u);
+
+/**
+ * \brief          Subtraction of a single limb: X = A - u
+ *
+ * \param X        Destination bigint, may alias A
+ * \param A        Left-hand bigint
+ * \param u        Unsigned limb
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_sub_ui(bigint *X, const bigint *A, big_uint u);
+
+/**
+ * \brief          Scratch space needed to multiply operands of an and bn
+ *                 limbs with big_mul_with_scratch
+ *
+ * \param an       Limbs in the left-hand operand
+ * \param bn       Limbs in the right-hand operand
+ *
+ * \return         The number of big_uint limbs the scratch buffer must hold.
+ *
+ * \note           The size never decreases as an or bn grow, so a buffer
+ *                 sized for the largest product also serves all smaller ones.
+ */
+size_t big_mul_scratch_size(size_t an, size_t bn);
+
+/**
+ * \brief          Multiplication using caller-provided scratch: X = A * B
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ * \param scratch  Buffer of at least big_mul_scratch_size() limbs, or NULL
+ *                 to allocate one for this call
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_mul_with_scratch(bigint *X, const bigint *A, const bigint *B, big_uint *scratch);
+
+/**
+ * \brief          Algorithm cutoffs in limbs. They start out at the values
+ *                 of bigint_thresholds.h if bigint_bench tune has written
+ *                 one, or at the built-in defaults otherwise.
+ *
+ * \note           They may be changed between operations but not during one.
+ *                 The Karatsuba and Toom cutoffs must stay at 32 or above,
+ *                 bz_div_threshold at 2 or above and the radix conversion
+ *                 cutoffs at 1 or above.
+ */
+extern size_t karatsuba_threshold;      /**< Largest schoolbook product */
+extern size_t toom3_threshold;          /**< Largest Karatsuba product */
+extern size_t toom4_threshold;          /**< Largest Toom-3 product */
+extern size_t toom6h_threshold;         /**< Largest Toom-4 product */
+extern size_t sqr_basecase_threshold;   /**< Smallest triangle square */
+extern size_t sqr_karatsuba_threshold;  /**< Largest schoolbook square */
+extern size_t sqr_toom3_threshold;      /**< Largest Karatsuba square */
+extern size_t sqr_toom4_threshold;      /**< Largest Toom-3 square */
+extern size_t sqr_toom6h_threshold;     /**< Largest Toom-4 square */
+extern size_t fft_mul_threshold;        /**< Smallest FFT product */
+extern size_t bz_div_threshold;         /**< Smallest recursive division */
+extern size_t mont_cios_threshold;      /**< Largest fused Montgomery product */
+extern size_t mullo_threshold;          /**< Smallest recursive short product */
+extern size_t hgcd_threshold;           /**< Smallest half-GCD */
+extern size_t trial_tree_threshold;     /**< Smallest trial division by remainder tree */
+extern size_t parallel_mul_threshold;   /**< Largest serial product in big_mul_parallel */
+extern size_t radix_read_threshold;     /**< Longest quadratic string parse */
+extern size_t radix_write_threshold;    /**< Longest quadratic string print */
+
+/**
+ * \brief          Pool of worker threads for big_mul_parallel
+ */
+typedef struct big_thread_pool big_thread_pool;
+
+/**
+ * \brief          Start a pool that multiplies on the given number of
+ *                 threads, counting the one calling big_mul_parallel
+ *
+ * \param pool     Set to the new pool
+ * \param threads  Number of threads, at least 1
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if pool is NULL or threads is 0,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation or starting
+ *                 a thread failed
+ */
+int big_pool_init(big_thread_pool **pool, size_t threads);
+
+/**
+ * \brief          Stop the threads of a pool and free it
+ *
+ * \param pool     Pool from big_pool_init, or NULL
+ */
+void big_pool_free(big_thread_pool *pool);
+
+/**
+ * \brief          Multi-threaded multiplication: X = A * B
+ *
+ *                 Products above parallel_mul_threshold limbs are split
+ *                 with Toom-3 or Karatsuba, and their subproducts run as
+ *                 tasks on the threads of the pool
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ * \param pool     Pool from big_pool_init
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Calls sharing a pool run one after the other. Built with
+ *                 BIGINT_NO_THREADS, the pool has no threads and this is
+ *                 big_mul_auto.
+ */
+int big_mul_parallel(bigint *X, const bigint *A, const bigint *B, big_thread_pool *pool);
+
 /**
  * \brief          Division by bigint: A = Q * B + R
  *
- * \param Q        Destination bigint for the quotient
- * \param R        Destination bigint for the rest value
+ * \param Q        Destination bigint for the quotient, or NULL, may alias
+ *                 A or B
+ * \param R        Destination bigint for the rest value, or NULL, may
+ *                 alias A or B but not Q
  * \param A        Left-hand bigint
  * \param B        Right-hand bigint
  *
  * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if A or B is NULL, both Q and R
+ *                 are NULL or Q is R,
  *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed,
  *                 ERR_BIGINT_DIVISION_BY_ZERO if B == 0
  *
- * \note           Either Q or R can be NULL.
+ * \note           Either Q or R can be NULL. The quotient is rounded
+ *                 towards zero, so R takes the sign of A.
+ */
+int big_div(bigint *Q, bigint *R, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Division by a single limb: A = Q * d + R
+ *
+ * \param Q        Destination bigint for the quotient
+ * \param R        Destination for the magnitude of the rest value
+ * \param A        Left-hand bigint
+ * \param d        Divisor limb
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed,
+ *                 ERR_BIGINT_DIVISION_BY_ZERO if d == 0
+ *
+ * \note           Either Q or R can be NULL. Like big_div the quotient is
+ *                 rounded towards zero, *R is |A| mod d and the rest value
+ *                 takes the sign of A.
+ */
+int big_div_ui(bigint *Q, big_uint *R, const bigint *A, big_uint d);
+
+/**
+ * \brief          Exact division by a single limb: Q = A / d
+ *
+ * \param Q        Destination bigint
+ * \param A        Left-hand bigint, a multiple of d
+ * \param d        Divisor limb
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed,
+ *                 ERR_BIGINT_DIVISION_BY_ZERO if d == 0
+ *
+ * \note           Multiplies by the inverse of d instead of dividing, which
+ *                 takes about half the time of big_div_ui. If d does not
+ *                 divide A the result is meaningless.
+ */
+int big_divexact_ui(bigint *Q, const bigint *A, big_uint d);
+
+/**
+ * \brief          Low half of a product: X = A * B mod 2^(64 * n)
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ * \param n        Number of limbs to keep
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Computed on the magnitudes, and X takes the sign of
+ *                 A * B. Only the partial products below limb n are
+ *                 formed, which saves up to half of a schoolbook product
+ *                 and about a fifth of a Karatsuba or Toom one.
+ */
+int big_mullo(bigint *X, const bigint *A, const bigint *B, size_t n);
+
+/**
+ * \brief          High half of a product: X = A * B / 2^(64 * n)
+ *
+ * \param X        Destination bigint, may alias A or B
+ * \param A        Left-hand bigint
+ * \param B        Right-hand bigint
+ * \param n        Number of limbs to drop
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Computed on the magnitudes and rounded down, and X takes
+ *                 the sign of A * B. The result is exact, but the work is
+ *                 only saved when A and B both fit in n limbs, otherwise
+ *                 this forms the full product.
+ */
+int big_mulhi(bigint *X, const bigint *A, const bigint *B, size_t n);
+
+/**
+ * \brief          Barrett context for one modulus M, which unlike a
+ *                 Montgomery one may be even
+ */
+typedef struct {
+    size_t n;         /*!<  # of limbs in M                       */
+    big_uint *M;      /*!<  modulus limbs, plus a zero limb on top  */
+    big_uint *mu;     /*!<  floor(2^(128 * n) / M), n + 1 limbs     */
+} big_barrett_ctx;
+
+/**
+ * \brief          Set up a Barrett context for the modulus M
+ *
+ * \param ctx      Context to initialize
+ * \param M        Modulus, must be positive
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if M is not positive,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_barrett_init(big_barrett_ctx *ctx, const bigint *M);
+
+/**
+ * \brief          Unallocate a Barrett context
+ *
+ * \param ctx      Context to unallocate
+ */
+void big_barrett_free(big_barrett_ctx *ctx);
+
+/**
+ * \brief          Barrett reduction: X = A mod M
+ *
+ * \param X        Destination bigint, may alias A
+ * \param A        bigint to reduce
+ * \param ctx      Context from big_barrett_init
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if ctx is not set up,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           The result lies in [0, M) even for negative A. Values
+ *                 of up to twice the length of M, such as products of two
+ *                 residues, take one short product of each half and no
+ *                 division. Longer ones are reduced n limbs at a time.
+ */
+int big_barrett_reduce(bigint *X, const bigint *A, const big_barrett_ctx *ctx);
+
+/**
+ * \brief          Greatest common divisor: G = gcd(A, B)
+ *
+ * \param G        Destination bigint, may alias A or B
+ * \param A        First operand
+ * \param B        Second operand
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           G is never negative, and gcd(0, 0) = 0. Operands from
+ *                 hgcd_threshold limbs up are reduced by the subquadratic
+ *                 half-GCD, shorter ones by Lehmer steps on their top 128
+ *                 bits and the last limb by the binary algorithm.
+ */
+int big_gcd(bigint *G, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Extended GCD: G = gcd(A, B) = S * A + T * B
+ *
+ * \param G        Destination for the GCD, or NULL
+ * \param S        Destination for the cofactor of A, or NULL
+ * \param T        Destination for the cofactor of B, or NULL
+ * \param A        First operand
+ * \param B        Second operand
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if A or B is NULL or two of the
+ *                 destinations are the same bigint,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           The destinations may alias A or B. |S| <= |B| / G and
+ *                 |T| <= |A| / G. Only S is tracked through the reduction,
+ *                 T is found by one exact division at the end, so leaving
+ *                 it out saves that division.
+ */
+int big_gcdext(bigint *G, bigint *S, bigint *T, const bigint *A, const bigint *B);
+
+/**
+ * \brief          Modular inverse: X = A^-1 mod N
+ *
+ * \param X        Destination bigint, may alias A or N
+ * \param A        bigint to invert, of either sign
+ * \param N        Modulus, must be positive
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL or N is
+ *                 not positive,
+ *                 ERR_BIGINT_NOT_ACCEPTABLE if gcd(A, N) is not 1,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           The result lies in [0, N).
+ */
+int big_invmod(bigint *X, const bigint *A, const bigint *N);
+
+/**
+ * \brief          Batch modular inverse: X[i] = A[i]^-1 mod N
+ *
+ * \param X        Array of count destination bigints, may be A itself
+ * \param A        Array of count bigints to invert
+ * \param count    Number of elements
+ * \param N        Modulus, must be positive
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL or N is
+ *                 not positive,
+ *                 ERR_BIGINT_NOT_ACCEPTABLE if some A[i] has no inverse,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Montgomery's trick: one big_invmod of the product of all
+ *                 the A[i] and three modular multiplications per element.
+ *                 X is left unspecified on failure.
+ */
+int big_invmod_batch(bigint *X, const bigint *A, size_t count, const bigint *N);
+
+/**
+ * \brief          Binary tree of bigints over count leaves, as built by
+ *                 big_product_tree and big_remainder_tree. Level 0 holds
+ *                 the leaves, each level above pairs up the nodes of the
+ *                 one below, an odd last node moving up as it is, and the
+ *                 top level holds the root alone.
+ */
+typedef struct {
+    size_t count;     /*!<  # of leaves                                        */
+    size_t levels;    /*!<  # of levels, the root's is levels - 1              */
+    size_t *start;    /*!<  index in nodes of each level's first node, and the
+                            total # of nodes at start[levels]                  */
+    bigint *nodes;    /*!<  all nodes level by level, read-only                */
+    big_uint *arena;  /*!<  limbs of all nodes, one allocation                 */
+} big_tree;
+
+/**
+ * \brief          Product tree: the leaves are X[0], ..., X[count - 1]
+ *                 and every other node is the product of its two children,
+ *                 so the root is the product of all of them
+ *
+ * \param T        Tree to build
+ * \param X        Array of count positive bigints
+ * \param count    Number of leaves, at least 1
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL, count
+ *                 is 0 or some X[i] is not positive,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           All nodes live in one arena. They are views into it that
+ *                 must not be written to or freed one by one, only the
+ *                 whole tree with big_tree_free.
+ */
+int big_product_tree(big_tree *T, const bigint *X, size_t count);
+
+/**
+ * \brief          Remainder tree: every node of R is A modulo the node at
+ *                 the same place in T, so the leaves of R are A mod X[i]
+ *
+ * \param R        Tree to build, distinct from T
+ * \param T        Product tree from big_product_tree
+ * \param A        Non-negative bigint to reduce
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL, R is T
+ *                 or A is negative,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Each node is reduced from its parent's remainder rather
+ *                 than from A, so the work is a few divisions of the size
+ *                 of A at the top and ever smaller ones below, instead of
+ *                 count divisions of A.
+ */
+int big_remainder_tree(big_tree *R, const big_tree *T, const bigint *A);
+
+/**
+ * \brief          Free a tree from big_product_tree or big_remainder_tree
+ *
+ * \param T        Tree to free
+ */
+void big_tree_free(big_tree *T);
+
+/**
+ * \brief          Batch GCD: G[i] = gcd(N[i], product of all N[j], j != i),
+ *                 for instance to find RSA moduli that share a prime
+ *
+ * \param G        Array of count destination bigints, may alias N
+ * \param N        Array of count positive bigints
+ * \param count    Number of bigints, at least 1
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL, count
+ *                 is 0 or some N[i] is not positive,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Bernstein's algorithm, a product tree and a remainder
+ *                 tree modulo the squares of its nodes, takes time about
+ *                 that of multiplying all N[i] together times a log factor,
+ *                 where comparing every pair is quadratic in count. G[i] is
+ *                 1 for a modulus that shares no factor with the others.
+ */
+int big_batch_gcd(bigint *G, const bigint *N, size_t count);
+
+/**
+ * \brief          Integer square root: S = floor(sqrt(A))
+ *
+ * \param S        Destination bigint, may alias A
+ * \param A        Bigint, at least 0
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if S or A is NULL,
+ *                 ERR_BIGINT_NEGATIVE_VALUE if A < 0,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Newton's iteration, each step at twice the precision of
+ *                 the one before, so the root costs a small multiple of one
+ *                 division of A's size.
+ */
+int big_sqrt(bigint *S, const bigint *A);
+
+/**
+ * \brief          Integer square root with remainder: S = floor(sqrt(A)),
+ *                 R = A - S^2
+ *
+ * \param S        Destination bigint for the root, may alias A
+ * \param R        Destination bigint for the remainder, or NULL, may alias
+ *                 A but not S
+ * \param A        Bigint, at least 0
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if S or A is NULL or R is S,
+ *                 ERR_BIGINT_NEGATIVE_VALUE if A < 0,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           A is a perfect square exactly if R is 0.
+ */
+int big_sqrtrem(bigint *S, bigint *R, const bigint *A);
+
+/**
+ * \brief          Integer k-th root: X = A^(1/k) rounded towards zero
+ *
+ * \param X        Destination bigint, may alias A
+ * \param A        Bigint, not negative if k is even
+ * \param k        Degree of the root, at least 1
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if X or A is NULL or k is 0,
+ *                 ERR_BIGINT_NEGATIVE_VALUE if A < 0 and k is even,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_root(bigint *X, const bigint *A, big_uint k);
+
+/**
+ * \brief          Integer k-th root with remainder: X = A^(1/k) rounded
+ *                 towards zero, R = A - X^k
+ *
+ * \param X        Destination bigint for the root, may alias A
+ * \param R        Destination bigint for the remainder, or NULL, may alias
+ *                 A but not X
+ * \param A        Bigint, not negative if k is even
+ * \param k        Degree of the root, at least 1
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if X or A is NULL, R is X or k
+ *                 is 0,
+ *                 ERR_BIGINT_NEGATIVE_VALUE if A < 0 and k is even,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           A is a perfect k-th power exactly if R is 0. For A < 0,
+ *                 R has the sign of A or is 0.
+ */
+int big_rootrem(bigint *X, bigint *R, const bigint *A, big_uint k);
+
+/**
+ * \brief          Factorial: X = n!
+ *
+ * \param X        Destination bigint
+ * \param n        Unsigned integer, 0! = 1
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if X is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           The factors are multiplied by binary splitting, in two
+ *                 halves of the range recursively, so the large products
+ *                 are balanced ones.
+ */
+int big_fac_ui(bigint *X, big_uint n);
+
+/**
+ * \brief          Binomial coefficient: X = n! / (k! (n - k)!)
+ *
+ * \param X        Destination bigint
+ * \param n        Unsigned integer
+ * \param k        Unsigned integer, X is 0 if k > n
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if X is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_bin_uiui(bigint *X, big_uint n, big_uint k);
+
+/**
+ * \brief          Digits of pi: X = floor(pi * 16^digits), whose
+ *                 hexadecimal string is "3" and then the first digits
+ *                 hexadecimal digits of pi after the point
+ *
+ * \param X        Destination bigint
+ * \param digits   Number of hexadecimal digits after the point
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if X is NULL or digits is too
+ *                 large to count the bits of,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           The Chudnovsky series by binary splitting, then one
+ *                 square root and one division at full precision. Pi is
+ *                 computed with 64 guard bits, so the last digit could
+ *                 only be off by one if the 64 bits after it were all
+ *                 zeros or all ones.
+ */
+int big_pi_hex(bigint *X, size_t digits);
+
+/**
+ * \brief          Montgomery context for one odd modulus N
+ */
+typedef struct {
+    size_t n;         /*!<  # of limbs in N                  */
+    big_uint ninv;    /*!<  -N^-1 mod 2^64                   */
+    big_uint *N;      /*!<  modulus limbs                    */
+    big_uint *RR;     /*!<  R^2 mod N, where R = 2^(64 * n)  */
+} big_mont_ctx;
+
+/**
+ * \brief          Set up a Montgomery context for the modulus N
+ *
+ * \param ctx      Context to initialize
+ * \param N        Modulus, must be odd and positive
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if N is even or not positive,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_mont_init(big_mont_ctx *ctx, const bigint *N);
+
+/**
+ * \brief          Unallocate a Montgomery context
+ *
+ * \param ctx      Context to unallocate
+ */
+void big_mont_free(big_mont_ctx *ctx);
+
+/**
+ * \brief          Sliding-window exponentiation: X = A^E mod N
+ *
+ * \param X        Destination bigint, may alias A or E
+ * \param A        Left-hand bigint
+ * \param E        Exponent bigint
+ * \param N        Modular bigint
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if N is even or not positive,
+ *                 or if E is negative,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           The running time depends on E, so do not use it with
+ *                 secret exponents where timing can be observed.
+ */
+int big_exp_mod(bigint *X, const bigint *A, const bigint *E, const bigint *N);
+
+/**
+ * \brief          Same as big_exp_mod, with the Montgomery context for N
+ *                 already set up, so repeated exponentiations modulo the
+ *                 same N skip computing R^2 mod N
+ *
+ * \param X        Destination bigint, may alias A or E
+ * \param A        Left-hand bigint
+ * \param E        Exponent bigint
+ * \param ctx      Context from big_mont_init
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if E is negative,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_exp_mod_ctx(bigint *X, const bigint *A, const bigint *E, const big_mont_ctx *ctx);
+
+/**
+ * \brief          Stack-allocated operands of the widths the big_fixed_*
+ *                 kernels are specialized for, 256 to 4096 bits
+ */
+typedef struct { big_uint limbs[4]; } big_u256;
+typedef struct { big_uint limbs[8]; } big_u512;
+typedef struct { big_uint limbs[16]; } big_u1024;
+typedef struct { big_uint limbs[32]; } big_u2048;
+typedef struct { big_uint limbs[64]; } big_u4096;
+
+/**
+ * \brief          Fixed-width addition: {rp, n} = {ap, n} + {bp, n}
+ *
+ * \param rp       Destination limbs, may alias ap or bp
+ * \param ap       Left-hand limbs
+ * \param bp       Right-hand limbs
+ * \param n        Number of limbs of every operand
+ *
+ * \return         The carry out of the top limb, 0 or 1.
+ *
+ * \note           The big_fixed_* functions take little endian limb arrays,
+ *                 such as the limbs of a big_u256 to big_u4096, and never
+ *                 allocate. For n = 4, 8, 16, 32 and 64 they run kernels
+ *                 compiled for that width with their loops unrolled; any
+ *                 other n falls back to the generic code. The bigint
+ *                 functions pick the same kernels on their own whenever
+ *                 both operands have one of these widths.
+ */
+big_uint big_fixed_add(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n);
+
+/**
+ * \brief          Fixed-width subtraction: {rp, n} = {ap, n} - {bp, n}
+ *
+ * \param rp       Destination limbs, may alias ap or bp
+ * \param ap       Left-hand limbs
+ * \param bp       Right-hand limbs
+ * \param n        Number of limbs of every operand
+ *
+ * \return         The borrow out of the top limb, 0 or 1.
+ */
+big_uint big_fixed_sub(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n);
+
+/**
+ * \brief          Fixed-width multiplication: {rp, 2n} = {ap, n} * {bp, n}
+ *
+ * \param rp       Destination of 2n limbs, must not overlap ap or bp
+ * \param ap       Left-hand limbs
+ * \param bp       Right-hand limbs
+ * \param n        Number of limbs of either operand, at least 1
+ */
+void big_fixed_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n);
+
+/**
+ * \brief          Fixed-width squaring: {rp, 2n} = {ap, n}^2
+ *
+ * \param rp       Destination of 2n limbs, must not overlap ap
+ * \param ap       Source limbs
+ * \param n        Number of limbs, at least 1
+ */
+void big_fixed_sqr(big_uint *rp, const big_uint *ap, size_t n);
+
+/**
+ * \brief          Fixed-width Montgomery multiplication:
+ *                 {rp, n} = {ap, n} * {bp, n} / R mod N
+ *
+ * \param rp       Destination of n = ctx->n limbs, may alias ap or bp
+ * \param ap       Left-hand limbs, must be below N
+ * \param bp       Right-hand limbs, must be below N
+ * \param ctx      Context from big_mont_init
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if a pointer is NULL or N is
+ *                 not 4, 8, 16, 32 or 64 limbs long
+ */
+int big_fixed_mont_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, const big_mont_ctx *ctx);
+
+/**
+ * \brief          Constant-time addition: {rp, n} = {ap, n} + {bp, n}
+ *
+ * \param rp       Destination limbs, may alias ap or bp
+ * \param ap       Left-hand limbs
+ * \param bp       Right-hand limbs
+ * \param n        Number of limbs of every operand
+ *
+ * \return         The carry out of the top limb, 0 or 1.
+ *
+ * \note           The big_ct_* functions take fixed-width little endian limb
+ *                 arrays sized by the caller and never allocate. Their
+ *                 branches and memory accesses depend on n only, not on
+ *                 the values, so they suit secret operands such as private
+ *                 exponents where the bigint functions, which trim leading
+ *                 zeros and choose algorithms by size, would leak timing.
+ */
+big_uint big_ct_add(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n);
+
+/**
+ * \brief          Constant-time subtraction: {rp, n} = {ap, n} - {bp, n}
+ *
+ * \param rp       Destination limbs, may alias ap or bp
+ * \param ap       Left-hand limbs
+ * \param bp       Right-hand limbs
+ * \param n        Number of limbs of every operand
+ *
+ * \return         The borrow out of the top limb, 0 or 1. The difference
+ *                 wraps around modulo 2^(64 * n) when it is 1.
+ */
+big_uint big_ct_sub(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n);
+
+/**
+ * \brief          Constant-time multiplication: {rp, 2n} = {ap, n} * {bp, n}
+ *
+ * \param rp       Destination of 2n limbs, must not overlap ap or bp
+ * \param ap       Left-hand limbs
+ * \param bp       Right-hand limbs
+ * \param n        Number of limbs of either operand, at least 1
+ *
+ * \note           Always the schoolbook method, since Karatsuba and Toom
+ *                 branch on the signs of their intermediate differences.
+ */
+void big_ct_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n);
+
+/**
+ * \brief          Constant-time comparison of {ap, n} and {bp, n}
+ *
+ * \param ap       Left-hand limbs
+ * \param bp       Right-hand limbs
+ * \param n        Number of limbs of either operand
+ *
+ * \return         1 if ap > bp, -1 if ap < bp, 0 if they are equal.
+ */
+int big_ct_cmp(const big_uint *ap, const big_uint *bp, size_t n);
+
+/**
+ * \brief          Constant-time conditional swap of {ap, n} and {bp, n}
+ *
+ * \param ap       First limbs
+ * \param bp       Second limbs
+ * \param n        Number of limbs of either operand
+ * \param swap     1 to swap, 0 to leave both as they are
+ */
+void big_ct_cswap(big_uint *ap, big_uint *bp, size_t n, big_uint swap);
+
+/**
+ * \brief          Constant-time select: {rp, n} = cond ? {ap, n} : {bp, n}
+ *
+ * \param rp       Destination limbs, may alias ap or bp
+ * \param ap       Limbs taken if cond is 1
+ * \param bp       Limbs taken if cond is 0
+ * \param n        Number of limbs of every operand
+ * \param cond     1 or 0
+ */
+void big_ct_select(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint cond);
+
+/**
+ * \brief          Scratch space big_ct_exp_mod needs for an n-limb modulus
+ *
+ * \param n        Limbs in the modulus, ctx->n
+ *
+ * \return         The number of big_uint limbs the scratch buffer must hold.
+ */
+size_t big_ct_exp_mod_scratch_size(size_t n);
+
+/**
+ * \brief          Constant-time exponentiation with a Montgomery ladder:
+ *                 {rp, n} = {ap, n}^{ep, en} mod N
+ *
+ * \param rp       Destination of n = ctx->n limbs, may alias ap
+ * \param ap       Base of n limbs, must be below N
+ * \param ep       Exponent of en limbs
+ * \param en       Limbs in the exponent, which sets the running time
+ * \param ctx      Context from big_mont_init
+ * \param tp       Scratch of big_ct_exp_mod_scratch_size(n) limbs
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if a pointer is NULL
+ *
+ * \note           Every one of the 64 * en exponent bits costs one Montgomery
+ *                 multiplication and one squaring whatever its value,
+ *                 leading zeros included, so pass the exponent at its
+ *                 public size rather than trimmed.
+ */
+int big_ct_exp_mod(big_uint *rp, const big_uint *ap, const big_uint *ep, size_t en, const big_mont_ctx *ctx,
+                   big_uint *tp);
+
+/**
+ * \brief          Probabilistic primality test: trial division by
+ *                 small_primes, then Miller-Rabin over bases, and
+ *                 optionally a strong Lucas test (together Baillie-PSW)
+ *
+ * \param X        bigint to test
+ * \param lucas    Nonzero to run the strong Lucas test as well
+ *
+ * \return         0 if X is probably prime,
+ *                 ERR_BIGINT_NOT_ACCEPTABLE if X is composite or below 2,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_is_probable_prime(const bigint *X, int lucas);
+
+/**
+ * \brief          Batch trial division: res[i] = |X| mod primes[i]
+ *
+ * \param res      Array of count residues
+ * \param X        bigint to divide
+ * \param primes   Array of count divisors, at least 2 each, such as
+ *                 small_primes
+ * \param count    Number of divisors
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if a pointer is NULL or a
+ *                 divisor is below 2,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           The divisors need not be prime. They are multiplied
+ *                 into limb sized groups and X is taken down a remainder
+ *                 tree over those, so X itself is only divided once.
+ */
+int big_mod_primes(big_uint *res, const bigint *X, const int *primes, size_t count);
+
+/**
+ * \brief          Generate a random prime of exactly bits bits. Candidates
+ *                 are sieved in windows above a random starting point, and
+ *                 the survivors pass big_is_probable_prime with the
+ *                 strong Lucas test
+ *
+ * \param X        Destination bigint
+ * \param bits     Size of the prime in bits, at least 2
+ * \param f_rng    RNG function, fills its buffer with len random bytes
+ *                 and returns 0 on success
+ * \param p_rng    RNG parameter
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if bits < 2 or f_rng is NULL,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed,
+ *                 or the error code f_rng returned
+ */
+int big_gen_prime(bigint *X, size_t bits, int (*f_rng)(void *, unsigned char *, size_t), void *p_rng);
+
+/**
+ * \brief          RSA key for private operations by the Chinese remainder
+ *                 theorem, with everything precomputed that does not
+ *                 depend on the input
+ */
+typedef struct {
+    bigint N;             /*!<  public modulus P * Q                    */
+    bigint E;             /*!<  public exponent                         */
+    bigint P;             /*!<  larger prime factor                     */
+    bigint Q;             /*!<  smaller prime factor                    */
+    bigint DP;            /*!<  E^-1 mod (P - 1)                        */
+    bigint DQ;            /*!<  E^-1 mod (Q - 1)                        */
+    bigint QP;            /*!<  Q^-1 mod P                              */
+    big_uint *QPR;        /*!<  QP * R mod P, in Montgomery form for P  */
+    big_mont_ctx mont_n;  /*!<  Montgomery context for N                */
+    big_mont_ctx mont_p;  /*!<  Montgomery context for P                */
+    big_mont_ctx mont_q;  /*!<  Montgomery context for Q                */
+} big_rsa_ctx;
+
+/**
+ * \brief          Set up an RSA context from the two primes and the public
+ *                 exponent, for instance primes from big_gen_prime and
+ *                 E = 65537
+ *
+ * \param ctx      Context to initialize
+ * \param P        One prime factor, odd and distinct from Q
+ * \param Q        The other prime factor, in either order
+ * \param E        Public exponent, positive
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an argument is NULL, P or Q
+ *                 is even or below 3, P equals Q or E is not positive,
+ *                 ERR_BIGINT_NOT_ACCEPTABLE if E is not invertible modulo
+ *                 P - 1 or Q - 1,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           P and Q are not tested for primality. The context must
+ *                 be freed with big_rsa_free once it was set up.
+ */
+int big_rsa_init(big_rsa_ctx *ctx, const bigint *P, const bigint *Q, const bigint *E);
+
+/**
+ * \brief          Free the contents of an RSA context
+ *
+ * \param ctx      Context to free
+ */
+void big_rsa_free(big_rsa_ctx *ctx);
+
+/**
+ * \brief          Public RSA operation: X = A^E mod N
+ *
+ * \param X        Destination bigint, may alias A
+ * \param A        Input, 0 <= A < N
+ * \param ctx      Context from big_rsa_init
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if A is out of range,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ */
+int big_rsa_public(bigint *X, const bigint *A, const big_rsa_ctx *ctx);
+
+/**
+ * \brief          Private RSA operation: X = A^D mod N, where
+ *                 D = E^-1 mod lcm(P - 1, Q - 1)
+ *
+ * \param X        Destination bigint, may alias A
+ * \param A        Input, 0 <= A < N
+ * \param ctx      Context from big_rsa_init
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if A is out of range,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed
+ *
+ * \note           Two exponentiations modulo P and Q with exponents DP and
+ *                 DQ, recombined with Garner's formula. Like the big_ct_*
+ *                 functions, every step after reading A branches and
+ *                 accesses memory depending on the sizes of P and Q only,
+ *                 not on P, Q, DP or DQ themselves.
+ */
+int big_rsa_private(bigint *X, const bigint *A, const big_rsa_ctx *ctx);
+
+/**
+ * \brief          Private RSA operation on count inputs:
+ *                 X[i] = A[i]^D mod N
+ *
+ * \param X        Array of count destination bigints, X[i] may alias A[i]
+ * \param A        Array of count inputs, each 0 <= A[i] < N
+ * \param count    Number of inputs
+ * \param ctx      Context from big_rsa_init
+ *
+ * \return         0 if successful,
+ *                 ERR_BIGINT_BAD_INPUT_DATA if an input is out of range,
+ *                 ERR_BIGINT_ALLOC_FAILED if memory allocation failed.
+ *                 The outputs before the failing input are set.
+ *
+ * \note           All inputs share one set of scratch buffers, so signing
+ *                 many messages this way allocates once instead of once
+ *                 per message.
  */
+int big_rsa_private_batch(bigint *X, const bigint *A, size_t count, const big_rsa_ctx *ctx);
 
 #endif /* BIGINT_H */
\ No newline at end of file
@@ -0,0 +1,827 @@
+/*
+Benchmark harness and threshold tuner for bigint.c, replacing the old
+experiment1 and experiment2 in main.
+
+Build: gcc -O2 -pthread -DBIGINT_NO_MAIN bigint.c bigint_bench.c -o bigint_bench -lm
+
+./bigint_bench sweep [min_limbs] [max_limbs] [reps]
+    Times every multiplication method, big_mul_parallel on one thread per
+    CPU, squaring, short products, multiply-accumulate, division, Barrett reduction, GCDs, trial division, batch GCD, decimal conversion, Montgomery multiplication, modular exponentiation and RSA private operations over a range of operand sizes, reps times each, and prints
+    the median, minimum, mean and relative standard deviation per call.
+./bigint_bench pi [digits] [reps]
+    Computes digits hexadecimal digits of pi, a million by default, and
+    writes them out in hexadecimal and decimal, timing each phase. This
+    exercises multiplication, division, square roots and radix conversion
+    together.
+./bigint_bench tune [header]
+    Finds the crossover size of every algorithm cutoff on this host and writes
+    them to header, bigint_thresholds.h by default. bigint.c picks that file
+    up at build time, so rebuild after tuning.
+*/
+#include "bigint.h"
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include <unistd.h>
+
+// Helpers from bigint.c and its tests
+void gen_rand_hex(char *output, size_t length);
+bool big_is_zero(const bigint *num);
+int big_bit_shift_left(bigint *result, const bigint *src, size_t bit_shift);
+
+// Internal routines of bigint.c the tuner times directly
+size_t mont_scratch_size(size_t n);
+size_t limb_mul_n_scratch_size(size_t n);
+void limb_mul_n(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp);
+void limb_sqr_n(big_uint *rp, const big_uint *ap, size_t n, big_uint *tp);
+size_t short_mul_scratch_size(size_t n);
+void limb_mullo_n(big_uint *rp, const big_uint *ap, const big_uint *bp, size_t n, big_uint *tp);
+void limb_mont_mul(big_uint *rp, const big_uint *ap, const big_uint *bp, const big_mont_ctx *ctx,
+                   big_uint *tp);
+
+// How the operands of an operation are shaped for a size of n limbs
+enum {
+    OPERANDS_MUL,         // A and B of n limbs
+    OPERANDS_BALANCED,    // A and B of n limbs, with room for limb_mul_n and limb_mullo_n
+    OPERANDS_UNBALANCED,  // A of n limbs, B of n / 4 + 1
+    OPERANDS_DIV,         // A of 2n limbs, B of n
+    OPERANDS_BARRETT,     // A of 2n limbs, a Barrett context for B of n
+    OPERANDS_GCD,         // A and B of about n limbs with a common factor of n / 4 + 1
+    OPERANDS_MONT,        // odd N of n limbs, A and B below it, A and B in raw limbs
+    OPERANDS_EXP,         // odd N of n limbs, A below it and an exponent E of n limbs
+    OPERANDS_RSA,         // RSA key with N of n limbs, A below N and the private exponent in B
+    OPERANDS_BATCH,       // n / 16 + 1 moduli of 16 limbs in batch, some sharing a factor
+    OPERANDS_TEXT         // A of n limbs and its decimal digits in text
+};
+
+typedef struct {
+    bigint A, B, X, R;
+    big_mont_ctx ctx;
+    big_barrett_ctx barrett;
+    big_rsa_ctx rsa;
+    bigint *batch;
+    size_t batch_count;
+    big_uint *rp;
+    big_uint *scratch;
+    char *text;
+    size_t text_size;
+    size_t n;
+} bench_operands;
+
+typedef void (*bench_fn)(bench_operands *op);
+
+typedef struct {
+    double min, median, mean, rsd;
+} bench_summary;
+
+/*
+Sets X to a random value of exactly limbs limbs whose top hex digit is top,
+or random but nonzero if top is 0.
+*/
+void bench_random(bigint *X, size_t limbs, char top) {
+    size_t len = 16 * limbs;
+    char *hex = malloc(len + 1);
+    gen_rand_hex(hex, len);
+    hex[0] = top ? top : "123456789abcdef"[rand() % 15];
+    big_read_string(X, hex);
+    free(hex);
+}
+
+// Random bytes from rand() for big_gen_prime, good enough for timing keys
+int bench_rand_bytes(void *p_rng, unsigned char *output, size_t len) {
+    (void)p_rng;
+    for (size_t i = 0; i < len; i++) {
+        output[i] = (unsigned char)rand();
+    }
+    return 0;
+}
+
+void operands_init(bench_operands *op, int kind, size_t n) {
+    big_init(&op->A);
+    big_init(&op->B);
+    big_init(&op->X);
+    big_init(&op->R);
+    op->ctx = (big_mont_ctx){0};
+    op->barrett = (big_barrett_ctx){0};
+    op->rsa = (big_rsa_ctx){0};
+    op->batch = NULL;
+    op->batch_count = 0;
+    op->rp = NULL;
+    op->scratch = NULL;
+    op->text = NULL;
+    op->n = n;
+    switch (kind) {
+    case OPERANDS_MUL:
+        bench_random(&op->A, n, 0);
+        bench_random(&op->B, n, 0);
+        break;
+    case OPERANDS_BALANCED: {
+        bench_random(&op->A, n, 0);
+        bench_random(&op->B, n, 0);
+        // Room for any of the balanced methods, whichever the tuner picks
+        size_t saved3 = toom3_threshold;
+        size_t saved4 = toom4_threshold;
+        toom3_threshold = 0;
+        toom4_threshold = 0;
+        op->scratch = malloc(short_mul_scratch_size(n) * sizeof(big_uint));
+        toom3_threshold = saved3;
+        toom4_threshold = saved4;
+        op->rp = malloc(2 * n * sizeof(big_uint));
+        break;
+    }
+    case OPERANDS_UNBALANCED:
+        bench_random(&op->A, n, 0);
+        bench_random(&op->B, n / 4 + 1, 0);
+        break;
+    case OPERANDS_DIV:
+        bench_random(&op->A, 2 * n, 0);
+        bench_random(&op->B, n, 0);
+        break;
+    case OPERANDS_BARRETT:
+        bench_random(&op->A, 2 * n, 0);
+        bench_random(&op->B, n, 0);
+        big_barrett_init(&op->barrett, &op->B);
+        break;
+    case OPERANDS_GCD:
+        bench_random(&op->R, n / 4 + 1, 0);
+        bench_random(&op->A, n - n / 4, 0);
+        bench_random(&op->B, n - n / 4, 0);
+        big_mul(&op->A, &op->A, &op->R);
+        big_mul(&op->B, &op->B, &op->R);
+        break;
+    case OPERANDS_MONT:
+    case OPERANDS_EXP:
+        // N has its top bit set and is odd, A and B stay below it
+        bench_random(&op->R, n, 'f');
+        op->R.data[0] |= 1;
+        big_mont_init(&op->ctx, &op->R);
+        bench_random(&op->A, n, '7');
+        bench_random(&op->B, n, (kind == OPERANDS_MONT) ? '7' : 0);
+        if (kind == OPERANDS_EXP) {
+            op->scratch = malloc(big_ct_exp_mod_scratch_size(n) * sizeof(big_uint));
+            op->rp = malloc(n * sizeof(big_uint));
+        }
+        if (kind == OPERANDS_MONT) {
+            // Room for either Montgomery method, whichever the tuner picks
+            size_t saved = mont_cios_threshold;
+            mont_cios_threshold = 0;
+            op->scratch = malloc(mont_scratch_size(n) * sizeof(big_uint));
+            mont_cios_threshold = saved;
+            op->rp = malloc(n * sizeof(big_uint));
+        }
+        break;
+    case OPERANDS_RSA: {
+        // Two primes of half the size each, redrawn until 65537 is a valid exponent
+        bigint one;
+        big_init(&one);
+        big_set_nonzero(&one, 1);
+        big_set_nonzero(&op->R, 65537);
+        do {
+            big_gen_prime(&op->A, 32 * n, bench_rand_bytes, NULL);
+            big_gen_prime(&op->B, 32 * n, bench_rand_bytes, NULL);
+        } while (big_rsa_init(&op->rsa, &op->A, &op->B, &op->R) != 0);
+        big_mont_init(&op->ctx, &op->rsa.N);
+        // B = D = E^-1 mod (P - 1)(Q - 1) for the exponentiation without the CRT
+        big_sub(&op->A, &op->rsa.P, &one);
+        big_sub(&op->B, &op->rsa.Q, &one);
+        big_mul(&op->X, &op->A, &op->B);
+        big_invmod(&op->B, &op->R, &op->X);
+        bench_random(&op->A, n, '7');
+        big_div(NULL, &op->A, &op->A, &op->rsa.N);
+        big_free(&one);
+        break;
+    }
+    case OPERANDS_BATCH:
+        // Every tenth modulus reuses the factor of the one before
+        op->batch_count = n / 16 + 1;
+        op->batch = malloc(2 * op->batch_count * sizeof(bigint));
+        for (size_t i = 0; i < 2 * op->batch_count; i++) {
+            big_init(&op->batch[i]);
+        }
+        for (size_t i = 0; i < op->batch_count; i++) {
+            if (i % 10 != 1) {
+                bench_random(&op->A, 8, 0);
+            }
+            bench_random(&op->B, 8, 0);
+            big_mul(&op->batch[i], &op->A, &op->B);
+        }
+        break;
+    case OPERANDS_TEXT:
+        // A limb takes at most 20 decimal digits
+        bench_random(&op->A, n, 0);
+        op->text_size = 20 * n + 2;
+        op->text = malloc(op->text_size);
+        big_write_string_radix(&op->A, 10, op->text, op->text_size, &op->text_size);
+        break;
+    }
+}
+
+void operands_free(bench_operands *op) {
+    big_free(&op->A);
+    big_free(&op->B);
+    big_free(&op->X);
+    big_free(&op->R);
+    big_mont_free(&op->ctx);
+    big_barrett_free(&op->barrett);
+    big_rsa_free(&op->rsa);
+    for (size_t i = 0; i < 2 * op->batch_count; i++) {
+        big_free(&op->batch[i]);
+    }
+    free(op->batch);
+    free(op->rp);
+    free(op->scratch);
+    free(op->text);
+}
+
+void op_mul(bench_operands *op) {
+    big_mul(&op->X, &op->A, &op->B);
+}
+
+void op_karatsuba(bench_operands *op) {
+    big_karatsuba(&op->X, &op->A, &op->B);
+}
+
+void op_toom_cook(bench_operands *op) {
+    big_toom_cook(&op->X, &op->A, &op->B);
+}
+
+void op_toom4(bench_operands *op) {
+    big_toom4(&op->X, &op->A, &op->B);
+}
+
+void op_toom6h(bench_operands *op) {
+    big_toom6h(&op->X, &op->A, &op->B);
+}
+
+void op_fft(bench_operands *op) {
+    big_mul_fft(&op->X, &op->A, &op->B);
+}
+
+void op_auto(bench_operands *op) {
+    big_mul_auto(&op->X, &op->A, &op->B);
+}
+
+// Pool for big_mul_parallel, one thread per online CPU
+big_thread_pool *bench_pool;
+
+void op_parallel(bench_operands *op) {
+    big_mul_parallel(&op->X, &op->A, &op->B, bench_pool);
+}
+
+void op_sqr(bench_operands *op) {
+    big_sqr(&op->X, &op->A);
+}
+
+// The balanced methods alone, which the FFT never takes over from
+void op_mul_n(bench_operands *op) {
+    limb_mul_n(op->rp, op->A.data, op->B.data, op->n, op->scratch);
+}
+
+void op_sqr_n(bench_operands *op) {
+    limb_sqr_n(op->rp, op->A.data, op->n, op->scratch);
+}
+
+// X keeps accumulating, which only grows it by a bit every other call or so
+void op_addmul(bench_operands *op) {
+    big_addmul(&op->X, &op->A, &op->B);
+}
+
+void op_mullo(bench_operands *op) {
+    limb_mullo_n(op->rp, op->A.data, op->B.data, op->n, op->scratch);
+}
+
+// Schoolbook at every size, the one product with no value dependent branches
+void op_ct_mul(bench_operands *op) {
+    big_ct_mul(op->rp, op->A.data, op->B.data, op->n);
+}
+
+void op_div(bench_operands *op) {
+    big_div(&op->X, &op->R, &op->A, &op->B);
+}
+
+// A has 2n limbs, so the square root has n like the quotient of div_2n_n
+void op_sqrt(bench_operands *op) {
+    big_sqrtrem(&op->X, &op->R, &op->A);
+}
+
+void op_root3(bench_operands *op) {
+    big_root(&op->X, &op->A, 3);
+}
+
+void op_barrett(bench_operands *op) {
+    big_barrett_reduce(&op->X, &op->A, &op->barrett);
+}
+
+void op_gcd(bench_operands *op) {
+    big_gcd(&op->X, &op->A, &op->B);
+}
+
+void op_gcdext(bench_operands *op) {
+    big_gcdext(&op->X, &op->R, NULL, &op->A, &op->B);
+}
+
+// The odd primes below 2048, the table big_gen_prime sieves with
+int bench_primes[320];
+size_t bench_prime_count;
+
+void op_mod_primes(bench_operands *op) {
+    big_uint res[320];
+    if (bench_prime_count == 0) {
+        for (int p = 3; p < 2048; p += 2) {
+            bool prime = true;
+            for (int d = 3; d * d <= p && prime; d += 2) {
+                prime = (p % d != 0);
+            }
+            if (prime) {
+                bench_primes[bench_prime_count++] = p;
+            }
+        }
+    }
+    big_mod_primes(res, &op->A, bench_primes, bench_prime_count);
+}
+
+// The second half of batch takes the results
+void op_batch_gcd(bench_operands *op) {
+    big_batch_gcd(op->batch + op->batch_count, op->batch, op->batch_count);
+}
+
+void op_to_decimal(bench_operands *op) {
+    size_t olen;
+    big_write_string_radix(&op->A, 10, op->text, op->text_size, &olen);
+}
+
+void op_from_decimal(bench_operands *op) {
+    big_read_string_radix(&op->X, op->text, 10);
+}
+
+void op_mont_mul(bench_operands *op) {
+    limb_mont_mul(op->rp, op->A.data, op->B.data, &op->ctx, op->scratch);
+}
+
+void op_exp_mod(bench_operands *op) {
+    big_exp_mod_ctx(&op->X, &op->A, &op->B, &op->ctx);
+}
+
+void op_rsa_private(bench_operands *op) {
+    big_rsa_private(&op->X, &op->A, &op->rsa);
+}
+
+void op_ct_exp_mod(bench_operands *op) {
+    big_ct_exp_mod(op->rp, op->A.data, op->B.data, op->n, &op->ctx, op->scratch);
+}
+
+double now_seconds(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+double time_calls(bench_fn fn, bench_operands *op, size_t iters) {
+    double start = now_seconds();
+    for (size_t i = 0; i < iters; i++) {
+        fn(op);
+    }
+    return (now_seconds() - start) / iters;
+}
+
+/*
+Number of calls that take at least min_seconds together, so that each timed
+batch is far above the clock resolution. The first call also warms the caches
+and the allocator.
+*/
+size_t calibrate(bench_fn fn, bench_operands *op, double min_seconds) {
+    size_t iters = 1;
+    fn(op);
+    for (;;) {
+        double total = time_calls(fn, op, iters) * iters;
+        if (total >= min_seconds) {
+            return iters;
+        }
+        iters = (total * 8 < min_seconds) ? iters * 8 : iters * 2;
+    }
+}
+
+int compare_doubles(const void *a, const void *b) {
+    double x = *(const double *)a;
+    double y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// Sorts the samples in place
+bench_summary summarize(double *samples, int count) {
+    bench_summary s;
+    qsort(samples, count, sizeof(double), compare_doubles);
+    s.min = samples[0];
+    s.median = (count % 2) ? samples[count / 2] : (samples[count / 2 - 1] + samples[count / 2]) / 2;
+    double sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += samples[i];
+    }
+    s.mean = sum / count;
+    double var = 0;
+    for (int i = 0; i < count; i++) {
+        var += (samples[i] - s.mean) * (samples[i] - s.mean);
+    }
+    s.rsd = (count > 1) ? sqrt(var / (count - 1)) / s.mean : 0;
+    return s;
+}
+
+// SWEEP STARTS HERE
+
+typedef struct {
+    const char *name;
+    bench_fn fn;
+    int kind;
+    size_t max_limbs;  // larger sizes take too long to be worth timing
+} sweep_op;
+
+static const sweep_op sweep_ops[] = {
+    {"mul", op_mul, OPERANDS_MUL, 4096},
+    {"karatsuba", op_karatsuba, OPERANDS_MUL, (size_t)-1},
+    {"toom_cook", op_toom_cook, OPERANDS_MUL, (size_t)-1},
+    {"toom4", op_toom4, OPERANDS_MUL, (size_t)-1},
+    {"toom6h", op_toom6h, OPERANDS_MUL, (size_t)-1},
+    {"fft", op_fft, OPERANDS_MUL, (size_t)-1},
+    {"auto", op_auto, OPERANDS_MUL, (size_t)-1},
+    {"auto_4to1", op_auto, OPERANDS_UNBALANCED, (size_t)-1},
+    {"parallel", op_parallel, OPERANDS_MUL, (size_t)-1},
+    {"sqr", op_sqr, OPERANDS_MUL, (size_t)-1},
+    {"mullo", op_mullo, OPERANDS_BALANCED, (size_t)-1},
+    {"addmul", op_addmul, OPERANDS_BALANCED, (size_t)-1},
+    {"ct_mul", op_ct_mul, OPERANDS_BALANCED, 4096},
+    {"mont_mul", op_mont_mul, OPERANDS_MONT, 4096},
+    {"div_2n_n", op_div, OPERANDS_DIV, (size_t)-1},
+    {"barrett", op_barrett, OPERANDS_BARRETT, (size_t)-1},
+    {"sqrt_2n", op_sqrt, OPERANDS_DIV, (size_t)-1},
+    {"root3_2n", op_root3, OPERANDS_DIV, (size_t)-1},
+    {"gcd", op_gcd, OPERANDS_GCD, (size_t)-1},
+    {"gcdext", op_gcdext, OPERANDS_GCD, (size_t)-1},
+    {"mod_primes", op_mod_primes, OPERANDS_BALANCED, (size_t)-1},
+    {"batch_gcd", op_batch_gcd, OPERANDS_BATCH, (size_t)-1},
+    {"to_dec", op_to_decimal, OPERANDS_TEXT, (size_t)-1},
+    {"from_dec", op_from_decimal, OPERANDS_TEXT, (size_t)-1},
+    {"exp_mod", op_exp_mod, OPERANDS_EXP, 64},
+    {"ct_exp_mod", op_ct_exp_mod, OPERANDS_EXP, 64},
+    {"rsa_no_crt", op_exp_mod, OPERANDS_RSA, 64},
+    {"rsa_crt", op_rsa_private, OPERANDS_RSA, 64},
+};
+
+// Next size to time after n: about sqrt(2) times larger, or the power of 2 in between
+size_t sweep_next(size_t n) {
+    size_t next = (n * 17 + 11) / 12;
+    size_t pow2 = 1;
+    while (pow2 <= n) {
+        pow2 *= 2;
+    }
+    return (pow2 < next) ? pow2 : next;
+}
+
+/*
+Times each operation at sizes growing by about a factor of sqrt(2), plus the
+powers of 2 the fixed-width kernels are specialized for. Every sample is a
+batch of at least 10ms, and the products are checked against big_mul_auto
+once per size, like the experiments used to, as are the values parsed back
+from decimal, the Barrett remainders against big_div, the GCDs by dividing
+both operands and the RSA results against exponentiation by D.
+*/
+int sweep(size_t min_limbs, size_t max_limbs, int reps) {
+    double *samples = malloc(reps * sizeof(double));
+    bigint check;
+    big_init(&check);
+    printf("%-10s %8s %14s %14s %14s %8s\n", "op", "limbs", "median_us", "min_us", "mean_us", "rsd_%");
+    for (size_t k = 0; k < sizeof(sweep_ops) / sizeof(sweep_ops[0]); k++) {
+        const sweep_op *s = &sweep_ops[k];
+        for (size_t n = min_limbs; n <= max_limbs && n <= s->max_limbs; n = sweep_next(n)) {
+            bench_operands op;
+            operands_init(&op, s->kind, n);
+            if (s->fn == op_from_decimal) {
+                s->fn(&op);
+                if (big_cmp(&op.A, &op.X) != 0) {
+                    fprintf(stderr, "%s gave a wrong result at %zu limbs\n", s->name, n);
+                    return 1;
+                }
+            }
+            if (s->fn == op_barrett) {
+                s->fn(&op);
+                big_div(NULL, &check, &op.A, &op.B);
+                if (big_cmp(&check, &op.X) != 0) {
+                    fprintf(stderr, "%s gave a wrong result at %zu limbs\n", s->name, n);
+                    return 1;
+                }
+            }
+            if (s->fn == op_sqrt) {
+                s->fn(&op);
+                // A = X^2 + R with 0 <= R <= 2X
+                big_sqr(&check, &op.X);
+                big_add(&check, &check, &op.R);
+                bool exact = (big_cmp(&check, &op.A) == 0);
+                big_bit_shift_left(&check, &op.X, 1);
+                if (!exact || op.R.signum < 0 || big_cmp(&op.R, &check) > 0) {
+                    fprintf(stderr, "%s gave a wrong result at %zu limbs\n", s->name, n);
+                    return 1;
+                }
+            }
+            if (s->kind == OPERANDS_GCD) {
+                s->fn(&op);
+                big_div(NULL, &check, &op.A, &op.X);
+                bool divides = big_is_zero(&check);
+                big_div(NULL, &check, &op.B, &op.X);
+                if (!divides || !big_is_zero(&check)) {
+                    fprintf(stderr, "%s gave a wrong result at %zu limbs\n", s->name, n);
+                    return 1;
+                }
+            }
+            if (s->kind == OPERANDS_RSA) {
+                s->fn(&op);
+                big_exp_mod_ctx(&check, &op.A, &op.B, &op.ctx);
+                if (big_cmp(&check, &op.X) != 0) {
+                    fprintf(stderr, "%s gave a wrong result at %zu limbs\n", s->name, n);
+                    return 1;
+                }
+            }
+            if (s->kind == OPERANDS_MUL || s->kind == OPERANDS_UNBALANCED) {
+                s->fn(&op);
+                big_mul_auto(&check, &op.A, (s->fn == op_sqr) ? &op.A : &op.B);
+                if (big_cmp(&check, &op.X) != 0) {
+                    fprintf(stderr, "%s gave a wrong result at %zu limbs\n", s->name, n);
+                    return 1;
+                }
+            }
+            size_t iters = calibrate(s->fn, &op, 0.01);
+            for (int r = 0; r < reps; r++) {
+                samples[r] = time_calls(s->fn, &op, iters);
+            }
+            bench_summary sum = summarize(samples, reps);
+            printf("%-10s %8zu %14.3f %14.3f %14.3f %8.2f\n", s->name, n, sum.median * 1e6, sum.min * 1e6,
+                   sum.mean * 1e6, sum.rsd * 100);
+            fflush(stdout);
+            operands_free(&op);
+        }
+    }
+    big_free(&check);
+    free(samples);
+    return 0;
+}
+
+// PI STARTS HERE
+
+/*
+End to end workload: digits hexadecimal digits of pi by big_pi_hex, which is
+nearly all large balanced products from the binary splitting plus one square
+root and one division, then the result written out in hexadecimal and, as a
+decimal program would, in decimal. Each phase is timed reps times and the
+digits are checked against the start of pi.
+*/
+int pi_bench(size_t digits, int reps) {
+    static const char *pi_start = "3243f6a8885a308d313198a2e03707344a4093822299f31d0082efa98ec4e6c8";
+    const char *phases[] = {"pi_hex", "to_hex", "to_dec", "total"};
+    double *samples = malloc(4 * reps * sizeof(double));
+    bigint X;
+    big_init(&X);
+    // 16^digits has fewer than 1.25 * digits decimal digits
+    size_t text_size = digits + digits / 4 + 16;
+    char *text = malloc(text_size);
+    for (int r = 0; r < reps; r++) {
+        double t0 = now_seconds();
+        if (big_pi_hex(&X, digits) != 0) {
+            fprintf(stderr, "big_pi_hex failed\n");
+            return 1;
+        }
+        double t1 = now_seconds();
+        size_t olen;
+        big_write_string_radix(&X, 16, text, text_size, &olen);
+        double t2 = now_seconds();
+        size_t check = (digits + 1 < 64) ? digits + 1 : 64;
+        if (olen != digits + 2 || strncmp(text, pi_start, check) != 0) {
+            fprintf(stderr, "big_pi_hex gave wrong digits\n");
+            return 1;
+        }
+        big_write_string_radix(&X, 10, text, text_size, &olen);
+        double t3 = now_seconds();
+        samples[0 * reps + r] = t1 - t0;
+        samples[1 * reps + r] = t2 - t1;
+        samples[2 * reps + r] = t3 - t2;
+        samples[3 * reps + r] = t3 - t0;
+    }
+    printf("%zu hexadecimal digits of pi, %zu limbs\n", digits, X.num_limbs);
+    printf("%-10s %14s %14s %14s %8s\n", "phase", "median_ms", "min_ms", "mean_ms", "rsd_%");
+    for (int k = 0; k < 4; k++) {
+        bench_summary sum = summarize(samples + k * reps, reps);
+        printf("%-10s %14.3f %14.3f %14.3f %8.2f\n", phases[k], sum.median * 1e3, sum.min * 1e3, sum.mean * 1e3,
+               sum.rsd * 100);
+    }
+    big_free(&X);
+    free(text);
+    free(samples);
+    return 0;
+}
+
+// TUNING STARTS HERE
+
+/*
+One cutoff between a smaller and a larger method. If strict is set the larger
+method runs once the size reaches the cutoff (n >= var), otherwise once it
+exceeds it (n > var). The search starts above the cutoff lo_after points to,
+if any, so the dependent cutoffs stay ordered.
+
+A crossover at a single level says nothing about cutoffs whose larger method
+only gains from its own recursion, like the recursive division. For those,
+probe gives an operand size at which every candidate cutoff is timed, and the
+fastest one wins.
+*/
+typedef struct {
+    const char *macro;
+    size_t *var;
+    bench_fn fn;
+    int kind;
+    size_t lo, hi;
+    bool strict;
+    const size_t *lo_after;
+    size_t probe;
+} tunable;
+
+static const tunable tunables[] = {
+    {"KARATSUBA_THRESHOLD", &karatsuba_threshold, op_auto, OPERANDS_MUL, 33, 500, false, NULL, 0},
+    {"TOOM3_THRESHOLD", &toom3_threshold, op_auto, OPERANDS_MUL, 33, 2000, false, &karatsuba_threshold, 0},
+    {"SQR_BASECASE_THRESHOLD", &sqr_basecase_threshold, op_sqr, OPERANDS_MUL, 2, 32, true, NULL, 0},
+    {"SQR_KARATSUBA_THRESHOLD", &sqr_karatsuba_threshold, op_sqr, OPERANDS_MUL, 33, 500, false, NULL, 0},
+    {"SQR_TOOM3_THRESHOLD", &sqr_toom3_threshold, op_sqr, OPERANDS_MUL, 33, 2000, false,
+     &sqr_karatsuba_threshold, 0},
+    {"TOOM4_THRESHOLD", &toom4_threshold, op_mul_n, OPERANDS_BALANCED, 100, 4000, false, &toom3_threshold, 0},
+    {"TOOM6H_THRESHOLD", &toom6h_threshold, op_mul_n, OPERANDS_BALANCED, 100, 20000, false, &toom4_threshold,
+     0},
+    {"SQR_TOOM4_THRESHOLD", &sqr_toom4_threshold, op_sqr_n, OPERANDS_BALANCED, 100, 4000, false,
+     &sqr_toom3_threshold, 0},
+    {"SQR_TOOM6H_THRESHOLD", &sqr_toom6h_threshold, op_sqr_n, OPERANDS_BALANCED, 100, 20000, false,
+     &sqr_toom4_threshold, 0},
+    {"FFT_MUL_THRESHOLD", &fft_mul_threshold, op_auto, OPERANDS_MUL, 256, 1000000, true, &toom6h_threshold,
+     0},
+    {"BZ_DIV_THRESHOLD", &bz_div_threshold, op_div, OPERANDS_DIV, 8, 1000, true, NULL, 2000},
+    {"MULLO_THRESHOLD", &mullo_threshold, op_mullo, OPERANDS_BALANCED, 8, 1000, true, NULL, 0},
+    {"HGCD_THRESHOLD", &hgcd_threshold, op_gcd, OPERANDS_GCD, 32, 2000, true, NULL, 4000},
+    {"TRIAL_TREE_THRESHOLD", &trial_tree_threshold, op_mod_primes, OPERANDS_BALANCED, 8, 2000, true, NULL, 0},
+    {"MONT_CIOS_THRESHOLD", &mont_cios_threshold, op_mont_mul, OPERANDS_MONT, 2, 256, false, NULL, 0},
+    {"RADIX_READ_THRESHOLD", &radix_read_threshold, op_from_decimal, OPERANDS_TEXT, 4, 1000, false, NULL, 4000},
+    {"RADIX_WRITE_THRESHOLD", &radix_write_threshold, op_to_decimal, OPERANDS_TEXT, 2, 500, false, NULL, 4000},
+};
+
+/*
+Times the operation at n limbs with the cutoff just below and just above n,
+alternating between the two so that drift in the machine's speed hits both
+alike. The tuner compares the fastest sample of each side, which other load
+on the machine disturbs the least.
+*/
+void time_both_sides(const tunable *t, bench_operands *op, size_t large, int reps, double *small_time,
+                     double *large_time) {
+    double *samples = malloc(2 * reps * sizeof(double));
+    *t->var = large + 1;
+    size_t iters = calibrate(t->fn, op, 0.002);
+    for (int r = 0; r < reps; r++) {
+        *t->var = large + 1;
+        samples[r] = time_calls(t->fn, op, iters);
+        *t->var = large;
+        samples[reps + r] = time_calls(t->fn, op, iters);
+    }
+    *small_time = summarize(samples, reps).min;
+    *large_time = summarize(samples + reps, reps).min;
+    free(samples);
+}
+
+/*
+Times the operation at t->probe limbs for cutoffs from lo to t->hi in steps
+of about 1/16, and keeps the fastest.
+*/
+size_t tune_at_probe(const tunable *t, size_t lo, int reps) {
+    bench_operands op;
+    operands_init(&op, t->kind, t->probe);
+    double *samples = malloc(reps * sizeof(double));
+    *t->var = lo;
+    size_t iters = calibrate(t->fn, &op, 0.002);
+    size_t found = lo;
+    double best = 0;
+    for (size_t v = lo; v <= t->hi; v += (v / 16 > 0) ? v / 16 : 1) {
+        *t->var = v;
+        for (int r = 0; r < reps; r++) {
+            samples[r] = time_calls(t->fn, &op, iters);
+        }
+        double fastest = summarize(samples, reps).min;
+        fprintf(stderr, "  %-24s %6zu: %12.3f us at %zu limbs\n", t->macro, v, fastest * 1e6, t->probe);
+        if (v == lo || fastest < best) {
+            best = fastest;
+            found = v;
+        }
+    }
+    free(samples);
+    operands_free(&op);
+    *t->var = found;
+    return found;
+}
+
+/*
+Walks up the sizes of t in steps of about 1/16 until the larger method wins
+at three sizes in a row, and sets the cutoff to the first of them. If it never
+does, the cutoff goes to the top of the range. Like GMP's tuneup, each size is
+measured with every other cutoff at its current value, so the order of
+tunables matters.
+*/
+size_t tune_one(const tunable *t, int reps) {
+    size_t lo = t->lo;
+    if (t->lo_after != NULL && *t->lo_after + 1 > lo) {
+        lo = *t->lo_after + 1;
+    }
+    if (t->probe != 0) {
+        return tune_at_probe(t, lo, reps);
+    }
+    size_t found = t->hi;
+    int wins = 0;
+    for (size_t n = lo; n <= t->hi; n += (n / 16 > 0) ? n / 16 : 1) {
+        bench_operands op;
+        operands_init(&op, t->kind, n);
+        size_t large = t->strict ? n : n - 1;
+        double small_time, large_time;
+        time_both_sides(t, &op, large, reps, &small_time, &large_time);
+        operands_free(&op);
+        fprintf(stderr, "  %-24s %6zu limbs: %12.3f us below, %12.3f us above\n", t->macro, n, small_time * 1e6,
+                large_time * 1e6);
+        if (large_time < small_time) {
+            if (wins++ == 0) {
+                found = large;
+            }
+            if (wins == 3) {
+                break;
+            }
+        }
+        else {
+            wins = 0;
+        }
+    }
+    if (wins < 3) {
+        found = t->hi;
+    }
+    *t->var = found;
+    return found;
+}
+
+int tune(const char *path, int reps) {
+    size_t count = sizeof(tunables) / sizeof(tunables[0]);
+    size_t values[sizeof(tunables) / sizeof(tunables[0])];
+    for (size_t k = 0; k < count; k++) {
+        values[k] = tune_one(&tunables[k], reps);
+        fprintf(stderr, "%s %zu\n", tunables[k].macro, values[k]);
+    }
+    FILE *f = fopen(path, "w");
+    if (f == NULL) {
+        perror(path);
+        return 1;
+    }
+    fprintf(f, "/*\nGenerated by bigint_bench tune. Algorithm cutoffs in limbs measured on the\n"
+               "host that ran it, bigint.c uses them in place of its defaults.\n*/\n");
+    fprintf(f, "#ifndef BIGINT_THRESHOLDS_H\n#define BIGINT_THRESHOLDS_H\n\n");
+    for (size_t k = 0; k < count; k++) {
+        fprintf(f, "#define %s %zu\n", tunables[k].macro, values[k]);
+    }
+    fprintf(f, "\n#endif /* BIGINT_THRESHOLDS_H */\n");
+    fclose(f);
+    printf("Wrote %s\n", path);
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    srand(12345);
+    if (argc >= 2 && strcmp(argv[1], "sweep") == 0) {
+        size_t min_limbs = (argc > 2) ? strtoul(argv[2], NULL, 10) : 8;
+        size_t max_limbs = (argc > 3) ? strtoul(argv[3], NULL, 10) : 8192;
+        int reps = (argc > 4) ? atoi(argv[4]) : 5;
+        if (min_limbs == 0 || max_limbs < min_limbs || reps < 1) {
+            fprintf(stderr, "bad sweep range\n");
+            return 1;
+        }
+        long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        if (big_pool_init(&bench_pool, (cpus > 0) ? (size_t)cpus : 1) != 0) {
+            fprintf(stderr, "cannot start the thread pool\n");
+            return 1;
+        }
+        int ret = sweep(min_limbs, max_limbs, reps);
+        big_pool_free(bench_pool);
+        return ret;
+    }
+    if (argc >= 2 && strcmp(argv[1], "pi") == 0) {
+        size_t digits = (argc > 2) ? strtoul(argv[2], NULL, 10) : 1000000;
+        int reps = (argc > 3) ? atoi(argv[3]) : 3;
+        if (reps < 1) {
+            fprintf(stderr, "bad pi repetitions\n");
+            return 1;
+        }
+        return pi_bench(digits, reps);
+    }
+    if (argc >= 2 && strcmp(argv[1], "tune") == 0) {
+        return tune((argc > 2) ? argv[2] : "bigint_thresholds.h", 7);
+    }
+    fprintf(stderr, "usage: %s sweep [min_limbs] [max_limbs] [reps]\n"
+                    "       %s pi [digits] [reps]\n"
+                    "       %s tune [header]\n", argv[0], argv[0], argv[0]);
+    return 1;
+}